@@ -0,0 +1,100 @@
+#include <iostream>
+#include <iomanip>
+#include "numericalc/Matrix.hpp"
+#include "numericalc/SparseMatrix.hpp"
+#include "numericalc/eigenvector/power_method.hpp"
+#include <cmath>
+
+using namespace std;
+
+/*
+ * Largest relative residual ||A v_j - lambda_j v_j|| / |lambda_j| of the computed eigenpairs.
+ */
+template <typename A>
+static double eigen_residual(const A &a, size_t n, const EigenResult<double> &result)
+{
+    vector<double> v(n), av(n);
+    double worst = 0;
+    for(size_t j = 0; j < result.values.size(); ++j)
+    {
+        for(size_t i = 0; i < n; ++i)
+            v[i] = result.vectors(i, j);
+        a.multiply(v.data(), av.data());
+        double rr = 0;
+        for(size_t i = 0; i < n; ++i)
+            rr += (av[i] - result.values[j] * v[i]) * (av[i] - result.values[j] * v[i]);
+        worst = max(worst, sqrt(rr) / abs(result.values[j]));
+    }
+    return worst;
+}
+
+int eigen_test()
+{
+    int failures = 0;
+
+    /* one dimensional Laplacian of size 100, eigenvalues 2 - 2 cos(j pi / 101) */
+    const size_t n = 100;
+    vector<SparseMatrix<double>::entry> entries;
+    for(size_t i = 0; i < n; ++i)
+    {
+        entries.emplace_back(i, i, 2.0);
+        if(i) entries.emplace_back(i, i - 1, -1.0);
+        if(i + 1 < n) entries.emplace_back(i, i + 1, -1.0);
+    }
+    SparseMatrix<double> laplacian(n, n, entries);
+    auto laplacian_value = [n](size_t j) { return 2 - 2 * cos((double) j * M_PI / (double) (n + 1)); };
+    for(bool largest : {true, false})
+    {
+        EigenResult<double> result = lanczos(laplacian, n, 4, 1e-10, largest);
+        double error = 0;
+        for(size_t j = 0; j < 4; ++j)
+            error = max(error, abs(result.values[j] - laplacian_value(largest ? n - j : j + 1)));
+        const double residual = eigen_residual(laplacian, n, result);
+        cout << "lanczos " << (largest ? "largest" : "smallest") << " restarts " << result.iterations
+             << ", eigenvalue error " << scientific << error << ", residual " << residual << fixed << endl;
+        if(!result.converged || error > 1e-9 || residual > 1e-8)
+            ++failures;
+    }
+
+    /* A = H D H with a Householder reflection H, the spectrum D = 100, 90, 80, 70, 60 followed by
+     * values in [0, 10] */
+    const size_t m = 60;
+    vector<double> spectrum(m), u(m);
+    double uu = 0;
+    for(size_t i = 0; i < m; ++i)
+    {
+        spectrum[i] = i < 5 ? 100 - 10 * (double) i : 10 * (double) (i - 5) / (double) (m - 6);
+        u[i] = 1 + sin(3 * (double) i);
+        uu += u[i] * u[i];
+    }
+    Matrix<double> dense(m, m);
+    for(size_t i = 0; i < m; ++i)
+        for(size_t j = 0; j < m; ++j)
+        {
+            double sum = 0;
+            for(size_t l = 0; l < m; ++l)
+            {
+                const double hil = (i == l) - 2 * u[i] * u[l] / uu, hjl = (j == l) - 2 * u[j] * u[l] / uu;
+                sum += hil * spectrum[l] * hjl;
+            }
+            dense(i, j) = sum;
+        }
+
+    EigenResult<double> block = block_power_method(dense, m, 5, 1e-10);
+    double block_error = 0;
+    for(size_t j = 0; j < 5; ++j)
+        block_error = max(block_error, abs(block.values[j] - spectrum[j]));
+    const double block_residual = eigen_residual(dense, m, block);
+    cout << "block power method iterations " << block.iterations << ", eigenvalue error " << scientific << block_error
+         << ", residual " << block_residual << fixed << endl;
+    if(!block.converged || block_error > 1e-8 || block_residual > 1e-9)
+        ++failures;
+
+    EigenResult<double> dominant = power_method(dense, m, 0.0, 1e-10);
+    cout << "power method iterations " << dominant.iterations << ", eigenvalue error " << scientific
+         << abs(dominant.values[0] - 100) << fixed << endl << endl;
+    if(!dominant.converged || abs(dominant.values[0] - 100) > 1e-8)
+        ++failures;
+
+    return failures;
+}
@@ -0,0 +1,150 @@
+#include <iostream>
+#include <iomanip>
+#include "numericalc/SparseMatrix.hpp"
+#include "numericalc/gradient/conjugate.hpp"
+#include "numericalc/gradient/steepest_descent.hpp"
+#include <cmath>
+
+using namespace std;
+
+/*
+ * Relative residual ||b - A x|| / ||b|| computed from x.
+ */
+static double relative_residual(const SparseMatrix<double> &a, const vector<double> &b, const vector<double> &x)
+{
+    vector<double> ax(b.size());
+    a.multiply(x.data(), ax.data());
+    double rr = 0, bb = 0;
+    for(size_t i = 0; i < b.size(); ++i)
+    {
+        rr += (b[i] - ax[i]) * (b[i] - ax[i]);
+        bb += b[i] * b[i];
+    }
+    return sqrt(rr / bb);
+}
+
+int gradient_test()
+{
+    int failures = 0;
+
+    /* five point Laplacian on a 40 x 40 grid, every preconditioner with both variants must reach
+     * the tolerance in the residual computed from x */
+    const size_t grid = 40, unknowns = grid * grid;
+    vector<SparseMatrix<double>::entry> entries;
+    for(size_t i = 0; i < grid; ++i)
+        for(size_t j = 0; j < grid; ++j)
+        {
+            const size_t row = i * grid + j;
+            entries.emplace_back(row, row, 4.0);
+            if(i) entries.emplace_back(row, row - grid, -1.0);
+            if(i + 1 < grid) entries.emplace_back(row, row + grid, -1.0);
+            if(j) entries.emplace_back(row, row - 1, -1.0);
+            if(j + 1 < grid) entries.emplace_back(row, row + 1, -1.0);
+        }
+    SparseMatrix<double> laplacian(unknowns, unknowns, entries);
+    vector<double> b(unknowns);
+    for(size_t i = 0; i < unknowns; ++i)
+        b[i] = 1 + sin((double) i);
+
+    IdentityPreconditioner identity(unknowns);
+    JacobiPreconditioner<double> jacobi(laplacian);
+    SsorPreconditioner<double> ssor(laplacian, 1.5);
+    IncompleteCholeskyPreconditioner<double> cholesky(laplacian);
+    size_t iterations[4][2];
+    for(int pipelined = 0; pipelined < 2; ++pipelined)
+    {
+        ConjugateGradientResult<double> results[4];
+        vector<double> x[4];
+        for(size_t k = 0; k < 4; ++k)
+            x[k].assign(unknowns, 0.0);
+        results[0] = conjugate_gradient(laplacian, identity, b, x[0], 1e-10, 0.0, (bool) pipelined);
+        results[1] = conjugate_gradient(laplacian, jacobi, b, x[1], 1e-10, 0.0, (bool) pipelined);
+        results[2] = conjugate_gradient(laplacian, ssor, b, x[2], 1e-10, 0.0, (bool) pipelined);
+        results[3] = conjugate_gradient(laplacian, cholesky, b, x[3], 1e-10, 0.0, (bool) pipelined);
+        const char *names[4] = {"identity", "jacobi", "ssor", "ic(0)"};
+        for(size_t k = 0; k < 4; ++k)
+        {
+            const double residual = relative_residual(laplacian, b, x[k]);
+            iterations[k][pipelined] = results[k].iterations;
+            cout << (pipelined ? "pipelined cg " : "cg ") << names[k] << " iterations " << results[k].iterations
+                 << ", residual " << scientific << residual << fixed << endl;
+            if(!results[k].converged || residual > 1e-10)
+                ++failures;
+        }
+    }
+    if(iterations[2][0] >= iterations[0][0] || iterations[3][0] >= iterations[1][0])
+        ++failures;
+
+    /* matrix-free operator of the one dimensional Laplacian, the solution of A x = A 1 is 1 */
+    const size_t points = 200;
+    auto tridiagonal = [points](const double *x, double *y) {
+        for(size_t i = 0; i < points; ++i)
+            y[i] = 2 * x[i] - (i ? x[i - 1] : 0) - (i + 1 < points ? x[i + 1] : 0);
+    };
+    vector<double> ones(points, 1.0), rhs(points), solution(points, 0.0);
+    tridiagonal(ones.data(), rhs.data());
+    ConjugateGradientResult<double> free_result = conjugate_gradient(tridiagonal, IdentityPreconditioner(points), rhs, solution, 1e-12);
+    double free_error = 0;
+    for(size_t i = 0; i < points; ++i)
+        free_error = max(free_error, abs(solution[i] - 1));
+    cout << "matrix-free cg iterations " << free_result.iterations << ", error " << scientific << free_error << fixed << endl << endl;
+    if(!free_result.converged || free_error > 1e-6)
+        ++failures;
+
+    /* chained Rosenbrock function sum 100 (x_{i+1} - x_i^2)^2 + (1 - x_i)^2 in 2 and 20 dimensions
+     * from (-1.2, 1, -1.2, 1, ...), the minimum is at (1, ..., 1) */
+    for(size_t dimension : {2, 20})
+    {
+        const size_t max_iterations = dimension == 2 ? 100 : 500;
+        auto rosenbrock = [dimension](const double *x, double *g) {
+            double f = 0;
+            fill(g, g + dimension, 0.0);
+            for(size_t i = 0; i + 1 < dimension; ++i)
+            {
+                const double t = x[i + 1] - x[i] * x[i], u = 1 - x[i];
+                f += 100 * t * t + u * u;
+                g[i] += -400 * x[i] * t - 2 * u;
+                g[i + 1] += 200 * t;
+            }
+            return f;
+        };
+        const DescentMethod methods[2] = {DescentMethod::lbfgs, DescentMethod::conjugate_gradient};
+        const char *names[2] = {"l-bfgs", "nonlinear cg"};
+        for(size_t k = 0; k < 2; ++k)
+        {
+            vector<double> x(dimension);
+            for(size_t i = 0; i < dimension; ++i)
+                x[i] = i % 2 ? 1 : -1.2;
+            MinimizationResult<double> result = minimize(rosenbrock, x, methods[k], 1e-6, 5000);
+            double error = 0;
+            for(size_t i = 0; i < dimension; ++i)
+                error = max(error, abs(x[i] - 1));
+            cout << names[k] << " rosenbrock " << dimension << " iterations " << result.iterations << ", evaluations "
+                 << result.evaluations << ", gradient " << scientific << result.gradient << ", error " << error << fixed << endl;
+            if(!result.converged || result.gradient > 1e-6 || result.iterations > max_iterations || error > 1e-6)
+                ++failures;
+        }
+    }
+
+    /* steepest descent on a well conditioned quadratic sum (i + 1) (x_i - i)^2 / 2 */
+    auto quadratic = [](const double *x, double *g) {
+        double f = 0;
+        for(size_t i = 0; i < 4; ++i)
+        {
+            g[i] = (double) (i + 1) * (x[i] - (double) i);
+            f += 0.5 * g[i] * (x[i] - (double) i);
+        }
+        return f;
+    };
+    vector<double> start(4, 0.0);
+    MinimizationResult<double> descent = minimize(quadratic, start, DescentMethod::steepest_descent);
+    double descent_error = 0;
+    for(size_t i = 0; i < 4; ++i)
+        descent_error = max(descent_error, abs(start[i] - (double) i));
+    cout << "steepest descent quadratic iterations " << descent.iterations << ", error " << scientific << descent_error
+         << fixed << endl << endl;
+    if(!descent.converged || descent_error > 1e-6)
+        ++failures;
+
+    return failures;
+}
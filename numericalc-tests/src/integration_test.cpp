@@ -0,0 +1,119 @@
+#include <iostream>
+#include <iomanip>
+#include "numericalc/integration/newton.hpp"
+#include "numericalc/integration/monte_carlo.hpp"
+#include <cmath>
+#include <set>
+
+using namespace std;
+
+int integration_test()
+{
+    int failures = 0;
+
+    /* composite Newton-Cotes rules on sin over [0, pi], doubling the subintervals divides the
+     * error by 2^order */
+    auto sine = [](const double *x, double *y, size_t count) {
+        for(size_t i = 0; i < count; ++i)
+            y[i] = sin(x[i]);
+    };
+    const size_t orders[5] = {0, 2, 4, 4, 6};
+    for(size_t degree = 1; degree <= NewtonCotesRule<double>::max_degree; ++degree)
+    {
+        const double coarse = abs(newton_cotes(sine, 0.0, M_PI, 8, degree) - 2);
+        const double fine = abs(newton_cotes(sine, 0.0, M_PI, 16, degree) - 2);
+        const double ratio = coarse / fine;
+        cout << "newton-cotes degree " << degree << " error " << scientific << fine << fixed << ", ratio " << ratio << endl;
+        if(ratio < 0.8 * (double) (1 << orders[degree]))
+            ++failures;
+    }
+
+    /* Simpson's rule is exact for cubics */
+    auto cubic = [](const double *x, double *y, size_t count) {
+        for(size_t i = 0; i < count; ++i)
+            y[i] = 1 - x[i] + 3 * x[i] * x[i] * x[i];
+    };
+    const double simpson_error = abs(newton_cotes(cubic, -1.0, 2.0, 3, 2) - 12.75);
+    cout << "simpson cubic error " << scientific << simpson_error << fixed << endl;
+    if(simpson_error > 1e-12)
+        ++failures;
+
+    /* adaptive Gauss-Kronrod on a smooth, a peaked and an endpoint singular integrand */
+    auto exponential = [](const double *x, double *y, size_t count) {
+        for(size_t i = 0; i < count; ++i)
+            y[i] = exp(x[i]);
+    };
+    auto peak = [](const double *x, double *y, size_t count) {
+        for(size_t i = 0; i < count; ++i)
+            y[i] = 1 / (1e-4 + (x[i] - 0.3) * (x[i] - 0.3));
+    };
+    auto root = [](const double *x, double *y, size_t count) {
+        for(size_t i = 0; i < count; ++i)
+            y[i] = sqrt(x[i]);
+    };
+    const double peak_exact = 100 * (atan(70.0) + atan(30.0));
+    for(size_t points : {15, 21})
+    {
+        QuadratureResult<double> results[3] = {
+            gauss_kronrod(exponential, 0.0, 1.0, 1e-12, 1e-10, points),
+            gauss_kronrod(peak, 0.0, 1.0, 1e-12, 1e-10, points),
+            gauss_kronrod(root, 0.0, 1.0, 1e-12, 1e-10, points)
+        };
+        const double exact[3] = {exp(1.0) - 1, peak_exact, 2.0 / 3};
+        const char *names[3] = {"exp", "peak", "sqrt"};
+        for(size_t i = 0; i < 3; ++i)
+        {
+            const double err = abs(results[i].value - exact[i]);
+            cout << "gauss-kronrod " << points << " " << names[i] << " error " << scientific << err
+                 << ", estimate " << results[i].error << fixed << ", intervals " << results[i].intervals
+                 << ", evaluations " << results[i].evaluations << endl;
+            if(err > 10 * max(1e-12, 1e-10 * abs(exact[i])))
+                ++failures;
+        }
+    }
+    cout << endl;
+
+    /* streams of neighbouring keys share no values */
+    size_t shared = 0;
+    for(uint64_t key = 0; key < 16; ++key)
+    {
+        set<uint64_t> stream;
+        for(uint64_t counter = 0; counter < 256; ++counter)
+            stream.insert(counter_random(key, counter));
+        for(uint64_t counter = 0; counter < 256; ++counter)
+            shared += stream.count(counter_random(key + 1, counter));
+    }
+    cout << "counter_random(5, 10) " << (counter_random(5, 10) == counter_random(6, 9) ? "=" : "!=")
+         << " counter_random(6, 9), values shared by neighbouring streams " << shared << endl;
+    if(shared || counter_random(5, 10) == counter_random(6, 9))
+        ++failures;
+
+    /* product of (pi / 2) sin(pi x_j) over [0, 1]^6 integrates to one */
+    const size_t dimension = 6;
+    auto sines = [dimension](const double *x, double *y, size_t count) {
+        for(size_t p = 0; p < count; ++p)
+        {
+            y[p] = 1;
+            for(size_t j = 0; j < dimension; ++j)
+                y[p] *= M_PI / 2 * sin(M_PI * x[p * dimension + j]);
+        }
+    };
+    const vector<double> lower(dimension, 0.0), upper(dimension, 1.0);
+    const SamplingMethod methods[3] = {SamplingMethod::monte_carlo, SamplingMethod::sobol, SamplingMethod::halton};
+    const char *method_names[3] = {"monte carlo", "sobol", "halton"};
+    const double tolerances[3] = {1e-2, 1e-4, 1e-4};
+    for(size_t i = 0; i < 3; ++i)
+    {
+        MonteCarloResult<double> result = monte_carlo(sines, lower, upper, methods[i], 0.0, tolerances[i], size_t(1) << 20, 7);
+        MonteCarloResult<double> serial = monte_carlo(sines, lower, upper, methods[i], 0.0, tolerances[i], size_t(1) << 20, 7, false);
+        const double err = abs(result.value - 1);
+        cout << method_names[i] << " error " << scientific << err << ", estimate " << result.error << fixed
+             << ", evaluations " << result.evaluations << endl;
+        if(err > max(5 * result.error, tolerances[i]) || result.error > tolerances[i] * 1.01
+           || result.value != serial.value || result.error != serial.error)
+            ++failures;
+    }
+    cout << endl;
+
+    return failures;
+}
@@ -1,9 +1,19 @@
 #include "poly_test.cpp"
 #include "matrix_test.cpp"
+#include "ode_test.cpp"
+#include "integration_test.cpp"
+#include "gradient_test.cpp"
+#include "eigen_test.cpp"
 
 int main()
 {
-    poly_test();
+    int failures = 0;
+    failures += poly_test();
+    failures += matrix_test();
+    failures += ode_test();
+    failures += integration_test();
+    failures += gradient_test();
+    failures += eigen_test();
 
-    return 0;
+    return failures ? 1 : 0;
 }
\ No newline at end of file
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include "numericalc/Matrix.hpp"
 #include "numericalc/decomposition/lu.hpp"
@@ -9,11 +11,12 @@ using dMatrix = Matrix<double>;
 
 int matrix_test()
 {
+    int failures = 0;
     dMatrix A(2, 2);
     dMatrix B = dMatrix::identity(2);
 
-    dMatrix u(3, 1, (double []){1, 2, 3});
-    dMatrix v(3, 1, (double[]){4, -1, 0});
+    dMatrix u(3, 1, vector<double>{1, 2, 3});
+    dMatrix v(3, 1, vector<double>{4, -1, 0});
 
     A(0,0) = 1;
     A(0,1) = 2;
@@ -47,5 +50,46 @@ int matrix_test()
 
     cout << "|u|_{max} = " << max_norm(u) << endl;
 
-    return 0;
+    /* rank deficient A = LU with u_{3,3} = 0, l_{3,2} depends on l_{3,1} u_{1,2} */
+    dMatrix L(4, 4, vector<double>{1, 0, 0, 0,
+                                   2, 1, 0, 0,
+                                   -1, 3, 1, 0,
+                                   0.5, -2, 4, 1});
+    dMatrix U(4, 4, vector<double>{2, 1, -1, 3,
+                                   0, 3, 2, 1,
+                                   0, 0, -1, 2,
+                                   0, 0, 0, 0});
+    dMatrix S = L * U;
+    dMatrix LU = lu_decomposition(S);
+    dMatrix Ld = dMatrix::identity(4), Ud(4, 4);
+    for(size_t i = 0; i < 4; ++i)
+        for(size_t j = 0; j < 4; ++j)
+            (i > j ? Ld(i, j) : Ud(i, j)) = LU(i, j);
+    dMatrix D = Ld * Ud - S;
+    double lu_error = 0;
+    for(size_t i = 0; i < 4; ++i)
+        for(size_t j = 0; j < 4; ++j)
+            lu_error = max(lu_error, abs(D(i, j)));
+    cout << "rank deficient LU error: " << lu_error << endl;
+    if(lu_error > 1e-12) ++failures;
+
+    /* zero leading element, the factorization must pivot */
+    dMatrix P(4, 4, vector<double>{0, 2, 1, -1,
+                                   3, 1, 0, 2,
+                                   1, 1, 1, 1,
+                                   -2, 4, 3, 0});
+    vector<double> b{1, -2, 0.5, 3};
+    vector<double> x(b), r(4);
+    dMatrix F = P;
+    vector<size_t> pivot;
+    bool regular = lu_factorize(F, pivot);
+    lu_solve(F, pivot, x.data());
+    P.multiply(x.data(), r.data());
+    double residual = 0;
+    for(size_t i = 0; i < 4; ++i)
+        residual = max(residual, abs(r[i] - b[i]));
+    cout << "pivoted LU solve residual: " << residual << endl;
+    if(!regular || residual > 1e-12) ++failures;
+
+    return failures;
 }
\ No newline at end of file
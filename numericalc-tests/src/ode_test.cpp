@@ -0,0 +1,128 @@
+#include <iostream>
+#include <iomanip>
+#include "numericalc/ode/euler.hpp"
+#include "numericalc/ode/bdf.hpp"
+#include "numericalc/ode/ensemble.hpp"
+#include <cmath>
+
+using namespace std;
+
+int ode_test()
+{
+    int failures = 0;
+
+    /* y' = -y on [0, 5], the adaptive method keeps the global error near the tolerance */
+    auto decay = [](double, const vector<double> &y, vector<double> &dydt) { dydt[0] = -y[0]; };
+    DormandPrince<double, decltype(decay)> dp(decay, 1, 1e-8, 1e-12);
+    vector<double> y{1};
+    double dense_error = 0, previous = 0;
+    bool finished = dp.integrate(0.0, 5.0, y, [&dense_error, &previous](double t, const vector<double> &, const DormandPrince<double, decltype(decay)> &s) {
+        vector<double> middle(1);
+        s.dense_output(0.5 * (previous + t), middle);
+        dense_error = max(dense_error, abs(middle[0] - exp(-0.5 * (previous + t))));
+        previous = t;
+    });
+    const double decay_error = abs(y[0] - exp(-5.0));
+    cout << "dormand-prince y' = -y, y(5) = " << scientific << y[0] << ", error " << decay_error
+         << ", dense error " << dense_error << fixed << endl;
+    cout << "accepted " << dp.accepted << ", rejected " << dp.rejected << ", evaluations " << dp.evaluations << endl;
+    if(!finished || decay_error > 1e-7 || dense_error > 1e-7)
+        ++failures;
+
+    /* y' = y^2, y(0) = 1 blows up at t = 1, the integration has to stop there */
+    auto blow_up = [](double, const vector<double> &y, vector<double> &dydt) { dydt[0] = y[0] * y[0]; };
+    DormandPrince<double, decltype(blow_up)> singular(blow_up, 1);
+    y = {1};
+    finished = singular.integrate(0.0, 2.0, y);
+    cout << "dormand-prince y' = y^2 " << (finished ? "finished" : "stopped") << " at t = " << singular.time() << endl;
+    if(finished || abs(singular.time() - 1) > 1e-3)
+        ++failures;
+
+    /* a right hand side returning NaN stops the integration */
+    auto not_finite = [](double t, const vector<double> &, vector<double> &dydt) { dydt[0] = t < 1 ? 1 : NAN; };
+    y = {0};
+    finished = dormand_prince(not_finite, 0.0, 2.0, y);
+    cout << "dormand-prince with NaN " << (finished ? "finished" : "stopped") << endl << endl;
+    if(finished)
+        ++failures;
+
+    /* Robertson's chemical kinetics on [0, 40], reference values of Hairer and Wanner */
+    auto robertson = [](double, const vector<double> &y, vector<double> &dydt) {
+        dydt[0] = -0.04 * y[0] + 1e4 * y[1] * y[2];
+        dydt[1] = 0.04 * y[0] - 1e4 * y[1] * y[2] - 3e7 * y[1] * y[1];
+        dydt[2] = 3e7 * y[1] * y[1];
+    };
+    const double robertson_40[3] = {0.7158270687, 9.185534764e-6, 0.2841637457};
+    Bdf<double, decltype(robertson)> stiff(robertson, 3, 1e-6, 1e-10);
+    y = {1, 0, 0};
+    finished = stiff.integrate(0.0, 40.0, y);
+    double robertson_error = 0;
+    for(size_t i = 0; i < 3; ++i)
+        robertson_error = max(robertson_error, abs(y[i] - robertson_40[i]) / robertson_40[i]);
+    cout << "bdf robertson y(40) = " << scientific << y[0] << " " << y[1] << " " << y[2]
+         << ", relative error " << robertson_error << fixed << endl;
+    cout << "accepted " << stiff.accepted << ", rejected " << stiff.rejected << ", evaluations " << stiff.evaluations
+         << ", jacobians " << stiff.jacobian_evaluations << ", factorizations " << stiff.factorizations << endl;
+    if(!finished || robertson_error > 1e-3)
+        ++failures;
+
+    /* a zero relative tolerance is raised to the resolution of the floating point type */
+    y = {1, 0, 0};
+    finished = bdf(robertson, 0.0, 1.0, y, 0.0, 1e-12);
+    cout << "bdf robertson with rtol = 0, y(1) = " << scientific << y[0] << " " << y[1] << " " << y[2] << fixed << endl;
+    if(!finished || !isfinite(y[0] + y[1] + y[2]) || abs(y[0] + y[1] + y[2] - 1) > 1e-9)
+        ++failures;
+
+    /* stiff diffusion y_i' = 400 (y_{i-1} - 2 y_i + y_{i+1}), the tridiagonal pattern needs three
+     * evaluations of f per finite difference Jacobian instead of n */
+    const size_t cells = 40;
+    auto diffusion = [cells](double, const vector<double> &y, vector<double> &dydt) {
+        for(size_t i = 0; i < cells; ++i)
+            dydt[i] = 400 * ((i ? y[i - 1] : 0) - 2 * y[i] + (i + 1 < cells ? y[i + 1] : 0));
+    };
+    vector<pair<size_t, size_t>> band;
+    for(size_t i = 0; i < cells; ++i)
+        for(size_t j = i ? i - 1 : 0; j <= i + 1 && j < cells; ++j)
+            band.emplace_back(i, j);
+    Bdf<double, decltype(diffusion)> banded(diffusion, cells), dense(diffusion, cells);
+    banded.set_sparsity(band);
+    vector<double> y_banded(cells, 1), y_dense(cells, 1);
+    finished = banded.integrate(0.0, 1.0, y_banded) && dense.integrate(0.0, 1.0, y_dense);
+    double band_difference = 0;
+    for(size_t i = 0; i < cells; ++i)
+        band_difference = max(band_difference, abs(y_banded[i] - y_dense[i]));
+    const size_t banded_evaluations = banded.evaluations, dense_evaluations = dense.evaluations;
+    cout << "bdf diffusion evaluations banded " << banded_evaluations << ", dense " << dense_evaluations
+         << ", difference " << scientific << band_difference << fixed << endl << endl;
+    if(!finished || band_difference > 1e-6 || banded_evaluations >= dense_evaluations)
+        ++failures;
+
+    /* 21 trajectories of y' = -lambda_m y, the last lane group is partly idle, against the scalar
+     * method with the same tolerances, trajectory 13 is y' = y^2 which blows up at t = 1 */
+    const size_t trajectories = 21;
+    auto rate = [](size_t m) { return 0.5 + 0.25 * (double) m; };
+    auto lanes = [&rate](const size_t *ids, const double *, const double *y, double *dydt) {
+        for(size_t l = 0; l < ensemble_lanes; ++l)
+            dydt[l] = ids[l] == 13 ? y[l] * y[l] : -rate(ids[l]) * y[l];
+    };
+    EnsembleDormandPrince<double, decltype(lanes)> ensemble(lanes, 1, 1e-8, 1e-12);
+    vector<double> states(trajectories, 1);
+    finished = ensemble.integrate(0.0, 2.0, states);
+    double ensemble_difference = 0;
+    for(size_t m = 0; m < trajectories; ++m)
+    {
+        if(m == 13)
+            continue;
+        const double lambda = rate(m);
+        auto scalar = [lambda](double, const vector<double> &y, vector<double> &dydt) { dydt[0] = -lambda * y[0]; };
+        y = {1};
+        dormand_prince(scalar, 0.0, 2.0, y, 1e-8, 1e-12);
+        ensemble_difference = max(ensemble_difference, abs(states[m] - y[0]) / y[0]);
+    }
+    cout << "ensemble of " << trajectories << " " << (finished ? "finished" : "stopped") << ", stopped " << ensemble.stopped
+         << ", relative difference to the scalar method " << scientific << ensemble_difference << fixed << endl << endl;
+    if(finished || ensemble.stopped != 1 || ensemble_difference > 1e-7)
+        ++failures;
+
+    return failures;
+}
@@ -1,10 +1,26 @@
 #include <iostream>
 #include <iomanip>
 #include "numericalc/Polynomial.hpp"
+#include "numericalc/SparsePolynomial.hpp"
+#include "numericalc/Modular.hpp"
 #include "numericalc/interpolation/lagrange.hpp"
+#include "numericalc/interpolation/subproduct_tree.hpp"
+#include "numericalc/interpolation/barycentric.hpp"
+#include "numericalc/interpolation/basis_cache.hpp"
+#include "numericalc/interpolation/chebyshev.hpp"
+#include "numericalc/interpolation/cubic_spline.hpp"
+#include "numericalc/interpolation/divided_difference.hpp"
 #include "numericalc/dft/dft.hpp"
 #include "numericalc/dft/fft.hpp"
+#include "numericalc/dft/fftn.hpp"
+#include "numericalc/dft/ntt.hpp"
+#include "numericalc/dft/convolution.hpp"
+#include "numericalc/multiplication/poly_mult.hpp"
+#include "numericalc/division/poly_div.hpp"
+#include "numericalc/root/newton.hpp"
+#include "numericalc/composition/composition.hpp"
 #include "numericalc/traits/compare_trait.hpp"
+#include <algorithm>
 #include <cmath>
 #include <complex>
 
@@ -12,10 +28,25 @@ using namespace std;
 
 int poly_test()
 {
-    Polynomial<double> p(4, (double []){1, -1, 2, 3});
+    int failures = 0;
+    Polynomial<double> p(vector<double>{1, -1, 2, 3});
 
     cout << "p = " << p << endl;
-    cout << "p(2) = " << p(2) << endl << endl;
+    cout << "p(2) = " << p(2) << endl;
+    cout << "p' = " << p.derivative() << endl;
+
+    vector<double> xs = {-1, 0, 0.5, 1, 2, 3, 4, 5, 6}, ys(xs.size()), ds(xs.size());
+    p.eval_with_derivative(xs.data(), ys.data(), ds.data(), xs.size());
+    vector<double> vs = p.eval_many(xs);
+    cout << "p(x), p'(x) at x =";
+    for(size_t i = 0; i < xs.size(); ++i)
+    {
+        const bool match = ys[i] == vs[i] && ys[i] == p.eval(xs[i]) && ds[i] == p.derivative().eval(xs[i]);
+        cout << " " << xs[i] << ": " << vs[i] << " " << ds[i] << (match ? "" : " (mismatch)") << ",";
+        if(!match)
+            ++failures;
+    }
+    cout << endl << endl;
 
     vector<double> grid(3);
     grid[0] = 1;
@@ -28,7 +59,7 @@ int poly_test()
         cout << "l_" << ++idx << " = " << l << endl;
     cout << "L = " << endl << lagrange_polynomial_matrix(grid) << endl;
 
-    Polynomial<complex<double>> q(4, (complex<double> []){0, -1, 2, 3});
+    Polynomial<complex<double>> q(vector<complex<double>>{0, -1, 2, 3});
 
     ios::fmtflags f(cout.flags());
     cout << "q              = " << setprecision(2) << fixed << q << endl;
@@ -38,12 +69,302 @@ int poly_test()
     cout << "DFT^-1(DFT(q)) = " << setprecision(2) << fixed << dft(dft_inv(q)) << endl << endl;
     cout.flags(f);
 
-    Polynomial<double> r(3, (double []){2, -1, 3});
+    /* six-step FFT forced by a low threshold has to match the radix-2 one */
+    const size_t n = 1 << 12;
+    vector<complex<double>> x(n), y;
+    for(size_t i = 0; i < n; ++i)
+        x[i] = complex<double>(sin(0.1 * i), cos(0.37 * i));
+    y = x;
+    FftPlan<double>(n).forward(x.data());
+    FftPlan<double>(n, 16).forward(y.data());
+    double err = 0;
+    for(size_t i = 0; i < n; ++i)
+        err = max(err, abs(x[i] - y[i]));
+    cout << "six-step FFT error = " << err << endl;
+    if(err > 1e-10)
+        ++failures;
+
+    /* batched transform of 3 interleaved signals has to match the single one */
+    const size_t m = 64;
+    vector<complex<double>> batch(3 * m);
+    for(size_t i = 0; i < batch.size(); ++i)
+        batch[i] = x[i];
+    FftPlan<double> small(m);
+    small.forward_batch(batch.data(), 3, 3, 1);
+    err = 0;
+    for(size_t b = 0; b < 3; ++b)
+    {
+        vector<complex<double>> single(m);
+        for(size_t j = 0; j < m; ++j)
+            single[j] = x[j * 3 + b];
+        small.forward(single.data());
+        for(size_t j = 0; j < m; ++j)
+            err = max(err, abs(single[j] - batch[j * 3 + b]));
+    }
+    small.inverse_batch(batch.data(), 3, 3, 1);
+    for(size_t i = 0; i < batch.size(); ++i)
+        err = max(err, abs(batch[i] - x[i]));
+    cout << "batched FFT error  = " << err << endl;
+    if(err > 1e-12)
+        ++failures;
+
+    /* real-input 2-D FFT has to match the half of the complex spectrum */
+    Matrix<double> img(8, 16);
+    for(size_t i = 0; i < 8; ++i)
+        for(size_t j = 0; j < 16; ++j)
+            img(i, j) = sin(0.3 * i + 0.7 * j * j);
+    Matrix<complex<double>> cimg(8, 16, vector<complex<double>>(img.elements().begin(), img.elements().end()));
+    Matrix<complex<double>> spec = fft2(cimg), half = rfft2(img);
+    Matrix<double> back = rfft2_inv(half, 16);
+    err = 0;
+    for(size_t i = 0; i < 8; ++i)
+        for(size_t j = 0; j < 16; ++j)
+        {
+            if(j <= 8)
+                err = max(err, abs(spec(i, j) - half(i, j)));
+            err = max(err, abs(back(i, j) - img(i, j)));
+            err = max(err, abs(fft2_inv(spec)(i, j) - cimg(i, j)));
+        }
+    cout << "2-D FFT error      = " << err << endl << endl;
+    if(err > 1e-12)
+        ++failures;
+
+    Polynomial<double> r(vector<double>{2, -1, 3});
     cout << setprecision(3) << fixed;
     cout << "p = " << p << endl;
     cout << "r = " << r << endl;
     cout << "p * r = " << p * r << endl;
-    cout << "p * r = " << fft_mult(p, r) << endl << endl;
+    cout << "p * r = " << fft_mult(p, r) << endl;
+
+    /* force Karatsuba and Toom-3 down to the smallest sizes */
+    PolyMultThresholds thresholds = poly_mult_thresholds();
+    poly_mult_thresholds().karatsuba = 2;
+    poly_mult_thresholds().toom3 = 5;
+    cout << "p * r = " << karatsuba_mult(p, r) << endl;
+    cout << "p * r = " << toom3_mult(p, r) << endl << endl;
+
+    /* every algorithm against the schoolbook product, missing coefficients are zero */
+    auto product_error = [](const Polynomial<double> &a, const Polynomial<double> &b) {
+        double e = 0;
+        for(size_t i = 0; i < max(a.degree(), b.degree()); ++i)
+            e = max(e, abs((i < a.degree() ? a[i] : 0) - (i < b.degree() ? b[i] : 0)));
+        return e;
+    };
+    vector<double> da(300), db(200);
+    for(size_t i = 0; i < da.size(); ++i)
+        da[i] = sin(0.7 * i);
+    for(size_t i = 0; i < db.size(); ++i)
+        db[i] = cos(1.3 * i);
+    Polynomial<double> pa(da), pb(db), exact_product = schoolbook_mult(pa, pb);
+    err = max(product_error(poly_mult(p, r), schoolbook_mult(p, r)), product_error(fft_mult(p, r), schoolbook_mult(p, r)));
+    err = max(err, max(product_error(karatsuba_mult(p, r), schoolbook_mult(p, r)), product_error(toom3_mult(p, r), schoolbook_mult(p, r))));
+    err = max(err, max(product_error(karatsuba_mult(pa, pb), exact_product), product_error(toom3_mult(pa, pb), exact_product)));
+    err = max(err, max(product_error(fft_mult(pa, pb), exact_product), product_error(poly_mult(pa, pb), exact_product)));
+    poly_mult_thresholds() = thresholds;
+    err = max(err, product_error(poly_mult(pa, pb), exact_product));
+    cout << "multiplication error = " << scientific << err << fixed << endl << endl;
+    if(err > 1e-10)
+        ++failures;
+
+    Polynomial<long long> pi(vector<long long>{1000000007, -3, 0, 123456789012});
+    Polynomial<long long> ri(vector<long long>{-987654321098, 5, 7});
+    cout << "pi * ri = " << pi * ri << endl;
+    cout << "pi * ri = " << ntt_mult(pi, ri) << endl;
+    /* 64-bit coefficients need five primes, their roots of unity have order at most 2^24 */
+    Polynomial<long long> wide(vector<long long>((1 << 23) + 1, 1LL << 62));
+    cout << "ntt supports 2^24 coefficients of 2^62: " << (ntt_supported(wide, wide) ? "yes" : "no") << endl;
+    vector<long long> la(1000), lb(700);
+    for(size_t i = 0; i < la.size(); ++i)
+        la[i] = (long long) (i * 7919 % 1048573) - 524288;
+    for(size_t i = 0; i < lb.size(); ++i)
+        lb[i] = (long long) (i * 104729 % 1048573) - 524288;
+    Polynomial<long long> lpa(la), lpb(lb);
+    const bool ntt_exact = ntt_mult(pi, ri).coefficients() == schoolbook_mult(pi, ri).coefficients()
+                           && ntt_mult(lpa, lpb).coefficients() == schoolbook_mult(lpa, lpb).coefficients();
+    cout << "ntt product " << (ntt_exact ? "exact" : "wrong") << endl << endl;
+    if(!ntt_exact || ntt_supported(wide, wide))
+        ++failures;
+
+    /* streaming convolution fed in uneven chunks has to match the product */
+    vector<double> signal(100), filter(37);
+    for(size_t i = 0; i < signal.size(); ++i)
+        signal[i] = sin(0.5 * i);
+    for(size_t i = 0; i < filter.size(); ++i)
+        filter[i] = 1.0 / (i + 1);
+    Polynomial<double> full = Polynomial<double>(signal) * Polynomial<double>(filter);
+    for(auto method : {Convolver<double>::overlap_add, Convolver<double>::overlap_save})
+    {
+        Convolver<double> conv(filter, 8, method);
+        vector<double> out;
+        for(size_t i = 0, chunk = 1; i < signal.size(); i += chunk, chunk = chunk * 3 % 17)
+            conv.process(signal.data() + i, min(chunk, signal.size() - i), out);
+        conv.flush(out);
+        err = out.size() + 1 == full.degree() ? 0 : 1;
+        for(size_t i = 0; i < out.size() && i < full.degree(); ++i)
+            err = max(err, abs(out[i] - full[i]));
+        cout << "convolution error = " << scientific << err << fixed << endl;
+        if(err > 1e-12)
+            ++failures;
+    }
+    cout << endl;
+
+    SparsePolynomial<double> sp(vector<pair<size_t, double>>{{1000000, 1}, {0, 1}});
+    SparsePolynomial<double> sq(vector<pair<size_t, double>>{{500000, 2}, {3, -1}, {3, 0.5}});
+    cout << "sp      = " << sp << endl;
+    cout << "sq      = " << sq << endl;
+    cout << "sp * sq = " << sp * sq << endl;
+    cout << "sp - sp = " << sp - sp << endl;
+    cout << "sp(0.9999) = " << sp(0.9999) << endl;
+    SparsePolynomial<double> sd(p);
+    cout << "sd * sd = " << sd * sd << endl;
+    cout << "p  * p  = " << p * p << endl << endl;
+    const vector<pair<size_t, double>> sparse_product{{3, -0.5}, {500000, 2}, {1000003, -0.5}, {1500000, 2}};
+    const Polynomial<double> sparse_difference = (sd * sd).dense() - p * p;
+    if(any_of(sparse_difference.coefficients().begin(), sparse_difference.coefficients().end(), [](double c) { return c != 0; })
+       || (sp - sp).size() != 0 || (sp * sq).terms() != sparse_product
+       || abs(sp(0.9999) - (1 + pow(0.9999, 1000000))) > 1e-12)
+        ++failures;
+
+    cout << "p(x + 1) = " << taylor_shift(p, 1.0) << endl;
+    cout << "p(p(x))  = " << compose(p, p) << endl;
+    Polynomial<long long> lq(vector<long long>(300, 1));
+    taylor_shift_inplace(lq, 1LL);
+    taylor_shift_inplace(lq, -1LL);
+    const bool shifted_back = lq.coefficients() == vector<long long>(300, 1);
+    cout << "shift back " << (shifted_back ? "==" : "!=") << " original" << endl << endl;
+    const Polynomial<double> shift_difference = taylor_shift(p, 1.0) - Polynomial<double>(vector<double>{5, 12, 11, 3});
+    const Polynomial<double> compose_difference = compose(p, p) - Polynomial<double>(vector<double>{5, -12, 35, -11, -4, 123, 15, 27, 162, 81});
+    if(!shifted_back || any_of(shift_difference.coefficients().begin(), shift_difference.coefficients().end(), [](double c) { return c != 0; })
+       || any_of(compose_difference.coefficients().begin(), compose_difference.coefficients().end(), [](double c) { return c != 0; }))
+        ++failures;
+
+    /* (x - 1)(x - 2)(x + 3)(x^2 + 1) */
+    vector<complex<double>> roots = aberth_roots(Polynomial<double>(vector<double>{6, -7, 6, -6, 0, 1}));
+    sort(roots.begin(), roots.end(), [](complex<double> a, complex<double> b) { return a.real() < b.real() || (a.real() == b.real() && a.imag() < b.imag()); });
+    cout << "roots =";
+    for(auto z : roots)
+        cout << " " << z;
+    cout << endl << endl;
+    const complex<double> expected_roots[5] = {-3.0, complex<double>(0, -1), complex<double>(0, 1), 1.0, 2.0};
+    err = roots.size() == 5 ? 0 : 1;
+    for(size_t i = 0; i < roots.size() && i < 5; ++i)
+        err = max(err, abs(roots[i] - expected_roots[i]));
+    if(err > 1e-10)
+        ++failures;
+
+    /* division by a divisor long enough for Newton iteration, a = q b + r */
+    vector<double> dividend(200), divisor(70);
+    for(size_t i = 0; i < dividend.size(); ++i)
+        dividend[i] = cos(0.3 * i);
+    for(size_t i = 0; i < divisor.size(); ++i)
+        divisor[i] = 0.01 * sin(1.0 * i);
+    divisor.back() = 2;
+    pair<Polynomial<double>, Polynomial<double>> qr = divmod(Polynomial<double>(dividend), Polynomial<double>(divisor));
+    Polynomial<double> qb = qr.first * Polynomial<double>(divisor) + qr.second;
+    err = 0;
+    for(size_t i = 0; i < dividend.size(); ++i)
+        err = max(err, abs(qb[i] - dividend[i]));
+    cout << "divmod sizes = " << qr.first.degree() << ", " << qr.second.degree() << endl;
+    cout << "divmod error = " << scientific << err << fixed << endl << endl;
+    if(err > 1e-12 || qr.first.degree() != dividend.size() - divisor.size() + 1 || qr.second.degree() >= divisor.size())
+        ++failures;
+
+    /* barycentric interpolation of 1 / (1 + 25x^2) on Chebyshev points, closed form weights and
+     * general weights with the last node added afterwards */
+    vector<double> cheb(40), runge(40);
+    for(size_t j = 0; j < cheb.size(); ++j)
+    {
+        cheb[j] = cos((2 * j + 1) * M_PI / (2 * cheb.size()));
+        runge[j] = 1 / (1 + 25 * cheb[j] * cheb[j]);
+    }
+    BarycentricInterpolator<double> bary(cheb, runge, BarycentricInterpolator<double>::chebyshev_first);
+    BarycentricInterpolator<double> bary_general(vector<double>(cheb.begin(), cheb.end() - 1),
+                                                 vector<double>(runge.begin(), runge.end() - 1));
+    bary_general.add_node(cheb.back(), runge.back());
+    err = 0;
+    for(double x = -1; x <= 1; x += 0.01)
+        err = max(err, abs(bary(x) - bary_general(x)));
+    cout << "barycentric (0.3) = " << bary(0.3) << ", exact " << 1 / (1 + 25 * 0.09) << endl;
+    cout << "barycentric closed form vs general = " << scientific << err << fixed << endl;
+    if(err > 1e-12)
+        ++failures;
+
+    /* bases are memoized, the second construction on the same grid is a hit */
+    BasisCache<double, vector<double>>::Statistics before = basis_cache<double, vector<double>>().statistics();
+    BarycentricInterpolator<double> bary_cached(cheb, runge);
+    BarycentricInterpolator<double> bary_repeated(cheb, runge);
+    BasisCache<double, vector<double>>::Statistics stats = basis_cache<double, vector<double>>().statistics();
+    lagrange_polynomials(vector<double>{0, 1, 2});
+    lagrange_polynomials(vector<double>{0, 1, 2});
+    cout << "cached barycentric (0.3) = " << bary_repeated(0.3) << ", hits " << stats.hits - before.hits << ", misses " << stats.misses - before.misses << endl;
+    cout << "cached lagrange hits " << basis_cache<double, vector<Polynomial<double>>>().statistics().hits << endl << endl;
+    if(stats.hits - before.hits != 1 || bary_cached.weights() != bary_repeated.weights())
+        ++failures;
+
+    /* streaming Newton interpolation with a window of 6 points against the points themselves */
+    NewtonInterpolator<double> stream(6);
+    for(size_t i = 0; i < 20; ++i)
+        stream.add_point(0.3 * i, sin(0.3 * i));
+    Polynomial<double> stream_poly = stream.polynomial();
+    err = 0;
+    for(size_t i = 14; i < 20; ++i)
+        err = max(err, max(abs(stream(0.3 * i) - sin(0.3 * i)), abs(stream_poly.eval(0.3 * i) - sin(0.3 * i))));
+    cout << "windowed newton (4.5) = " << stream(4.5) << ", exact " << sin(4.5) << endl;
+    cout << "windowed newton error at the nodes = " << scientific << err << fixed << endl << endl;
+    if(err > 1e-12)
+        ++failures;
+
+    /* Chebyshev approximation of exp(x) sin(30x) on [-2, 3] to machine precision */
+    auto wave = [](double x) { return exp(x) * sin(30 * x); };
+    ChebyshevApproximation<double> chebyshev = ChebyshevApproximation<double>::fit(wave, -2.0, 3.0);
+    err = 0;
+    for(double x = -2; x <= 3; x += 0.01)
+        err = max(err, abs(chebyshev(x) - wave(x)));
+    cout << "chebyshev coefficients = " << chebyshev.size() << endl;
+    cout << "chebyshev error = " << scientific << err << fixed << endl << endl;
+    if(err > 1e-12)
+        ++failures;
+
+    /* not-a-knot spline on a non-uniform grid reproduces a cubic */
+    vector<double> knots, cubic;
+    for(size_t i = 0; i < 12; ++i)
+    {
+        knots.push_back(0.1 * i * i);
+        cubic.push_back(1 + 2 * knots[i] - knots[i] * knots[i] + 0.5 * knots[i] * knots[i] * knots[i]);
+    }
+    CubicSpline<double> spline(knots, cubic, CubicSpline<double>::not_a_knot);
+    vector<double> spline_points;
+    for(double x = 0; x <= knots.back(); x += 0.01)
+        spline_points.push_back(x);
+    vector<double> spline_values = spline.eval_many(spline_points);
+    err = 0;
+    for(size_t i = 0; i < spline_points.size(); ++i)
+    {
+        const double x = spline_points[i];
+        err = max(err, abs(spline_values[i] - (1 + 2 * x - x * x + 0.5 * x * x * x)));
+    }
+    cout << "not-a-knot spline error = " << scientific << err << fixed << endl << endl;
+    if(err > 1e-10)
+        ++failures;
+
+    /* remainder tree evaluation and interpolation over Z_998244353 on 5000 points, exact
+     * against Horner's schema */
+    using mod = Modular<998244353u>;
+    vector<mod> points(5000), coefficients(5000);
+    for(size_t i = 0; i < points.size(); ++i)
+    {
+        points[i] = mod((long long) (i * i) * 7919 + 3 * i + 1);
+        coefficients[i] = mod((long long) i * 104729 - 5000000);
+    }
+    Polynomial<mod> pm(coefficients);
+    SubproductTree<mod> tree(points);
+    vector<mod> values = tree.evaluate(pm);
+    bool exact = values == pm.eval_many(points);
+    Polynomial<mod> mi = tree.interpolate(values);
+    exact = exact && mi.coefficients() == coefficients;
+    cout << "multipoint evaluation and interpolation of 5000 points " << (exact ? "exact" : "wrong") << endl << endl;
+    if(!exact)
+        ++failures;
 
     cout << "1   " << (compare_trait<int>::eq(1, 1) ? "= " : "!=") << " 1" << endl
          << "3.0 " << (compare_trait<double>::eq(3.0, 0) ? "= " : "!=") << " 0" << endl
@@ -55,6 +376,6 @@ int poly_test()
     complex<double> z2(1.0, 1.0);
     cout << z1 << (compare_trait<complex<double>>::eq(z1, z2) ? " =  " : " != ") << z2 << endl;
 
-    return 0;
+    return failures;
 }
 
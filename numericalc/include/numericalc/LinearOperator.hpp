@@ -0,0 +1,71 @@
+#ifndef NUMERICALC_LINEAR_OPERATOR_HPP
+#define NUMERICALC_LINEAR_OPERATOR_HPP
+
+#include "numericalc/Matrix.hpp"
+#include "numericalc/SparseMatrix.hpp"
+
+/**
+ * Linear operator of a dense or sparse matrix, a callable computing \f$y = A x\f$ on raw arrays.
+ * Iterative methods accept any callable op(x, y) with this meaning, so a matrix-free operator is
+ * passed as it is and matrices are wrapped by make_operator. Block methods call op(X, Y, k)
+ * instead, the product with k vectors stored by rows, \f$X_{ij}\f$ at i * k + j.
+ *
+ * @tparam M matrix type
+ * Copyright (c) 2020 Peter Grajcar
+ */
+template <typename M>
+class MatrixOperator
+{
+private:
+    const M *matrix;
+    bool parallel;
+public:
+    /**
+     *
+     * @param matrix matrix, must outlive the operator
+     * @param parallel split the products across the thread pool
+     */
+    explicit MatrixOperator(const M &matrix, bool parallel = true) : matrix(&matrix), parallel(parallel) {}
+
+    template <typename T>
+    inline void operator()(const T *x, T *y) const
+    {
+        matrix->multiply(x, y, parallel);
+    }
+
+    /**
+     * Block product \f$Y = A X\f$ of k vectors stored by rows.
+     */
+    template <typename T>
+    inline void operator()(const T *x, T *y, size_t k) const
+    {
+        matrix->multiply(x, y, k, parallel);
+    }
+};
+
+template <typename T>
+inline MatrixOperator<Matrix<T>> make_operator(const Matrix<T> &matrix, bool parallel = true)
+{
+    return MatrixOperator<Matrix<T>>(matrix, parallel);
+}
+
+template <typename T>
+inline MatrixOperator<SparseMatrix<T>> make_operator(const SparseMatrix<T> &matrix, bool parallel = true)
+{
+    return MatrixOperator<SparseMatrix<T>>(matrix, parallel);
+}
+
+/**
+ * Returns a matrix-free operator unchanged.
+ *
+ * @tparam F callable op(x, y)
+ * @param op operator
+ * @return op
+ */
+template <typename F>
+inline const F &make_operator(const F &op, bool = true)
+{
+    return op;
+}
+
+#endif //NUMERICALC_LINEAR_OPERATOR_HPP
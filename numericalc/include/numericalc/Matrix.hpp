@@ -2,6 +2,7 @@
 #define NSMERICALC_MATRIX_HPP
 
 #include <cstddef>
+#include <cassert>
 #include <vector>
 #include <iostream>
 #include <iomanip>
@@ -54,7 +55,7 @@ public:
      * @param n
      * @param vec
      */
-    Matrix(size_t m, size_t n, std::vector<T> &&vec) : rows(m), cols(n), matrix(vec) {};
+    Matrix(size_t m, size_t n, std::vector<T> &&vec) : rows(m), cols(n), matrix(std::move(vec)) {};
 
     /**
      * Creates an identity matrix. Identity matrix is a matrix \f$N*N\f$ with ones on the diagonal.
@@ -199,6 +200,26 @@ public:
      */
     Matrix operator*(const Matrix &lhs) const;
 
+    /**
+     * Matrix-vector product \f$y = A x\f$ on raw arrays, without the temporaries of operator*.
+     *
+     * @param x vector of cols elements
+     * @param y vector of rows elements
+     * @param parallel split the rows across the thread pool
+     */
+    void multiply(const T *x, T *y, bool parallel = true) const;
+
+    /**
+     * Matrix product \f$Y = A X\f$ with k right hand sides, X and Y are stored by rows with k
+     * elements per row. The rows of X are combined with contiguous k wide updates.
+     *
+     * @param x cols times k elements
+     * @param y rows times k elements
+     * @param k number of columns of X
+     * @param parallel split the rows across the thread pool
+     */
+    void multiply(const T *x, T *y, size_t k, bool parallel = true) const;
+
     /**
      * Applies function f on each element of the matrix.
      *
@@ -0,0 +1,158 @@
+#ifndef NUMERICALC_MODULAR_HPP
+#define NUMERICALC_MODULAR_HPP
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include "numericalc/traits/compare_trait.hpp"
+
+/**
+ * Class representing an element of the prime field \f$\mathbb{Z}_P\f$. Arithmetic is exact, so
+ * algorithms that are numerically unstable in floating point, such as remainder trees, can be
+ * used on polynomials with Modular coefficients. Polynomials over
+ * \f$\mathbb{Z}_{998244353}\f$ are multiplied by a single NTT.
+ *
+ * @tparam P prime modulus below \f$2^{31}\f$
+ * Copyright (c) 2020 Peter Grajcar
+ */
+template <uint32_t P>
+class Modular
+{
+    static_assert(P > 1 && P < (1u << 31), "modulus has to fit into 31 bits");
+private:
+    uint32_t v;
+public:
+    static constexpr uint32_t modulus = P;
+
+    Modular() : v(0) {}
+
+    /**
+     * Constructs the residue of an integer.
+     *
+     * @param x integer
+     */
+    Modular(long long x) : v((uint32_t) ((x % (long long) P + P) % P)) {}
+
+    /**
+     *
+     * @return representative in \f$[0, P)\f$
+     */
+    inline uint32_t value() const
+    {
+        return v;
+    }
+
+    /**
+     *
+     * @param e exponent
+     * @return \f$x^e\f$
+     */
+    Modular pow(uint64_t e) const
+    {
+        Modular r(1), a(*this);
+        for(; e; e >>= 1, a *= a)
+            if(e & 1)
+                r *= a;
+        return r;
+    }
+
+    /**
+     * Multiplicative inverse by Fermat's little theorem.
+     *
+     * @return \f$x^{-1}\f$, x must not be zero
+     */
+    Modular inverse() const
+    {
+        assert(v != 0);
+        return pow(P - 2);
+    }
+
+    Modular operator-() const
+    {
+        Modular r;
+        r.v = v ? P - v : 0;
+        return r;
+    }
+
+    Modular &operator+=(const Modular &b)
+    {
+        v += b.v;
+        if(v >= P) v -= P;
+        return *this;
+    }
+
+    Modular &operator-=(const Modular &b)
+    {
+        v = v >= b.v ? v - b.v : v + P - b.v;
+        return *this;
+    }
+
+    Modular &operator*=(const Modular &b)
+    {
+        v = (uint32_t) ((uint64_t) v * b.v % P);
+        return *this;
+    }
+
+    Modular &operator/=(const Modular &b)
+    {
+        return *this *= b.inverse();
+    }
+
+    friend Modular operator+(Modular a, const Modular &b)
+    {
+        return a += b;
+    }
+
+    friend Modular operator-(Modular a, const Modular &b)
+    {
+        return a -= b;
+    }
+
+    friend Modular operator*(Modular a, const Modular &b)
+    {
+        return a *= b;
+    }
+
+    friend Modular operator/(Modular a, const Modular &b)
+    {
+        return a /= b;
+    }
+
+    friend bool operator==(const Modular &a, const Modular &b)
+    {
+        return a.v == b.v;
+    }
+
+    friend bool operator!=(const Modular &a, const Modular &b)
+    {
+        return a.v != b.v;
+    }
+
+    friend std::ostream &operator<<(std::ostream &os, const Modular &a)
+    {
+        return os << a.v;
+    }
+};
+
+template <uint32_t P>
+constexpr uint32_t Modular<P>::modulus;
+
+/**
+ * Residues are compared exactly, they are not ordered.
+ *
+ * @tparam P prime modulus
+ */
+template <uint32_t P>
+struct compare_trait<Modular<P>>
+{
+    static bool eq(const Modular<P> &a, const Modular<P> &b)
+    {
+        return a == b;
+    }
+    static bool neq(const Modular<P> &a, const Modular<P> &b)
+    {
+        return a != b;
+    }
+};
+
+#endif //NUMERICALC_MODULAR_HPP
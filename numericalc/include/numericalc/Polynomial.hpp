@@ -108,16 +108,50 @@ public:
     }
 
     /**
-     * Evaluates polynomial at x. Evaluation is done using Horner's schema.
+     * Evaluates polynomial at x. Evaluation is done using Horner's schema, polynomials of high
+     * degree are evaluated in blocks of 8 coefficients by Estrin's scheme, which shortens the
+     * dependency chain, the blocks are then combined by Horner's schema in \f$x^8\f$.
      *
      * @param x x value
      * @return value of polynomial at x
      */
     T eval(T x) const;
 
+    /**
+     * Evaluates polynomial at count points. Points are processed in groups by Horner's schema
+     * running across the points of a group, so the independent evaluations vectorise.
+     *
+     * @param xs points
+     * @param out values of polynomial at xs
+     * @param count number of points
+     * @param parallel split the points across the thread pool
+     */
+    void eval_many(const T *xs, T *out, size_t count, bool parallel = false) const;
+
+    /**
+     * Evaluates polynomial at each point of xs.
+     *
+     * @see eval_many
+     * @param xs points
+     * @param parallel split the points across the thread pool
+     * @return values of polynomial at xs
+     */
+    std::vector<T> eval_many(const std::vector<T> &xs, bool parallel = false) const;
+
+    /**
+     * Evaluates polynomial and its first derivative at count points in a single pass.
+     *
+     * @param xs points
+     * @param values values of polynomial at xs
+     * @param derivatives values of the first derivative at xs
+     * @param count number of points
+     * @param parallel split the points across the thread pool
+     */
+    void eval_with_derivative(const T *xs, T *values, T *derivatives, size_t count, bool parallel = false) const;
+
     /**
      * Returns first derivative of polynomial. Returned polynomial is of size \f$n - 1\f$ where \f$n\f$ is
-     * size of original polynomial.
+     * size of original polynomial. Zero polynomial has zero derivative.
      *
      * @return first derivative of polynomial
      */
@@ -149,11 +183,11 @@ public:
     Polynomial operator-(const Polynomial &q) const;
 
     /**
-     * \f$O(mn)\f$ polynomial multiplication. Resulting polynomial always has size \f$m + n\f$. No
-     * implicit zero trimming is done. For more effictient multiplication see Fast Fourier Transform (FFT)
-     * header file.
+     * Polynomial multiplication. Resulting polynomial always has size \f$m + n\f$. No
+     * implicit zero trimming is done. The algorithm (schoolbook, Karatsuba, Toom-3, FFT or NTT)
+     * is chosen by the size and type of the operands.
      *
-     * @see dft Fast Fourier Transform
+     * @see poly_mult
      * @param q second polynomial
      * @return polynomial product
      */
@@ -185,13 +219,13 @@ public:
 
     Polynomial &operator-=(const Polynomial &q)
     {
-        *this = *this + q;
+        *this = *this - q;
         return *this;
     }
 
     Polynomial &operator*=(const Polynomial &q)
     {
-        *this = *this + q;
+        *this = *this * q;
         return *this;
     }
 
@@ -0,0 +1,134 @@
+#ifndef NUMERICALC_SPARSE_MATRIX_HPP
+#define NUMERICALC_SPARSE_MATRIX_HPP
+
+#include <cstddef>
+#include <cassert>
+#include <tuple>
+#include <vector>
+#include "numericalc/Matrix.hpp"
+
+/**
+ * Class representing a sparse matrix in the compressed sparse row format. Row i has the entries
+ * offsets[i] .. offsets[i + 1] - 1 of columns and values, sorted by column.
+ *
+ * @tparam T matrix type
+ * Copyright (c) 2020 Peter Grajcar
+ */
+template <typename T>
+class SparseMatrix
+{
+public:
+    using entry = std::tuple<size_t, size_t, T>;
+private:
+    size_t rows, cols;
+    std::vector<size_t> offsets;
+    std::vector<size_t> columns;
+    std::vector<T> values;
+public:
+    /**
+     * Constructs a sparse matrix \f$M \times N\f$ from row, column and value triplets in any
+     * order, values of repeated positions are summed.
+     *
+     * @param m rows
+     * @param n columns
+     * @param entries non-zero entries
+     */
+    SparseMatrix(size_t m, size_t n, const std::vector<entry> &entries);
+
+    /**
+     * Constructs a sparse matrix from the compressed rows.
+     *
+     * @param m rows
+     * @param n columns
+     * @param offsets m + 1 row offsets
+     * @param columns column of every entry, sorted within each row
+     * @param values value of every entry
+     */
+    SparseMatrix(size_t m, size_t n, std::vector<size_t> offsets, std::vector<size_t> columns,
+                 std::vector<T> values);
+
+    /**
+     * Constructs a sparse matrix from the non-zero elements of a dense one.
+     *
+     * @param dense dense matrix
+     */
+    explicit SparseMatrix(const Matrix<T> &dense);
+
+    inline size_t get_rows() const
+    {
+        return rows;
+    }
+
+    inline size_t get_cols() const
+    {
+        return cols;
+    }
+
+    /**
+     *
+     * @return number of stored entries
+     */
+    inline size_t nonzeros() const
+    {
+        return values.size();
+    }
+
+    inline const std::vector<size_t> &row_offsets() const
+    {
+        return offsets;
+    }
+
+    inline const std::vector<size_t> &column_indices() const
+    {
+        return columns;
+    }
+
+    inline const std::vector<T> &elements() const
+    {
+        return values;
+    }
+
+    /**
+     * Returns element at position i, j in \f$O(\log k)\f$ for k entries in the row.
+     *
+     * @param i row
+     * @param j column
+     * @return element, zero if not stored
+     */
+    T operator()(size_t i, size_t j) const;
+
+    /**
+     *
+     * @return elements on the diagonal
+     */
+    std::vector<T> diagonal() const;
+
+    /**
+     * Matrix-vector product \f$y = A x\f$.
+     *
+     * @param x vector of get_cols() elements
+     * @param y vector of get_rows() elements
+     * @param parallel split the rows across the thread pool
+     */
+    void multiply(const T *x, T *y, bool parallel = true) const;
+
+    /**
+     * Matrix product \f$Y = A X\f$ with k right hand sides stored by rows, every entry of A is
+     * loaded once for all k columns.
+     *
+     * @param x get_cols() times k elements
+     * @param y get_rows() times k elements
+     * @param k number of columns of X
+     * @param parallel split the rows across the thread pool
+     */
+    void multiply(const T *x, T *y, size_t k, bool parallel = true) const;
+
+    /**
+     * Converts to a dense matrix.
+     *
+     * @return dense matrix
+     */
+    Matrix<T> dense() const;
+};
+
+#endif //NUMERICALC_SPARSE_MATRIX_HPP
@@ -0,0 +1,192 @@
+#ifndef NUMERICALC_SPARSE_POLYNOMIAL_HPP
+#define NUMERICALC_SPARSE_POLYNOMIAL_HPP
+
+#include <vector>
+#include <utility>
+#include <iostream>
+#include "numericalc/Polynomial.hpp"
+
+/**
+ * Class representing polynomial with few non-zero terms. Terms are stored as exponent and
+ * coefficient pairs sorted by exponent, zero coefficients are never stored, so memory and the
+ * cost of operations depend on the number of terms rather than on the degree.
+ *
+ * @tparam T polynomial type
+ * Copyright (c) 2020 Peter Grajcar
+ */
+template <typename T>
+class SparsePolynomial
+{
+public:
+    using term = std::pair<size_t, T>;
+private:
+    std::vector<term> data;
+
+    void normalise();
+public:
+    /**
+     * Constructs a zero polynomial.
+     */
+    SparsePolynomial() {}
+
+    /**
+     * Constructs a polynomial from terms in any order. Terms with equal exponents are summed,
+     * zero terms are dropped.
+     *
+     * @param terms exponent and coefficient pairs
+     */
+    explicit SparsePolynomial(const std::vector<term> &terms);
+
+    /**
+     * Constructs a polynomial from the non-zero coefficients of a dense polynomial.
+     *
+     * @param p dense polynomial
+     */
+    explicit SparsePolynomial(const Polynomial<T> &p);
+
+    /**
+     * Same convention as Polynomial::degree, i.e. the highest exponent plus one.
+     *
+     * @return degree of polynomial, zero for zero polynomial
+     */
+    inline size_t degree() const
+    {
+        return data.empty() ? 0 : data.back().first + 1;
+    }
+
+    /**
+     *
+     * @return number of non-zero terms
+     */
+    inline size_t size() const
+    {
+        return data.size();
+    }
+
+    /**
+     *
+     * @return terms sorted by exponent
+     */
+    inline const std::vector<term> &terms() const
+    {
+        return data;
+    }
+
+    /**
+     * Converts the polynomial to dense representation of size degree(), zero polynomial has
+     * size one.
+     *
+     * @return dense polynomial
+     */
+    Polynomial<T> dense() const;
+
+    /**
+     * Evaluates polynomial at x.
+     *
+     * @param x x value
+     * @return value of polynomial at x
+     */
+    inline T operator()(T x) const
+    {
+        return eval(x);
+    }
+
+    /**
+     * Evaluates polynomial at x by Horner's schema over the terms, the gaps between consecutive
+     * exponents are bridged by exponentiation by squaring. Takes \f$O(t \log(n / t))\f$
+     * multiplications for t terms and degree n.
+     *
+     * @param x x value
+     * @return value of polynomial at x
+     */
+    T eval(T x) const;
+
+    /**
+     * Polynomial negation.
+     *
+     * @return negated polynomial
+     */
+    SparsePolynomial operator-() const;
+
+    /**
+     * Polynomial addition by merging the terms.
+     *
+     * @param q second polynomial
+     * @return sum
+     */
+    SparsePolynomial operator+(const SparsePolynomial &q) const;
+
+    /**
+     * Polynomial subtraction by merging the terms.
+     *
+     * @param q second polynomial
+     * @return difference
+     */
+    SparsePolynomial operator-(const SparsePolynomial &q) const;
+
+    /**
+     * Polynomial multiplication. Products of sparse operands are computed by heap merging in
+     * \f$O(t_p t_q \log \min(t_p, t_q))\f$, the terms are produced in order of exponents and
+     * never held all at once. When the operands are dense enough that
+     * \f$t_p t_q\f$ exceeds the dense product size times SparsePolynomial::dense_mult_ratio,
+     * the operands are converted to Polynomial and multiplied by poly_mult.
+     *
+     * @param q second polynomial
+     * @return polynomial product
+     */
+    SparsePolynomial operator*(const SparsePolynomial &q) const;
+
+    /**
+     * Multiplies every coefficient by a scalar.
+     *
+     * @param n scalar
+     * @return scaled polynomial
+     */
+    SparsePolynomial operator*(T n) const;
+
+    SparsePolynomial &operator+=(const SparsePolynomial &q)
+    {
+        *this = *this + q;
+        return *this;
+    }
+
+    SparsePolynomial &operator-=(const SparsePolynomial &q)
+    {
+        *this = *this - q;
+        return *this;
+    }
+
+    SparsePolynomial &operator*=(const SparsePolynomial &q)
+    {
+        *this = *this * q;
+        return *this;
+    }
+
+    /**
+     * Term products per coefficient of the dense product above which multiplication switches
+     * to the dense algorithms.
+     */
+    static const size_t dense_mult_ratio = 2;
+
+    template <typename U>
+    friend std::ostream &operator<<(std::ostream &os, const SparsePolynomial<U> &p);
+};
+
+template <typename T>
+std::ostream &operator<<(std::ostream &os, const SparsePolynomial<T> &p)
+{
+    if(p.data.empty())
+        return os << T(0);
+
+    for(size_t i = p.data.size(); i-- > 0;)
+    {
+        os << p.data[i].second;
+        if(p.data[i].first == 1)     os << "x";
+        else if(p.data[i].first > 1) os << "x^" << p.data[i].first;
+        if(i) os << " + ";
+    }
+
+    return os;
+}
+
+#endif //NUMERICALC_SPARSE_POLYNOMIAL_HPP
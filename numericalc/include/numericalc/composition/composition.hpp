@@ -0,0 +1,71 @@
+/**
+ * Taylor shift and composition of polynomials.
+ *
+ * @file composition.hpp
+ * Copyright (c) 2020 Peter Grajcar
+ */
+#ifndef NUMERICALC_COMPOSITION_HPP
+#define NUMERICALC_COMPOSITION_HPP
+
+#include "numericalc/Polynomial.hpp"
+
+/**
+ * Computes \f$p(x + a)\f$ in place. Short polynomials are shifted by the classical
+ * \f$O(n^2)\f$ synthetic division scheme without any allocation. Longer ones are split as
+ * \f$p = p_{lo} + x^h p_{hi}\f$ with h a power of two, so that
+ * \f$p(x + a) = p_{lo}(x + a) + (x + a)^h p_{hi}(x + a)\f$, the powers
+ * \f$(x + a)^{2^j}\f$ are computed once by squaring. This takes \f$O(M(n) \log n)\f$.
+ *
+ * The product of factorials formulation in \f$O(M(n))\f$ is not used, factorials overflow
+ * floating point types beyond n = 170 and the transform error relative to the largest term
+ * destroys the small coefficients long before that. For floating point types the error of
+ * the divide and conquer scheme is small relative to the largest coefficient of the result,
+ * the classical scheme is accurate for each coefficient. Integral types are computed in
+ * unsigned arithmetic, so the result is exact modulo \f$2^{bits}\f$ and overflow wraps as in
+ * poly_mult.
+ *
+ * @tparam T polynomial type
+ * @param p polynomial, replaced by the shifted polynomial of the same size
+ * @param a shift
+ */
+template <typename T>
+void taylor_shift_inplace(Polynomial<T> &p, T a);
+
+/**
+ * Computes \f$p(x + a)\f$.
+ *
+ * @see taylor_shift_inplace
+ * @tparam T polynomial type
+ * @param p polynomial
+ * @param a shift
+ * @return shifted polynomial of the same size as p
+ */
+template <typename T>
+Polynomial<T> taylor_shift(const Polynomial<T> &p, T a);
+
+/**
+ * Computes \f$p(q(x))\f$ in place. Polynomial p is split as \f$p = p_{lo} + x^h p_{hi}\f$ with
+ * h a power of two, so that \f$p(q) = p_{lo}(q) + q^h p_{hi}(q)\f$, the powers \f$q^{2^j}\f$
+ * are computed once by squaring. With fast multiplication this takes \f$O(M(nm) \log n)\f$
+ * for p of size n and q of size m. Short parts of p are evaluated by Horner's schema.
+ *
+ * @tparam T polynomial type
+ * @param p outer polynomial, replaced by the composition of size \f$(n - 1)(m - 1) + 1\f$
+ * @param q inner polynomial
+ */
+template <typename T>
+void compose_inplace(Polynomial<T> &p, const Polynomial<T> &q);
+
+/**
+ * Computes \f$p(q(x))\f$.
+ *
+ * @see compose_inplace
+ * @tparam T polynomial type
+ * @param p outer polynomial
+ * @param q inner polynomial
+ * @return composition of size \f$(n - 1)(m - 1) + 1\f$ for p of size n and q of size m
+ */
+template <typename T>
+Polynomial<T> compose(const Polynomial<T> &p, const Polynomial<T> &q);
+
+#endif //NUMERICALC_COMPOSITION_HPP
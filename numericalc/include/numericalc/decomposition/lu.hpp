@@ -6,6 +6,7 @@
 #ifndef NUMERICALC_LU_HPP
 #define NUMERICALC_LU_HPP
 
+#include <vector>
 #include "numericalc/Matrix.hpp"
 
 /**
@@ -25,4 +26,29 @@
 template<typename T>
 Matrix<T> lu_decomposition(const Matrix<T> a);
 
+/**
+ * Decomposes square matrix A in place with partial pivoting, \f$PA = LU\f$. The strict lower
+ * triangle of a is replaced by L with implied ones on the diagonal and the upper triangle by U.
+ * Row k was swapped with row pivot[k] \f$\geq k\f$ in step k. The factorization can be reused for
+ * any number of right hand sides by lu_solve.
+ *
+ * @tparam T matrix element type
+ * @param a matrix A, replaced by the decomposition
+ * @param pivot row swaps, resized to the size of a
+ * @return false if A is singular
+ */
+template<typename T>
+bool lu_factorize(Matrix<T> &a, std::vector<size_t> &pivot);
+
+/**
+ * Solves \f$Ax = b\f$ in place given the decomposition of A by lu_factorize, \f$O(n^2)\f$.
+ *
+ * @tparam T matrix element type
+ * @param lu decomposed matrix
+ * @param pivot row swaps
+ * @param b right hand side, replaced by the solution
+ */
+template<typename T>
+void lu_solve(const Matrix<T> &lu, const std::vector<size_t> &pivot, T *b);
+
 #endif //NUMERICALC_LU_HPP
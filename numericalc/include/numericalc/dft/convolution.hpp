@@ -0,0 +1,107 @@
+/**
+ * Streaming FFT convolution.
+ *
+ * @file convolution.hpp
+ * Copyright (c) 2020 Peter Grajcar
+ */
+#ifndef NUMERICALC_CONVOLUTION_HPP
+#define NUMERICALC_CONVOLUTION_HPP
+
+#include <complex>
+#include <vector>
+#include "numericalc/dft/fft.hpp"
+
+/**
+ * Streaming convolution of a real signal with a fixed real filter.
+ *
+ * The filter of length L is split into \f$P = \lceil L / B \rceil\f$ partitions of block size B,
+ * each partition is transformed once by a real FFT of length 2B. Input arrives in chunks of
+ * arbitrary length and is processed in blocks of B samples. Spectra of the last P input blocks
+ * are kept in a frequency-domain delay line, so one block costs one forward FFT, P complex
+ * multiply-accumulates of B + 1 bins and one inverse FFT regardless of the filter length.
+ *
+ * Output is emitted block by block, at most B - 1 samples behind the input. Memory is
+ * \f$O(L + B)\f$ and no allocation happens after construction apart from growing the output
+ * vector supplied by the caller.
+ *
+ * @tparam T floating point type
+ */
+template <typename T>
+class Convolver
+{
+public:
+    /**
+     * Block convolution method. Both produce the same output.
+     */
+    enum Method
+    {
+        /**
+         * Each input block is zero-padded, the overlapping tails of output blocks are added.
+         */
+        overlap_add,
+        /**
+         * Each input block is preceded by the previous one, the aliased half of the output
+         * is discarded.
+         */
+        overlap_save
+    };
+private:
+    using complex = std::complex<T>;
+
+    Method method;
+    size_t block, partitions, filter_len;
+    RealFftPlan<T> plan;
+    // partition spectra and the delay line of input spectra, B + 1 bins each
+    std::vector<complex> filter_spectra, delay_line;
+    size_t head;
+    std::vector<complex> accumulator;
+    // time-domain buffers of length 2B, the previous input block or the overlapping tail
+    std::vector<T> frame, result, overlap;
+    std::vector<T> pending;
+    size_t pending_count;
+    size_t consumed, emitted;
+
+    void process_block(std::vector<T> &out, size_t count);
+public:
+    /**
+     * Prepares convolution with given filter.
+     *
+     * @param filter filter impulse response
+     * @param block_size block size B, has to be power of two
+     * @param method block convolution method
+     */
+    Convolver(const std::vector<T> &filter, size_t block_size, Method method = overlap_save);
+
+    /**
+     *
+     * @return block size
+     */
+    inline size_t block_size() const
+    {
+        return block;
+    }
+
+    /**
+     * Feeds a chunk of input. Every completed block of B samples appends B output samples to out.
+     *
+     * @param in input samples
+     * @param count number of input samples
+     * @param out output samples are appended here
+     */
+    void process(const T *in, size_t count, std::vector<T> &out);
+
+    /**
+     * Ends the stream. Appends the rest of the full convolution to out, so the total output
+     * has length \f$n + L - 1\f$ for n input samples, and resets the convolver.
+     *
+     * @param out output samples are appended here
+     */
+    void flush(std::vector<T> &out);
+
+    /**
+     * Discards all buffered input and starts a new stream with the same filter.
+     */
+    void reset();
+};
+
+#endif //NUMERICALC_CONVOLUTION_HPP
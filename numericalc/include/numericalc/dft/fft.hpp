@@ -9,6 +9,173 @@
 
 #include "numericalc/Polynomial.hpp"
 #include <complex>
+#include <memory>
+#include <vector>
+
+/**
+ * Precomputed in-place Fast Fourier Transform of a fixed power-of-two length.
+ *
+ * Short transforms use iterative radix-2 algorithm with a precomputed twiddle table. Transforms
+ * of at least four_step_threshold points use the six-step (Bailey) algorithm: the data are viewed
+ * as a matrix \f$n_1 \times n_2\f$, \f$n = n_1 n_2\f$, and the transform is computed as
+ * <ol>
+ *      <li>transpose, \f$n_2\f$ FFTs of length \f$n_1\f$ and multiplication by twiddle factors
+ *      \f$\omega_n^{j_2 k_1}\f$,</li>
+ *      <li>transpose, \f$n_1\f$ FFTs of length \f$n_2\f$,</li>
+ *      <li>final transpose.</li>
+ * </ol>
+ * Each sub-transform fits into cache and the sub-transforms run in parallel on the thread pool.
+ *
+ * @tparam T floating point type
+ */
+template <typename T>
+class FftPlan
+{
+private:
+    using complex = std::complex<T>;
+
+    size_t n;
+    // radix-2: w^j for j < n/2
+    std::vector<complex> twiddle;
+    // six-step: n = n1 * n2, w^m = twiddle_lo[m % n1] * twiddle_hi[m / n1]
+    size_t n1, n2, log_n1;
+    std::shared_ptr<const FftPlan> row_plan, col_plan;
+    std::vector<complex> twiddle_lo, twiddle_hi;
+
+    void radix2(complex *data, bool inv) const;
+    void six_step(complex *data, bool inv) const;
+    void radix2_lanes(complex *data, size_t stride, size_t lo, size_t hi, bool inv) const;
+public:
+    /**
+     * Default length from which the six-step algorithm is used.
+     */
+    static const size_t default_four_step_threshold = (size_t) 1 << 16;
+
+    /**
+     * Prepares transform of length n.
+     *
+     * @param n transform length, has to be power of two
+     * @param four_step_threshold length from which the six-step algorithm is used
+     */
+    explicit FftPlan(size_t n, size_t four_step_threshold = default_four_step_threshold);
+
+    /**
+     *
+     * @return transform length
+     */
+    inline size_t size() const
+    {
+        return n;
+    }
+
+    /**
+     * Unnormalised in-place transform. The inverse direction differs from the forward one only
+     * by the sign of the exponent, the result is not divided by n.
+     *
+     * @param data n complex values
+     * @param inv inverse direction
+     */
+    void transform(complex *data, bool inv) const;
+
+    /**
+     * In-place forward transform.
+     *
+     * @param data n complex values
+     */
+    void forward(complex *data) const;
+
+    /**
+     * In-place inverse transform including the \f$1 \over n\f$ normalisation.
+     *
+     * @param data n complex values
+     */
+    void inverse(complex *data) const;
+
+    /**
+     * Unnormalised in-place transform of count signals sharing this plan. Element j of signal b
+     * is stored at data[b * dist + j * stride], hence
+     * <ul>
+     *      <li>stride = 1, dist = n for signals stored one after another,</li>
+     *      <li>stride = count, dist = 1 for interleaved signals.</li>
+     * </ul>
+     * Interleaved signals are transformed together with butterflies vectorised across the
+     * signals. Other layouts are transformed one by one, strided signals through a per-thread
+     * buffer. The batch is split across the thread pool.
+     *
+     * @param data signals
+     * @param count number of signals
+     * @param stride distance between consecutive elements of a signal
+     * @param dist distance between first elements of consecutive signals
+     * @param inv inverse direction
+     */
+    void transform_batch(complex *data, size_t count, size_t stride, size_t dist, bool inv) const;
+
+    /**
+     * In-place forward transform of count signals.
+     *
+     * @see transform_batch
+     */
+    void forward_batch(complex *data, size_t count, size_t stride, size_t dist) const;
+
+    /**
+     * In-place inverse transform of count signals including the \f$1 \over n\f$ normalisation.
+     *
+     * @see transform_batch
+     */
+    void inverse_batch(complex *data, size_t count, size_t stride, size_t dist) const;
+};
+
+/**
+ * Precomputed Fast Fourier Transform of real data of a fixed power-of-two length. The n real
+ * values are packed into n/2 complex values and transformed by a complex FFT of half the length,
+ * the spectrum is then separated in one additional pass. Only the non-redundant half of the
+ * spectrum, \f$X_0, \dots, X_{n/2}\f$, is stored as \f$X_{n-k} = \overline{X_k}\f$.
+ *
+ * @tparam T floating point type
+ */
+template <typename T>
+class RealFftPlan
+{
+private:
+    using complex = std::complex<T>;
+
+    size_t n;
+    FftPlan<T> half_plan;
+    // w^k for k < n/2
+    std::vector<complex> twiddle;
+public:
+    /**
+     * Prepares transform of length n.
+     *
+     * @param n transform length, has to be power of two and at least 2
+     */
+    explicit RealFftPlan(size_t n);
+
+    /**
+     *
+     * @return transform length
+     */
+    inline size_t size() const
+    {
+        return n;
+    }
+
+    /**
+     * Forward transform.
+     *
+     * @param in n real values
+     * @param out n/2 + 1 complex values
+     */
+    void forward(const T *in, complex *out) const;
+
+    /**
+     * Inverse transform including the \f$1 \over n\f$ normalisation.
+     *
+     * @param in n/2 + 1 complex values
+     * @param out n real values
+     */
+    void inverse(const complex *in, T *out) const;
+};
 
 /**
  * Fast Fourier Transform. The degree of the polynomial has to be power of two.
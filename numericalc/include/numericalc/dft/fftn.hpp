@@ -0,0 +1,83 @@
+/**
+ * Multidimensional Fast Fourier Transform.
+ *
+ * @file fftn.hpp
+ * Copyright (c) 2020 Peter Grajcar
+ */
+#ifndef NUMERICALC_FFTN_HPP
+#define NUMERICALC_FFTN_HPP
+
+#include <complex>
+#include <vector>
+#include "numericalc/Matrix.hpp"
+#include "numericalc/dft/fft.hpp"
+
+/**
+ * N-dimensional Fast Fourier Transform of a row-major array. The transform is separable, so
+ * 1-D FFTs are run along each axis in turn. Axes other than the last one are first brought into
+ * contiguous rows by cache-blocked transposition. All rows of an axis are transformed in parallel.
+ * Each dimension has to be power of two.
+ *
+ * @tparam T floating point type
+ * @param a row-major array
+ * @param shape dimensions of the array, the last one varies fastest
+ * @return fourier-transformed array
+ */
+template <typename T>
+std::vector<std::complex<T>> fftn(const std::vector<std::complex<T>> &a, const std::vector<size_t> &shape);
+
+/**
+ * Inverse N-dimensional Fast Fourier Transform of a row-major array.
+ *
+ * @see fftn
+ * @tparam T floating point type
+ * @param a row-major array
+ * @param shape dimensions of the array, the last one varies fastest
+ * @return inverse fourier-transformed array
+ */
+template <typename T>
+std::vector<std::complex<T>> fftn_inv(const std::vector<std::complex<T>> &a, const std::vector<size_t> &shape);
+
+/**
+ * 2-D Fast Fourier Transform. Both dimensions have to be power of two.
+ *
+ * @tparam T floating point type
+ * @param a matrix
+ * @return fourier-transformed matrix
+ */
+template <typename T>
+Matrix<std::complex<T>> fft2(const Matrix<std::complex<T>> &a);
+
+/**
+ * Inverse 2-D Fast Fourier Transform. Both dimensions have to be power of two.
+ *
+ * @tparam T floating point type
+ * @param a matrix
+ * @return inverse fourier-transformed matrix
+ */
+template <typename T>
+Matrix<std::complex<T>> fft2_inv(const Matrix<std::complex<T>> &a);
+
+/**
+ * 2-D Fast Fourier Transform of real data. Rows are transformed by real-input FFT, hence only
+ * the non-redundant \f$M \times (N/2 + 1)\f$ part of the spectrum is returned.
+ *
+ * @tparam T floating point type
+ * @param a real matrix \f$M \times N\f$
+ * @return half spectrum \f$M \times (N/2 + 1)\f$
+ */
+template <typename T>
+Matrix<std::complex<T>> rfft2(const Matrix<T> &a);
+
+/**
+ * Inverse of rfft2.
+ *
+ * @tparam T floating point type
+ * @param a half spectrum \f$M \times (N/2 + 1)\f$
+ * @param cols number of columns N of the real matrix
+ * @return real matrix \f$M \times N\f$
+ */
+template <typename T>
+Matrix<T> rfft2_inv(const Matrix<std::complex<T>> &a, size_t cols);
+
+#endif //NUMERICALC_FFTN_HPP
@@ -0,0 +1,79 @@
+/**
+ * Number-theoretic transform.
+ *
+ * @file ntt.hpp
+ * Copyright (c) 2020 Peter Grajcar
+ */
+#ifndef NUMERICALC_NTT_HPP
+#define NUMERICALC_NTT_HPP
+
+#include <cstdint>
+#include "numericalc/Polynomial.hpp"
+#include "numericalc/Modular.hpp"
+
+/**
+ * Exact polynomial multiplication using Number-Theoretic Transform in \f$O(n \log n)\f$.
+ *
+ * The product is computed modulo several word-sized primes of the form \f$c \cdot 2^k + 1\f$
+ * using Montgomery arithmetic, the transforms for different primes run in parallel. Coefficients
+ * are then reconstructed by the Chinese remainder theorem (Garner's algorithm). The number of
+ * primes is chosen from the magnitude of the coefficients so that the result is exact. If the
+ * true coefficient does not fit into T, it wraps around the same way as in the schoolbook
+ * multiplication.
+ *
+ * Resulting polynomial always has size \f$m + n\f$ as with Polynomial::operator*.
+ *
+ * The primes limit the length of the product to between \f$2^{23}\f$ and \f$2^{27}\f$
+ * coefficients depending on the number of primes needed, products the primes cannot represent
+ * are rejected.
+ *
+ * @see ntt_supported
+ * @tparam T signed integral type of at most 64 bits
+ * @param p polynomial p
+ * @param q polynomial q
+ * @return product of p and q
+ * @throws std::length_error if ntt_supported(p, q) is false
+ */
+template <typename T>
+Polynomial<T> ntt_mult(const Polynomial<T> &p, const Polynomial<T> &q);
+
+/**
+ * Checks whether ntt_mult can multiply the polynomials, i.e. whether the available primes cover
+ * the bound on the product coefficients and have roots of unity of the order of the transform.
+ * Callers can fall back to another algorithm if it cannot.
+ *
+ * @tparam T signed integral type of at most 64 bits
+ * @param p polynomial p
+ * @param q polynomial q
+ * @return whether ntt_mult supports the product
+ */
+template <typename T>
+bool ntt_supported(const Polynomial<T> &p, const Polynomial<T> &q);
+
+/**
+ * Polynomial multiplication over \f$\mathbb{Z}_P\f$ by a single NTT modulo P in
+ * \f$O(n \log n)\f$. P has to be one of the NTT primes, e.g. 998244353 which supports products
+ * of up to \f$2^{23}\f$ coefficients.
+ *
+ * @see ntt_supported
+ * @tparam P prime modulus
+ * @param p polynomial p
+ * @param q polynomial q
+ * @return product of p and q of size \f$m + n\f$
+ * @throws std::length_error if ntt_supported(p, q) is false
+ */
+template <uint32_t P>
+Polynomial<Modular<P>> ntt_mult(const Polynomial<Modular<P>> &p, const Polynomial<Modular<P>> &q);
+
+/**
+ * Checks whether P is an NTT prime with roots of unity of the order needed for the product.
+ *
+ * @tparam P prime modulus
+ * @param p polynomial p
+ * @param q polynomial q
+ * @return whether ntt_mult supports the product
+ */
+template <uint32_t P>
+bool ntt_supported(const Polynomial<Modular<P>> &p, const Polynomial<Modular<P>> &q);
+
+#endif //NUMERICALC_NTT_HPP
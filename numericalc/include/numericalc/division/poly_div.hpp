@@ -0,0 +1,93 @@
+/**
+ * Polynomial division with remainder.
+ *
+ * @file poly_div.hpp
+ * Copyright (c) 2020 Peter Grajcar
+ */
+#ifndef NUMERICALC_POLY_DIV_HPP
+#define NUMERICALC_POLY_DIV_HPP
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "numericalc/Polynomial.hpp"
+
+/**
+ * Divisor with precomputed inverse for repeated division by the same polynomial.
+ *
+ * Division \f$a = q b + r\f$ is computed on reversed polynomials,
+ * \f$\mathrm{rev}(q) = \mathrm{rev}(a) / \mathrm{rev}(b) \bmod x^{k}\f$ where k is the size of
+ * the quotient. The series inverse of \f$\mathrm{rev}(b)\f$ is computed once by Newton iteration
+ * \f$g \leftarrow g (2 - \mathrm{rev}(b) g)\f$, afterwards each division costs two
+ * multiplications, i.e. \f$O(M(n))\f$. Dividends longer than the precomputed precision are
+ * reduced in chunks from the top. Short divisors and quotients use classical long division.
+ *
+ * Trailing zero coefficients of the divisor are ignored, the leading coefficient does not have
+ * to be one.
+ *
+ * @tparam T floating point or Modular type
+ */
+template <typename T>
+class PolyDivisor
+{
+private:
+    std::vector<T> divisor;
+    // 1 / rev(divisor) mod x^k, empty if long division is used
+    std::vector<T> inverse;
+
+    void reduce(std::vector<T> &r, std::vector<T> *q) const;
+public:
+    /**
+     * Precomputes the inverse of the divisor.
+     *
+     * @param b divisor, must not be zero
+     * @param dividend_size size of dividends the inverse is prepared for, zero means
+     *                      \f$2n - 1\f$ for divisor of size n, i.e. products of two remainders
+     */
+    explicit PolyDivisor(const Polynomial<T> &b, size_t dividend_size = 0);
+
+    /**
+     *
+     * @return divisor without trailing zeros
+     */
+    inline Polynomial<T> polynomial() const
+    {
+        return Polynomial<T>(divisor);
+    }
+
+    /**
+     * Divides polynomial a by the divisor.
+     *
+     * @param a dividend
+     * @return pair of quotient and remainder, the remainder has size n - 1 for divisor of size n > 1
+     */
+    std::pair<Polynomial<T>, Polynomial<T>> divmod(const Polynomial<T> &a) const;
+
+    /**
+     *
+     * @param a dividend
+     * @return quotient of a divided by the divisor
+     */
+    Polynomial<T> quotient(const Polynomial<T> &a) const;
+
+    /**
+     *
+     * @param a dividend
+     * @return a modulo the divisor, of size n - 1 for divisor of size n > 1
+     */
+    Polynomial<T> remainder(const Polynomial<T> &a) const;
+};
+
+/**
+ * Divides polynomial a by b such that \f$a = q b + r\f$ and \f$\deg r < \deg b\f$.
+ *
+ * @see PolyDivisor
+ * @tparam T floating point or Modular type
+ * @param a dividend
+ * @param b divisor, must not be zero
+ * @return pair of quotient and remainder
+ */
+template <typename T>
+std::pair<Polynomial<T>, Polynomial<T>> divmod(const Polynomial<T> &a, const Polynomial<T> &b);
+
+#endif //NUMERICALC_POLY_DIV_HPP
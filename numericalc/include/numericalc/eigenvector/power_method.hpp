@@ -1,5 +1,10 @@
 /**
+ * Dominant eigenpairs of symmetric matrices by the power method, block (subspace) iteration and
+ * the thick-restart Lanczos method.
  *
+ * The matrix is a dense Matrix, a SparseMatrix or a matrix-free operator, see LinearOperator.hpp.
+ * The power and Lanczos methods call op(x, y) computing \f$y = A x\f$, the block iteration calls
+ * op(X, Y, k) computing the product with k vectors stored by rows.
  *
  * @file power_method.hpp
  * Copyright (c) 2020 Peter Grajcar
@@ -7,4 +12,378 @@
 #ifndef NUMERICALC_POWER_METHOD_HPP
 #define NUMERICALC_POWER_METHOD_HPP
 
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <vector>
+#include "numericalc/LinearOperator.hpp"
+#include "numericalc/Matrix.hpp"
+
+/**
+ * Eigendecomposition of a small symmetric matrix by the cyclic Jacobi method,
+ * \f$A = V \Lambda V^T\f$.
+ *
+ * @tparam T floating point type
+ * @param m size of the matrix
+ * @param a m times m matrix by rows, destroyed
+ * @param values m eigenvalues in no particular order
+ * @param vectors m times m matrix by rows, column j is the eigenvector of values[j]
+ */
+template <typename T>
+void symmetric_eigen(size_t m, T *a, T *values, T *vectors);
+
+/**
+ * Fills x with pseudo-random numbers in (-1, 1), the same for the same seed on every platform.
+ *
+ * @tparam T floating point type
+ * @param x array
+ * @param count number of elements
+ * @param seed seed
+ */
+template <typename T>
+void random_vector(T *x, size_t count, uint64_t seed);
+
+/**
+ * Gram matrix \f$C = A^T B\f$ of n times p and n times q matrices stored by rows. Rows are
+ * accumulated in chunks across the thread pool and the chunks summed in order.
+ *
+ * @tparam T floating point type
+ * @param a n times p matrix
+ * @param b n times q matrix
+ * @param n rows
+ * @param p columns of a
+ * @param q columns of b
+ * @param c p times q result
+ * @param parallel split the rows across the thread pool
+ */
+template <typename T>
+void block_gram(const T *a, const T *b, size_t n, size_t p, size_t q, T *c, bool parallel = true);
+
+/**
+ * Product \f$B = A V\f$ of an n times p matrix and a p times q matrix stored by rows.
+ *
+ * @see block_gram
+ */
+template <typename T>
+void block_combine(const T *a, const T *v, size_t n, size_t p, size_t q, T *b, bool parallel = true);
+
+/**
+ * Orthonormalises the columns of an n times k matrix stored by rows by the Cholesky QR method
+ * applied twice, which is made of block_gram and a triangular solve per row. Columns which are
+ * numerically dependent are replaced by random vectors and orthonormalised by Gram-Schmidt.
+ *
+ * @tparam T floating point type
+ * @param x n times k matrix, replaced by an orthonormal basis of its columns
+ * @param n rows
+ * @param k columns
+ * @param parallel split the rows across the thread pool
+ */
+template <typename T>
+void block_orthonormalize(T *x, size_t n, size_t k, bool parallel = true);
+
+/**
+ * Combination \f$W_i = \sum_j Y_{ji} V_j\f$ of m vectors of length n stored one after another,
+ * the restart of the Lanczos method.
+ *
+ * @tparam T floating point type
+ * @param v m vectors
+ * @param n length of the vectors
+ * @param m number of vectors
+ * @param y m times l matrix by rows
+ * @param l number of combinations
+ * @param w l vectors
+ * @param parallel split the rows across the thread pool
+ */
+template <typename T>
+void combine_vectors(const T *v, size_t n, size_t m, const T *y, size_t l, T *w, bool parallel = true);
+
+/**
+ * Eigenpairs computed by an iterative method.
+ *
+ * @tparam T floating point type
+ */
+template <typename T>
+struct EigenResult
+{
+    std::vector<T> values;
+    /**
+     * n times k matrix, column j is the eigenvector of values[j].
+     */
+    Matrix<T> vectors;
+    size_t iterations;
+    bool converged;
+};
+
+/**
+ * Power method with shift. Iterates \f$x \leftarrow (A - \sigma I) x / \|(A - \sigma I) x\|\f$,
+ * which converges to the eigenvector whose eigenvalue is farthest from the shift, and returns the
+ * Rayleigh quotient \f$x^T A x\f$. Converged once \f$\|A x - \lambda x\| \le tol |\lambda|\f$.
+ *
+ * @tparam T floating point type
+ * @tparam A Matrix, SparseMatrix or matrix-free operator
+ * @param a matrix or operator
+ * @param n dimension
+ * @param shift shift \f$\sigma\f$
+ * @param tol relative tolerance of the residual
+ * @param max_iterations maximal number of iterations
+ * @param seed seed of the starting vector
+ * @return eigenvalue and eigenvector
+ */
+template <typename T, typename A>
+EigenResult<T> power_method(const A &a, size_t n, T shift = T(0), T tol = T(1e-8), size_t max_iterations = 10000,
+                            uint64_t seed = 1)
+{
+    auto op = make_operator(a);
+    EigenResult<T> result = {std::vector<T>(1), Matrix<T>(n, 1), 0, false};
+    std::vector<T> x(n), y(n);
+    random_vector(x.data(), n, seed);
+
+    T norm = std::sqrt(std::inner_product(x.begin(), x.end(), x.begin(), T(0)));
+    for(T &v : x)
+        v /= norm;
+    for(; result.iterations < max_iterations; ++result.iterations)
+    {
+        op(x.data(), y.data());
+        const T lambda = std::inner_product(x.begin(), x.end(), y.begin(), T(0));
+        T residual = 0;
+        for(size_t i = 0; i < n; ++i)
+        {
+            residual += (y[i] - lambda * x[i]) * (y[i] - lambda * x[i]);
+            y[i] -= shift * x[i];
+        }
+        result.values[0] = lambda;
+        if(std::sqrt(residual) <= tol * std::abs(lambda))
+        {
+            result.converged = true;
+            break;
+        }
+        norm = std::sqrt(std::inner_product(y.begin(), y.end(), y.begin(), T(0)));
+        if(norm == 0)
+            break;
+        for(size_t i = 0; i < n; ++i)
+            x[i] = y[i] / norm;
+    }
+    std::copy(x.begin(), x.end(), result.vectors.elements().begin());
+    return result;
+}
+
+/**
+ * Block power (subspace) iteration for the k eigenvalues of the largest magnitude. A block of p
+ * vectors is multiplied by A at once, so a pass over the matrix serves all of them and the
+ * products are matrix-matrix rather than matrix-vector ones. Every iteration performs the
+ * Rayleigh-Ritz projection \f$X^T A X = V \Theta V^T\f$, continues with the orthonormalised
+ * \f$A X V\f$ and stops once the residuals of the k leading Ritz pairs are below tol relative to
+ * their values. Converges with the ratio \f$|\lambda_{p+1} / \lambda_k|\f$.
+ *
+ * @tparam T floating point type
+ * @tparam A Matrix, SparseMatrix or block operator op(X, Y, k)
+ * @param a matrix or operator
+ * @param n dimension
+ * @param k number of eigenpairs
+ * @param tol relative tolerance of the residuals
+ * @param max_iterations maximal number of iterations
+ * @param block size of the block p >= k, 0 for k + 8
+ * @param seed seed of the starting block
+ * @return eigenvalues by decreasing magnitude and eigenvectors
+ */
+template <typename T, typename A>
+EigenResult<T> block_power_method(const A &a, size_t n, size_t k, T tol = T(1e-8), size_t max_iterations = 10000,
+                                  size_t block = 0, uint64_t seed = 1)
+{
+    auto op = make_operator(a);
+    const size_t p = std::min(n, block ? block : k + 8);
+    assert(k > 0 && k <= p);
+    EigenResult<T> result = {std::vector<T>(k), Matrix<T>(n, k), 0, false};
+
+    std::vector<T> x(n * p), y(n * p), z(n * p), w(n * p);
+    std::vector<T> h(p * p), v(p * p), sorted(p * p), theta(p), residual(p);
+    std::vector<size_t> order(p);
+    random_vector(x.data(), n * p, seed);
+    block_orthonormalize(x.data(), n, p);
+
+    while(true)
+    {
+        op(x.data(), y.data(), p);
+        block_gram(x.data(), y.data(), n, p, p, h.data());
+        for(size_t i = 0; i < p; ++i)
+            for(size_t j = 0; j < i; ++j)
+                h[i * p + j] = h[j * p + i] = (h[i * p + j] + h[j * p + i]) / 2;
+        symmetric_eigen(p, h.data(), theta.data(), v.data());
+
+        // Ritz pairs by decreasing magnitude
+        std::iota(order.begin(), order.end(), size_t(0));
+        std::sort(order.begin(), order.end(), [&](size_t i, size_t j) {
+            return std::abs(theta[i]) > std::abs(theta[j]);
+        });
+        for(size_t i = 0; i < p; ++i)
+            for(size_t j = 0; j < p; ++j)
+                sorted[i * p + j] = v[i * p + order[j]];
+
+        // Z = A X V and W = X V, the Ritz vectors and their images
+        block_combine(y.data(), sorted.data(), n, p, p, z.data());
+        block_combine(x.data(), sorted.data(), n, p, p, w.data());
+        std::fill(residual.begin(), residual.end(), T(0));
+        for(size_t i = 0; i < n; ++i)
+            for(size_t j = 0; j < k; ++j)
+            {
+                const T r = z[i * p + j] - theta[order[j]] * w[i * p + j];
+                residual[j] += r * r;
+            }
+        ++result.iterations;
+
+        bool converged = true;
+        for(size_t j = 0; j < k; ++j)
+            converged = converged && std::sqrt(residual[j]) <= tol * std::abs(theta[order[j]]);
+        if(converged || result.iterations >= max_iterations)
+        {
+            result.converged = converged;
+            for(size_t j = 0; j < k; ++j)
+                result.values[j] = theta[order[j]];
+            for(size_t i = 0; i < n; ++i)
+                for(size_t j = 0; j < k; ++j)
+                    result.vectors(i, j) = w[i * p + j];
+            return result;
+        }
+
+        x.swap(z);
+        block_orthonormalize(x.data(), n, p);
+    }
+}
+
+/**
+ * Thick-restart Lanczos method for the k largest (or smallest) eigenvalues. A Krylov basis of m
+ * vectors is built with full reorthogonalisation, the Rayleigh-Ritz projection of A onto it is
+ * decomposed and the basis is restarted from the best Ritz vectors and the last Lanczos vector,
+ * which is equivalent to the implicitly restarted Lanczos method with exact shifts. Stops once
+ * the residuals of the k wanted Ritz pairs, \f$|\beta_m y_{m,i}|\f$, are below tol relative to
+ * their values.
+ *
+ * @tparam T floating point type
+ * @tparam A Matrix, SparseMatrix or matrix-free operator
+ * @param a matrix or operator
+ * @param n dimension
+ * @param k number of eigenpairs
+ * @param tol relative tolerance of the residuals
+ * @param largest the largest eigenvalues, otherwise the smallest
+ * @param max_restarts maximal number of restarts
+ * @param basis size of the basis m > k, 0 for max(2k + 1, 40)
+ * @param seed seed of the starting vector
+ * @return eigenvalues from the most wanted and eigenvectors
+ */
+template <typename T, typename A>
+EigenResult<T> lanczos(const A &a, size_t n, size_t k, T tol = T(1e-8), bool largest = true,
+                       size_t max_restarts = 1000, size_t basis = 0, uint64_t seed = 1)
+{
+    auto op = make_operator(a);
+    const size_t m = std::min(n, basis ? basis : std::max<size_t>(2 * k + 1, 40));
+    assert(k > 0 && k <= m);
+    // Ritz vectors kept by a restart
+    const size_t kept = std::min(m - 1, k + (m - k) / 2);
+    EigenResult<T> result = {std::vector<T>(k), Matrix<T>(n, k), 0, false};
+
+    std::vector<T> v((m + 1) * n), restart(m * n);
+    std::vector<T> t(m * m), h(m * m), y(m * m), theta(m), selected(m * m);
+    std::vector<size_t> order(m);
+    random_vector(v.data(), n, seed);
+
+    auto dot = [n](const T *p, const T *q) {
+        T sum = 0;
+        for(size_t i = 0; i < n; ++i)
+            sum += p[i] * q[i];
+        return sum;
+    };
+    // orthogonalises w against the first j vectors twice, returns the accumulated coefficients in h
+    auto orthogonalize = [&](T *w, size_t j, T *coefficients) {
+        std::fill(coefficients, coefficients + j, T(0));
+        for(size_t pass = 0; pass < 2; ++pass)
+            for(size_t i = 0; i < j; ++i)
+            {
+                const T *vi = v.data() + i * n;
+                const T c = dot(vi, w);
+                coefficients[i] += c;
+                for(size_t r = 0; r < n; ++r)
+                    w[r] -= c * vi[r];
+            }
+    };
+
+    T norm = std::sqrt(dot(v.data(), v.data()));
+    for(size_t r = 0; r < n; ++r)
+        v[r] /= norm;
+
+    size_t start = 0;
+    T beta = 0, scale = 0;
+    std::vector<T> column(m + 1);
+    while(true)
+    {
+        for(size_t j = start; j < m; ++j)
+        {
+            T *w = v.data() + (j + 1) * n;
+            op(v.data() + j * n, w);
+            orthogonalize(w, j + 1, column.data());
+            for(size_t i = 0; i <= j; ++i)
+                t[i * m + j] = t[j * m + i] = column[i];
+            scale = std::max(scale, std::abs(column[j]));
+
+            beta = std::sqrt(dot(w, w));
+            if(beta <= std::numeric_limits<T>::epsilon() * scale && j + 1 < m)
+            {
+                // invariant subspace, continue with a random vector orthogonal to the basis
+                random_vector(w, n, seed + j + 1);
+                orthogonalize(w, j + 1, column.data());
+                const T w_norm = std::sqrt(dot(w, w));
+                for(size_t r = 0; r < n; ++r)
+                    w[r] /= w_norm;
+                beta = 0;
+                continue;
+            }
+            for(size_t r = 0; r < n && beta > 0; ++r)
+                w[r] /= beta;
+        }
+        ++result.iterations;
+
+        std::copy(t.begin(), t.end(), h.begin());
+        symmetric_eigen(m, h.data(), theta.data(), y.data());
+        std::iota(order.begin(), order.end(), size_t(0));
+        std::sort(order.begin(), order.end(), [&](size_t i, size_t j) {
+            return largest ? theta[i] > theta[j] : theta[i] < theta[j];
+        });
+
+        bool converged = true;
+        for(size_t i = 0; i < k; ++i)
+            converged = converged && std::abs(beta * y[(m - 1) * m + order[i]]) <= tol * std::abs(theta[order[i]]);
+
+        const size_t l = converged || result.iterations > max_restarts ? k : kept;
+        for(size_t j = 0; j < m; ++j)
+            for(size_t i = 0; i < l; ++i)
+                selected[j * l + i] = y[j * m + order[i]];
+        combine_vectors(v.data(), n, m, selected.data(), l, restart.data());
+
+        if(converged || result.iterations > max_restarts)
+        {
+            result.converged = converged;
+            for(size_t i = 0; i < k; ++i)
+            {
+                result.values[i] = theta[order[i]];
+                for(size_t r = 0; r < n; ++r)
+                    result.vectors(r, i) = restart[i * n + r];
+            }
+            return result;
+        }
+
+        // the basis continues from the kept Ritz vectors and the last Lanczos vector, the
+        // projection is diagonal on the Ritz vectors and its coupling to v_m follows from the
+        // reorthogonalisation of the next step
+        std::copy(restart.begin(), restart.begin() + l * n, v.begin());
+        std::copy(v.begin() + m * n, v.begin() + (m + 1) * n, v.begin() + l * n);
+        std::fill(t.begin(), t.end(), T(0));
+        for(size_t i = 0; i < l; ++i)
+            t[i * m + i] = theta[order[i]];
+        start = l;
+    }
+}
+
 #endif //NUMERICALC_POWER_METHOD_HPP
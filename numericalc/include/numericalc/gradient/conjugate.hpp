@@ -1,10 +1,458 @@
 /**
  * Conjugate Gradient Method.
  *
+ * Solves \f$A x = b\f$ for a symmetric positive definite A given by a dense Matrix, a
+ * SparseMatrix or a matrix-free callable op(x, y) computing \f$y = A x\f$, see
+ * LinearOperator.hpp. A preconditioner is a callable m(r, z) computing \f$z = M^{-1} r\f$.
+ *
  * @file conjugate.hpp
  * Copyright (c) 2020 Peter Grajcar
  */
 #ifndef NUMERICALC_CONJUGATE_HPP
 #define NUMERICALC_CONJUGATE_HPP
 
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+#include <vector>
+#include "numericalc/LinearOperator.hpp"
+#include "numericalc/Matrix.hpp"
+#include "numericalc/SparseMatrix.hpp"
+#include "numericalc/parallel/thread_pool.hpp"
+
+/**
+ * Elements of the vectors processed by one task, the dot products are summed per chunk and the
+ * chunks in order, so the results do not depend on the number of threads.
+ */
+static const size_t conjugate_chunk = 8192;
+
+/**
+ * No preconditioning, \f$z = r\f$.
+ */
+struct IdentityPreconditioner
+{
+    size_t n;
+
+    explicit IdentityPreconditioner(size_t n) : n(n) {}
+
+    template <typename T>
+    inline void operator()(const T *r, T *z) const
+    {
+        std::copy(r, r + n, z);
+    }
+};
+
+/**
+ * Jacobi preconditioner, \f$M = diag(A)\f$.
+ *
+ * @tparam T matrix type
+ */
+template <typename T>
+class JacobiPreconditioner
+{
+    std::vector<T> inverse;
+public:
+    /**
+     *
+     * @param diagonal diagonal of the matrix, all elements non-zero
+     */
+    explicit JacobiPreconditioner(const std::vector<T> &diagonal);
+
+    explicit JacobiPreconditioner(const SparseMatrix<T> &matrix);
+
+    explicit JacobiPreconditioner(const Matrix<T> &matrix);
+
+    void operator()(const T *r, T *z) const;
+};
+
+/**
+ * Symmetric successive over-relaxation preconditioner of a symmetric matrix \f$A = L + D + L^T\f$,
+ * \f$M = \frac{1}{\omega (2 - \omega)} (D + \omega L) D^{-1} (D + \omega L^T)\f$. Applied by a
+ * forward and a backward sweep over the rows, which is sequential.
+ *
+ * @tparam T matrix type
+ */
+template <typename T>
+class SsorPreconditioner
+{
+    SparseMatrix<T> matrix;
+    std::vector<size_t> diagonal;
+    T omega;
+public:
+    /**
+     *
+     * @param matrix symmetric matrix with non-zero diagonal, copied
+     * @param omega relaxation factor in (0, 2)
+     */
+    explicit SsorPreconditioner(const SparseMatrix<T> &matrix, T omega = 1);
+
+    void operator()(const T *r, T *z) const;
+};
+
+/**
+ * Incomplete Cholesky preconditioner IC(0), \f$M = L L^T\f$ where L has the sparsity pattern of the
+ * lower triangle of A. If the factorisation breaks down on a non-positive pivot it is repeated
+ * for \f$A + \alpha\, diag(A)\f$ with increasing \f$\alpha\f$.
+ *
+ * @tparam T matrix type
+ */
+template <typename T>
+class IncompleteCholeskyPreconditioner
+{
+    size_t n;
+    /**
+     * Rows of L in compressed form, the diagonal is the last entry of every row.
+     */
+    std::vector<size_t> offsets;
+    std::vector<size_t> columns;
+    std::vector<T> values;
+    T alpha;
+
+    bool factorize(const SparseMatrix<T> &matrix, T shift);
+public:
+    /**
+     *
+     * @param matrix symmetric positive definite matrix
+     */
+    explicit IncompleteCholeskyPreconditioner(const SparseMatrix<T> &matrix);
+
+    /**
+     *
+     * @return diagonal shift \f$\alpha\f$ needed by the factorisation, zero if none
+     */
+    inline T shift() const
+    {
+        return alpha;
+    }
+
+    void operator()(const T *r, T *z) const;
+};
+
+/**
+ * Result of an iterative solver.
+ *
+ * @tparam T floating point type
+ */
+template <typename T>
+struct ConjugateGradientResult
+{
+    size_t iterations;
+    /**
+     * Norm of the final residual \f$\|b - A x\|_2\f$, as updated by the iteration unless
+     * converged, then computed from x.
+     */
+    T residual;
+    bool converged;
+};
+
+/**
+ * Preconditioned conjugate gradient solver for systems of fixed size. The vectors of the
+ * iteration are allocated once and reused by every solve, the solver holds no other state. The vector operations
+ * are fused into as few passes as possible and split into chunks of conjugate_chunk elements
+ * across the thread pool.
+ *
+ * The residual updated by the recurrences drifts away from \f$b - A x\f$ in floating point.
+ * When it reaches the tolerance the residual is computed from x, if it is still above the
+ * tolerance the iteration restarts from x with the computed residual (residual replacement).
+ *
+ * @tparam T floating point type
+ */
+template <typename T>
+class ConjugateGradient
+{
+    size_t n;
+    bool parallel;
+    /**
+     * Vectors of the iteration stored one after another, four for solve and nine for
+     * solve_pipelined if requested by the constructor.
+     */
+    std::vector<T> work;
+    std::vector<T> partial;
+
+    template <typename F>
+    void for_chunks(F f)
+    {
+        auto block = [&](size_t lo, size_t hi) {
+            for(size_t c = lo; c < hi; ++c)
+                f(c * conjugate_chunk, std::min(n, (c + 1) * conjugate_chunk), c);
+        };
+        const size_t chunks = (n + conjugate_chunk - 1) / conjugate_chunk;
+        if(parallel && chunks > 1)
+            parallel_for(0, chunks, 1, block);
+        else
+            block(0, chunks);
+    }
+
+    /*
+     * Sums the K partial sums f(lo, hi, sums) of the chunks in chunk order.
+     */
+    template <size_t K, typename F>
+    void reduce(F f, T *sums)
+    {
+        for_chunks([&](size_t lo, size_t hi, size_t c) {
+            f(lo, hi, partial.data() + K * c);
+        });
+        std::fill(sums, sums + K, T(0));
+        for(size_t c = 0; c * conjugate_chunk < n; ++c)
+            for(size_t k = 0; k < K; ++k)
+                sums[k] += partial[K * c + k];
+    }
+
+    T dot(const T *a, const T *b)
+    {
+        T sum;
+        reduce<1>([a, b](size_t lo, size_t hi, T *out) {
+            T s = 0;
+            for(size_t i = lo; i < hi; ++i)
+                s += a[i] * b[i];
+            out[0] = s;
+        }, &sum);
+        return sum;
+    }
+public:
+    /**
+     *
+     * @param n size of the system
+     * @param parallel split the vector operations across the thread pool
+     * @param pipelined allocate the vectors of solve_pipelined
+     */
+    explicit ConjugateGradient(size_t n, bool parallel = true, bool pipelined = false)
+        : n(n), parallel(parallel), work((pipelined ? 9 : 4) * n),
+          partial(3 * ((n + conjugate_chunk - 1) / conjugate_chunk))
+    {
+    }
+
+    /**
+     * Solves \f$A x = b\f$ by the preconditioned conjugate gradient method until
+     * \f$\|r\| \le \max(rtol \|b\|, atol)\f$.
+     *
+     * @tparam A operator
+     * @tparam M preconditioner
+     * @param a operator \f$y = A x\f$
+     * @param precondition preconditioner \f$z = M^{-1} r\f$
+     * @param b right hand side
+     * @param x initial guess, replaced by the solution
+     * @param rtol relative tolerance
+     * @param atol absolute tolerance
+     * @param max_iterations maximal number of iterations, 0 for 10 n
+     * @return iterations and residual
+     */
+    template <typename A, typename M>
+    ConjugateGradientResult<T> solve(const A &a, const M &precondition, const T *b, T *x, T rtol = T(1e-8),
+                                     T atol = T(0), size_t max_iterations = 0)
+    {
+        T *const r = work.data(), *const z = r + n, *const p = z + n, *const q = p + n;
+        ConjugateGradientResult<T> result = {0, 0, false};
+        const T tolerance = std::max(rtol * std::sqrt(dot(b, b)), atol);
+        max_iterations = max_iterations ? max_iterations : 10 * n;
+
+        // r = b - A x, p = z = M r, also replaces the updated residual by the computed one
+        T rr, rz;
+        auto start = [&]() {
+            a(x, q);
+            for_chunks([=](size_t lo, size_t hi, size_t) {
+                for(size_t i = lo; i < hi; ++i)
+                    r[i] = b[i] - q[i];
+            });
+            precondition(r, z);
+            std::copy(z, z + n, p);
+            rr = dot(r, r);
+            rz = dot(r, z);
+        };
+        start();
+        bool restarted = true;
+
+        while(true)
+        {
+            result.residual = std::sqrt(rr);
+            if(result.residual <= tolerance)
+            {
+                if(!restarted)
+                {
+                    start();
+                    restarted = true;
+                    continue;
+                }
+                result.converged = true;
+                break;
+            }
+            if(result.iterations == max_iterations)
+                break;
+            ++result.iterations;
+
+            a(p, q);
+            const T alpha = rz / dot(p, q);
+            reduce<1>([=](size_t lo, size_t hi, T *out) {
+                T s = 0;
+                for(size_t i = lo; i < hi; ++i)
+                {
+                    x[i] += alpha * p[i];
+                    r[i] -= alpha * q[i];
+                    s += r[i] * r[i];
+                }
+                out[0] = s;
+            }, &rr);
+
+            precondition(r, z);
+            const T previous = rz;
+            rz = dot(r, z);
+            const T beta = rz / previous;
+            for_chunks([=](size_t lo, size_t hi, size_t) {
+                for(size_t i = lo; i < hi; ++i)
+                    p[i] = z[i] + beta * p[i];
+            });
+            restarted = false;
+        }
+        return result;
+    }
+
+    /**
+     * Solves \f$A x = b\f$ by the pipelined preconditioned conjugate gradient method of Ghysels
+     * and Vanroose. The three dot products of an iteration are computed by a single reduction
+     * instead of the two dependent reductions of solve, and the vector updates are fused into one
+     * pass. The reduction does not depend on the preconditioner and the operator applied in the
+     * same iteration, so a non-blocking reduction could overlap with them, here they run one after
+     * another. It needs five more vectors, the solver has to be constructed with pipelined set.
+     * The recurrences drift faster than those of solve, so the residual is replaced more often.
+     *
+     * @see solve
+     */
+    template <typename A, typename M>
+    ConjugateGradientResult<T> solve_pipelined(const A &a, const M &precondition, const T *b, T *x,
+                                               T rtol = T(1e-8), T atol = T(0), size_t max_iterations = 0)
+    {
+        assert(work.size() == 9 * n);
+        T *const r = work.data(), *const z = r + n, *const p = z + n, *const q = p + n;
+        T *const w = q + n, *const u = w + n, *const m = u + n, *const v = m + n, *const s = v + n;
+        ConjugateGradientResult<T> result = {0, 0, false};
+        const T tolerance = std::max(rtol * std::sqrt(dot(b, b)), atol);
+        max_iterations = max_iterations ? max_iterations : 10 * n;
+
+        // r = b - A x, u = M r, w = A u, z = q = s = p = 0 so that beta = 0 starts the recurrences,
+        // also replaces the updated residual by the computed one
+        auto start = [&]() {
+            a(x, q);
+            for_chunks([=](size_t lo, size_t hi, size_t) {
+                for(size_t i = lo; i < hi; ++i)
+                    r[i] = b[i] - q[i];
+            });
+            precondition(r, u);
+            a(u, w);
+            std::fill(z, z + 3 * n, T(0));
+            std::fill(s, s + n, T(0));
+        };
+        start();
+        bool restarted = true;
+
+        T gamma_previous = 1, alpha_previous = 1;
+        while(true)
+        {
+            T dots[3];
+            reduce<3>([=](size_t lo, size_t hi, T *out) {
+                T ru = 0, wu = 0, rr = 0;
+                for(size_t i = lo; i < hi; ++i)
+                {
+                    ru += r[i] * u[i];
+                    wu += w[i] * u[i];
+                    rr += r[i] * r[i];
+                }
+                out[0] = ru;
+                out[1] = wu;
+                out[2] = rr;
+            }, dots);
+            const T gamma = dots[0], delta = dots[1];
+            result.residual = std::sqrt(dots[2]);
+            if(result.residual <= tolerance)
+            {
+                if(!restarted)
+                {
+                    start();
+                    restarted = true;
+                    continue;
+                }
+                result.converged = true;
+                break;
+            }
+            if(result.iterations == max_iterations)
+                break;
+
+            precondition(w, m);
+            a(m, v);
+
+            const T beta = restarted ? T(0) : gamma / gamma_previous;
+            const T alpha = gamma / (delta - beta * gamma / alpha_previous);
+            for_chunks([=](size_t lo, size_t hi, size_t) {
+                for(size_t i = lo; i < hi; ++i)
+                {
+                    z[i] = v[i] + beta * z[i];
+                    q[i] = m[i] + beta * q[i];
+                    s[i] = w[i] + beta * s[i];
+                    p[i] = u[i] + beta * p[i];
+                    x[i] += alpha * p[i];
+                    r[i] -= alpha * s[i];
+                    u[i] -= alpha * q[i];
+                    w[i] -= alpha * z[i];
+                }
+            });
+            gamma_previous = gamma;
+            alpha_previous = alpha;
+            restarted = false;
+            ++result.iterations;
+        }
+        return result;
+    }
+};
+
+/**
+ * Solves \f$A x = b\f$ by the preconditioned conjugate gradient method.
+ *
+ * @tparam T floating point type
+ * @tparam A Matrix, SparseMatrix or matrix-free operator
+ * @tparam M preconditioner
+ * @param a matrix or operator
+ * @param precondition preconditioner
+ * @param b right hand side
+ * @param x initial guess, replaced by the solution
+ * @param rtol relative tolerance
+ * @param atol absolute tolerance
+ * @param pipelined use the pipelined variant, see ConjugateGradient::solve_pipelined
+ * @return iterations and residual
+ */
+template <typename T, typename A, typename M>
+ConjugateGradientResult<T> conjugate_gradient(const A &a, const M &precondition, const std::vector<T> &b,
+                                              std::vector<T> &x, T rtol = T(1e-8), T atol = T(0),
+                                              bool pipelined = false)
+{
+    assert(x.size() == b.size());
+    ConjugateGradient<T> solver(b.size(), true, pipelined);
+    if(pipelined)
+        return solver.solve_pipelined(make_operator(a), precondition, b.data(), x.data(), rtol, atol);
+    return solver.solve(make_operator(a), precondition, b.data(), x.data(), rtol, atol);
+}
+
+/**
+ * Solves \f$A x = b\f$ by the Jacobi preconditioned conjugate gradient method.
+ *
+ * @see conjugate_gradient
+ */
+template <typename T>
+ConjugateGradientResult<T> conjugate_gradient(const SparseMatrix<T> &a, const std::vector<T> &b, std::vector<T> &x,
+                                              T rtol = T(1e-8), T atol = T(0))
+{
+    return conjugate_gradient(a, JacobiPreconditioner<T>(a), b, x, rtol, atol);
+}
+
+/**
+ * Solves \f$A x = b\f$ by the Jacobi preconditioned conjugate gradient method.
+ *
+ * @see conjugate_gradient
+ */
+template <typename T>
+ConjugateGradientResult<T> conjugate_gradient(const Matrix<T> &a, const std::vector<T> &b, std::vector<T> &x,
+                                              T rtol = T(1e-8), T atol = T(0))
+{
+    return conjugate_gradient(a, JacobiPreconditioner<T>(a), b, x, rtol, atol);
+}
+
 #endif //NUMERICALC_CONJUGATE_HPP
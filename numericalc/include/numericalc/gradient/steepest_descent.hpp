@@ -1,10 +1,370 @@
 /**
  * Steepest Descent Method.
  *
+ * Unconstrained minimisation by line search methods, steepest descent, nonlinear conjugate
+ * gradient and limited-memory BFGS. The objective is a callable fg(x, g) returning
+ * \f$f(x)\f$ and writing the gradient \f$\nabla f(x)\f$ to g, so that the shared work of the two
+ * is done once.
+ *
  * @file steepest_descent.hpp
  * Copyright (c) 2020 Peter Grajcar
  */
 #ifndef NUMERICALC_STEEPEST_DESCENT_HPP
 #define NUMERICALC_STEEPEST_DESCENT_HPP
 
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+/**
+ * Curvature pairs \f$s_k = x_{k+1} - x_k\f$, \f$y_k = \nabla f_{k+1} - \nabla f_k\f$ of the last m
+ * iterations in a ring buffer, the limited-memory approximation of the inverse Hessian.
+ *
+ * @tparam T floating point type
+ */
+template <typename T>
+class LbfgsMemory
+{
+    size_t n, m;
+    size_t head, count;
+    std::vector<T> s, y;
+    std::vector<T> rho, alpha;
+public:
+    /**
+     *
+     * @param n dimension
+     * @param m number of pairs kept
+     */
+    LbfgsMemory(size_t n, size_t m);
+
+    /**
+     * Forgets all pairs.
+     */
+    void clear();
+
+    inline size_t size() const
+    {
+        return count;
+    }
+
+    /**
+     * Stores a pair, overwriting the oldest one when full. A pair with \f$s^T y\f$ not
+     * sufficiently positive would break the positive definiteness and is skipped.
+     *
+     * @param step \f$s_k\f$
+     * @param change \f$y_k\f$
+     * @return whether the pair was stored
+     */
+    bool push(const T *step, const T *change);
+
+    /**
+     * Computes the search direction \f$d = -H g\f$ by the two-loop recursion, the initial
+     * matrix is \f$H_0 = \frac{s^T y}{y^T y} I\f$ of the newest pair. Does not allocate.
+     *
+     * @param g gradient
+     * @param d direction, may not alias g
+     */
+    void direction(const T *g, T *d);
+};
+
+/**
+ * Minimiser of the cubic interpolating the values and derivatives at a and b, used by the line
+ * search. Returns the midpoint if the cubic has no minimum.
+ *
+ * @tparam T floating point type
+ * @param a first point
+ * @param fa value at a
+ * @param da derivative at a
+ * @param b second point
+ * @param fb value at b
+ * @param db derivative at b
+ * @return minimiser
+ */
+template <typename T>
+T cubic_minimizer(T a, T fa, T da, T b, T fb, T db);
+
+enum class DescentMethod
+{
+    steepest_descent,
+    /**
+     * Nonlinear conjugate gradient, Polak-Ribiere with restarts.
+     */
+    conjugate_gradient,
+    lbfgs
+};
+
+/**
+ * Result of a minimisation.
+ *
+ * @tparam T floating point type
+ */
+template <typename T>
+struct MinimizationResult
+{
+    T value;
+    /**
+     * Maximum norm of the final gradient.
+     */
+    T gradient;
+    size_t iterations;
+    size_t evaluations;
+    bool converged;
+};
+
+/**
+ * Line search minimiser for problems of fixed dimension. The vectors of the iteration and the
+ * L-BFGS memory are allocated by the constructor, an iteration performs no allocation.
+ *
+ * The step length satisfies the strong Wolfe conditions
+ * \f$f(x + \alpha d) \le f(x) + c_1 \alpha \nabla f^T d\f$ and
+ * \f$|\nabla f(x + \alpha d)^T d| \le c_2 |\nabla f^T d|\f$,
+ * found by bracketing and cubic interpolation (Nocedal and Wright, algorithms 3.5 and 3.6).
+ *
+ * @tparam T floating point type
+ */
+template <typename T>
+class GradientDescent
+{
+    static constexpr double c1 = 1e-4;
+    static const size_t max_line_search = 30;
+
+    size_t n;
+    LbfgsMemory<T> memory;
+    std::vector<T> g, d, x_new, g_new, s;
+
+    static T dot(const T *a, const T *b, size_t n)
+    {
+        T sum = 0;
+        for(size_t i = 0; i < n; ++i)
+            sum += a[i] * b[i];
+        return sum;
+    }
+
+    /*
+     * Evaluates x_new = x + alpha d, returns the directional derivative.
+     */
+    template <typename F>
+    T evaluate(F &fg, const T *x, T alpha, T &f, size_t &evaluations)
+    {
+        for(size_t i = 0; i < n; ++i)
+            x_new[i] = x[i] + alpha * d[i];
+        f = fg(x_new.data(), g_new.data());
+        ++evaluations;
+        return dot(g_new.data(), d.data(), n);
+    }
+
+    /*
+     * Finds a step satisfying the strong Wolfe conditions from the initial guess alpha, the
+     * accepted point is left in x_new and g_new. Returns zero if none was found.
+     */
+    template <typename F>
+    T line_search(F &fg, const T *x, T f0, T slope0, T alpha, T c2, T &f, size_t &evaluations)
+    {
+        T lo = 0, f_lo = f0, d_lo = slope0;
+        T hi = 0, f_hi = 0, d_hi = 0;
+        bool bracketed = false;
+
+        for(size_t k = 0; k < max_line_search; ++k)
+        {
+            if(bracketed)
+            {
+                // safeguarded cubic step inside the bracket
+                const T width = hi - lo;
+                alpha = cubic_minimizer(lo, f_lo, d_lo, hi, f_hi, d_hi);
+                const T a = std::min(lo, hi) + T(0.1) * std::abs(width), b = std::max(lo, hi) - T(0.1) * std::abs(width);
+                alpha = std::min(std::max(alpha, a), b);
+            }
+            const T slope = evaluate(fg, x, alpha, f, evaluations);
+
+            if(f > f0 + T(c1) * alpha * slope0 || f >= f_lo)
+            {
+                hi = alpha;
+                f_hi = f;
+                d_hi = slope;
+                bracketed = true;
+                continue;
+            }
+            if(std::abs(slope) <= -c2 * slope0)
+                return alpha;
+            if(slope * (alpha - lo) >= 0)
+            {
+                hi = lo;
+                f_hi = f_lo;
+                d_hi = d_lo;
+                bracketed = true;
+            }
+            lo = alpha;
+            f_lo = f;
+            d_lo = slope;
+            // extrapolate until the minimum is bracketed
+            if(!bracketed)
+                alpha *= 4;
+        }
+        // the best point found is accepted if it decreased the function
+        if(lo > 0)
+        {
+            evaluate(fg, x, lo, f, evaluations);
+            return lo;
+        }
+        return 0;
+    }
+public:
+    /**
+     *
+     * @param n dimension
+     * @param memory number of curvature pairs kept by L-BFGS
+     */
+    explicit GradientDescent(size_t n, size_t memory = 10)
+        : n(n), memory(n, memory), g(n), d(n), x_new(n), g_new(n), s(n)
+    {
+    }
+
+    /**
+     * Minimises fg from x until \f$\|\nabla f\|_\infty \le gtol\f$ or the relative decrease of
+     * f in an iteration falls below ftol.
+     *
+     * @tparam F objective
+     * @param fg objective returning \f$f(x)\f$ and writing \f$\nabla f(x)\f$ to its second argument
+     * @param x starting point, replaced by the minimiser
+     * @param method descent method
+     * @param gtol gradient tolerance
+     * @param ftol relative function tolerance
+     * @param max_iterations maximal number of iterations
+     * @return value, gradient norm and counters
+     */
+    template <typename F>
+    MinimizationResult<T> minimize(F fg, T *x, DescentMethod method = DescentMethod::lbfgs, T gtol = T(1e-6),
+                                   T ftol = 16 * std::numeric_limits<T>::epsilon(), size_t max_iterations = 1000)
+    {
+        MinimizationResult<T> result = {0, 0, 0, 1, false};
+        memory.clear();
+        T f = fg(x, g.data());
+        // Wolfe curvature constant, a loose one suits quasi-Newton directions
+        const T c2 = method == DescentMethod::conjugate_gradient ? T(0.1) : T(0.9);
+        T previous_slope = 0, previous_alpha = 0;
+        bool restart = true;
+
+        while(true)
+        {
+            T norm = 0;
+            for(size_t i = 0; i < n; ++i)
+                norm = std::max(norm, std::abs(g[i]));
+            result.value = f;
+            result.gradient = norm;
+            if(norm <= gtol)
+            {
+                result.converged = true;
+                return result;
+            }
+            if(result.iterations == max_iterations)
+                return result;
+
+            if(method == DescentMethod::lbfgs && memory.size() > 0)
+                memory.direction(g.data(), d.data());
+            else if(method == DescentMethod::conjugate_gradient && !restart)
+            {
+                // d = -g + beta d with beta = max(0, g^T (g - g_old) / g_old^T g_old), g_old in s
+                const T beta = std::max(T(0), (dot(g.data(), g.data(), n) - dot(g.data(), s.data(), n)) / dot(s.data(), s.data(), n));
+                for(size_t i = 0; i < n; ++i)
+                    d[i] = beta * d[i] - g[i];
+            }
+            else
+                for(size_t i = 0; i < n; ++i)
+                    d[i] = -g[i];
+
+            T slope = dot(g.data(), d.data(), n);
+            if(!(slope < 0))
+            {
+                // not a descent direction, restart from the gradient
+                memory.clear();
+                for(size_t i = 0; i < n; ++i)
+                    d[i] = -g[i];
+                slope = dot(g.data(), d.data(), n);
+            }
+
+            // unit step for quasi-Newton directions, otherwise the same first-order change as the
+            // last step, the first step moves by at most one in the maximum norm
+            T alpha;
+            if(method == DescentMethod::lbfgs && memory.size() > 0)
+                alpha = 1;
+            else if(previous_alpha > 0)
+                alpha = previous_alpha * previous_slope / slope;
+            else
+                alpha = std::min(T(1), T(1) / norm);
+
+            T f_new;
+            alpha = line_search(fg, x, f, slope, alpha, c2, f_new, result.evaluations);
+            if(alpha == 0)
+            {
+                if(restart)
+                    return result;
+                // retry once from the steepest descent direction
+                memory.clear();
+                restart = true;
+                previous_alpha = 0;
+                continue;
+            }
+            ++result.iterations;
+
+            for(size_t i = 0; i < n; ++i)
+            {
+                s[i] = x_new[i] - x[i];
+                x[i] = x_new[i];
+            }
+            if(method == DescentMethod::lbfgs)
+            {
+                // the change of the gradient overwrites g_new, g is replaced below
+                for(size_t i = 0; i < n; ++i)
+                    g_new[i] -= g[i];
+                memory.push(s.data(), g_new.data());
+                for(size_t i = 0; i < n; ++i)
+                    g[i] += g_new[i];
+            }
+            else
+            {
+                // the old gradient is kept in s for the conjugate gradient coefficient
+                std::copy(g.begin(), g.end(), s.begin());
+                std::copy(g_new.begin(), g_new.end(), g.begin());
+            }
+
+            const T decrease = f - f_new;
+            f = f_new;
+            previous_slope = slope;
+            previous_alpha = alpha;
+            restart = method == DescentMethod::conjugate_gradient && result.iterations % n == 0;
+            if(decrease <= ftol * std::max(std::max(std::abs(f), std::abs(f + decrease)), T(1)))
+            {
+                T last = 0;
+                for(size_t i = 0; i < n; ++i)
+                    last = std::max(last, std::abs(g[i]));
+                result.value = f;
+                result.gradient = last;
+                result.converged = last <= gtol;
+                return result;
+            }
+        }
+    }
+};
+
+template <typename T>
+constexpr double GradientDescent<T>::c1;
+template <typename T>
+const size_t GradientDescent<T>::max_line_search;
+
+/**
+ * Minimises fg from x.
+ *
+ * @see GradientDescent::minimize
+ */
+template <typename T, typename F>
+MinimizationResult<T> minimize(F fg, std::vector<T> &x, DescentMethod method = DescentMethod::lbfgs,
+                               T gtol = T(1e-6), size_t max_iterations = 1000)
+{
+    GradientDescent<T> optimizer(x.size());
+    return optimizer.minimize(fg, x.data(), method, gtol, 16 * std::numeric_limits<T>::epsilon(), max_iterations);
+}
+
 #endif //NUMERICALC_STEEPEST_DESCENT_HPP
@@ -0,0 +1,368 @@
+/**
+ * Monte Carlo and quasi-Monte Carlo integration over boxes in many dimensions.
+ *
+ * The integrand is a callable f(x, y, count) evaluating count points into y at once, point p is
+ * stored as x[p * d] .. x[p * d + d - 1].
+ *
+ * @file monte_carlo.hpp
+ * Copyright (c) 2020 Peter Grajcar
+ */
+#ifndef NUMERICALC_MONTE_CARLO_HPP
+#define NUMERICALC_MONTE_CARLO_HPP
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include "numericalc/parallel/thread_pool.hpp"
+
+/**
+ * Points generated and evaluated together.
+ */
+static const size_t monte_carlo_block = 256;
+
+/**
+ * Independent randomisations of a quasi-Monte Carlo estimate, the error is estimated from their
+ * spread.
+ */
+static const size_t monte_carlo_replicates = 8;
+
+/**
+ * Output function of SplitMix64, a bijection of 64 bit words.
+ *
+ * @param z word
+ * @return mixed word
+ */
+inline uint64_t splitmix_mix(uint64_t z)
+{
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Counter-based random number generator, the output of SplitMix64 started from the hashed key
+ * after counter steps. Any element of any stream is computed directly, so the numbers do not
+ * depend on how the work is split between threads. The key is hashed, otherwise stream key + 1
+ * would be stream key shifted by one step.
+ *
+ * @param key stream
+ * @param counter position in the stream
+ * @return 64 random bits
+ */
+inline uint64_t counter_random(uint64_t key, uint64_t counter)
+{
+    return splitmix_mix(splitmix_mix(key) + (counter + 1) * 0x9e3779b97f4a7c15ull);
+}
+
+/**
+ * Sobol sequence in base 2. Direction numbers are derived from the primitive polynomials over
+ * GF(2) in increasing order, the initial direction numbers of each dimension are odd numbers
+ * drawn by counter_random. The scrambled sequence applies a hash-based nested uniform (Owen)
+ * scramble to every coordinate.
+ *
+ * @tparam T floating point type
+ */
+template <typename T>
+class SobolSequence
+{
+    size_t dimension;
+    std::vector<uint32_t> direction;
+    std::vector<uint32_t> seeds;
+    bool scrambled;
+public:
+    static const size_t max_dimension = 1024;
+
+    /**
+     * Constructs the unscrambled sequence.
+     *
+     * @param dimension dimension of the points
+     */
+    explicit SobolSequence(size_t dimension);
+
+    /**
+     * Constructs a scrambled sequence.
+     *
+     * @param dimension dimension of the points
+     * @param seed seed of the scramble
+     */
+    SobolSequence(size_t dimension, uint64_t seed);
+
+    /**
+     * Generates points first .. first + count - 1 of the sequence in [0, 1)^d.
+     *
+     * @param first index of the first point, first + count must not exceed 2^32
+     * @param count number of points
+     * @param x points, count times dimension values
+     */
+    void generate(uint64_t first, size_t count, T *x) const;
+
+    inline size_t get_dimension() const
+    {
+        return dimension;
+    }
+};
+
+/**
+ * Halton sequence, radical inverses in the first d prime bases. The scrambled sequence permutes
+ * the digits of every base by a random permutation fixing zero and shifts the points by a
+ * random vector modulo 1.
+ *
+ * @tparam T floating point type
+ */
+template <typename T>
+class HaltonSequence
+{
+    size_t dimension;
+    std::vector<uint32_t> bases;
+    std::vector<std::vector<uint32_t>> permutations;
+    std::vector<double> shift;
+public:
+    /**
+     * Constructs the unscrambled sequence.
+     *
+     * @param dimension dimension of the points
+     */
+    explicit HaltonSequence(size_t dimension);
+
+    /**
+     * Constructs a scrambled sequence.
+     *
+     * @param dimension dimension of the points
+     * @param seed seed of the scramble
+     */
+    HaltonSequence(size_t dimension, uint64_t seed);
+
+    /**
+     * Generates points first .. first + count - 1 of the sequence in [0, 1)^d.
+     *
+     * @param first index of the first point
+     * @param count number of points
+     * @param x points, count times dimension values
+     */
+    void generate(uint64_t first, size_t count, T *x) const;
+
+    inline size_t get_dimension() const
+    {
+        return dimension;
+    }
+};
+
+/**
+ * Uniform pseudo-random points, coordinate j of point i is given by counter_random(seed,
+ * i * d + j).
+ *
+ * @tparam T floating point type
+ */
+template <typename T>
+class RandomSequence
+{
+    size_t dimension;
+    uint64_t seed;
+public:
+    /**
+     *
+     * @param dimension dimension of the points
+     * @param seed key of the stream
+     */
+    RandomSequence(size_t dimension, uint64_t seed);
+
+    /**
+     * Generates points first .. first + count - 1 of the stream in [0, 1)^d.
+     *
+     * @param first index of the first point
+     * @param count number of points
+     * @param x points, count times dimension values
+     */
+    void generate(uint64_t first, size_t count, T *x) const;
+
+    inline size_t get_dimension() const
+    {
+        return dimension;
+    }
+};
+
+enum class SamplingMethod
+{
+    monte_carlo,
+    sobol,
+    halton
+};
+
+/**
+ * Result of a Monte Carlo integration.
+ *
+ * @tparam T floating point type
+ */
+template <typename T>
+struct MonteCarloResult
+{
+    T value;
+    /**
+     * Estimate of the standard error.
+     */
+    T error;
+    size_t evaluations;
+};
+
+/**
+ * Integrates f over the box by the points of the given sequences, one independent estimate per
+ * sequence. The number of points per sequence doubles every round, which keeps the Sobol
+ * points balanced, until the error estimate is below \f$\max(atol, rtol |I|)\f$ or max_points
+ * points were evaluated. A round is split into blocks of monte_carlo_block points of one
+ * sequence, every block is generated, evaluated and summed on its own and the block sums are
+ * combined in block order, so the result does not depend on the number of threads.
+ *
+ * With a single sequence the error is the standard error of the sample, otherwise the standard
+ * error of the mean of the sequence estimates.
+ *
+ * @tparam T floating point type
+ * @tparam S point sequence
+ * @tparam F integrand
+ * @param f integrand
+ * @param sequences point sequences in [0, 1)^d
+ * @param lower lower corner of the box
+ * @param upper upper corner of the box
+ * @param atol absolute tolerance
+ * @param rtol relative tolerance
+ * @param max_points maximal number of evaluations
+ * @param parallel distribute the blocks across the thread pool
+ * @return integral with the error estimate
+ */
+template <typename T, typename S, typename F>
+MonteCarloResult<T> integrate_sequences(F &f, const std::vector<S> &sequences, const std::vector<T> &lower,
+                                        const std::vector<T> &upper, T atol, T rtol, size_t max_points,
+                                        bool parallel)
+{
+    // mean and sum of squared deviations of count samples
+    struct Moments
+    {
+        T mean, m2;
+        size_t count;
+    };
+
+    const size_t d = lower.size(), R = sequences.size();
+    assert(d > 0 && upper.size() == d && R > 0);
+    T volume = 1;
+    for(size_t j = 0; j < d; ++j)
+        volume *= upper[j] - lower[j];
+
+    const size_t limit = std::max<size_t>(max_points / R, 2);
+    std::vector<Moments> total(R, Moments{0, 0, 0});
+    std::vector<Moments> partial;
+    MonteCarloResult<T> result = {0, 0, 0};
+    size_t n = 0, next = std::min<size_t>(4 * monte_carlo_block, limit);
+
+    while(true)
+    {
+        const size_t blocks = (next - n + monte_carlo_block - 1) / monte_carlo_block, tasks = R * blocks;
+        partial.assign(tasks, Moments{0, 0, 0});
+        auto run = [&](size_t lo, size_t hi) {
+            std::vector<T> x(monte_carlo_block * d), y(monte_carlo_block);
+            for(size_t task = lo; task < hi; ++task)
+            {
+                const size_t r = task / blocks, first = n + (task % blocks) * monte_carlo_block;
+                const size_t count = std::min(monte_carlo_block, next - first);
+                sequences[r].generate(first, count, x.data());
+                for(size_t p = 0; p < count; ++p)
+                    for(size_t j = 0; j < d; ++j)
+                        x[p * d + j] = lower[j] + (upper[j] - lower[j]) * x[p * d + j];
+                f(x.data(), y.data(), count);
+
+                T mean = 0, m2 = 0;
+                for(size_t p = 0; p < count; ++p)
+                    mean += y[p];
+                mean /= (T) count;
+                for(size_t p = 0; p < count; ++p)
+                    m2 += (y[p] - mean) * (y[p] - mean);
+                partial[task] = Moments{mean, m2, count};
+            }
+        };
+        if(parallel)
+            parallel_for(0, tasks, std::max<size_t>(1, tasks / (4 * (ThreadPool::instance().size() + 1))), run);
+        else
+            run(0, tasks);
+
+        // pairwise update of the moments in block order
+        for(size_t task = 0; task < tasks; ++task)
+        {
+            Moments &a = total[task / blocks];
+            const Moments &b = partial[task];
+            const size_t count = a.count + b.count;
+            const T delta = b.mean - a.mean;
+            a.mean += delta * (T) b.count / (T) count;
+            a.m2 += b.m2 + delta * delta * (T) a.count * (T) b.count / (T) count;
+            a.count = count;
+        }
+        n = next;
+
+        T value = 0, spread = 0;
+        for(size_t r = 0; r < R; ++r)
+            value += total[r].mean;
+        value /= (T) R;
+        if(R > 1)
+        {
+            for(size_t r = 0; r < R; ++r)
+                spread += (total[r].mean - value) * (total[r].mean - value);
+            spread = std::sqrt(spread / (T) (R - 1) / (T) R);
+        }
+        else
+            spread = std::sqrt(total[0].m2 / (T) (n - 1) / (T) n);
+
+        result.value = volume * value;
+        result.error = std::abs(volume) * spread;
+        result.evaluations = n * R;
+        if(n >= limit || result.error <= std::max(atol, rtol * std::abs(result.value)))
+            return result;
+        next = std::min(2 * n, limit);
+    }
+}
+
+/**
+ * Integrates f over the box [lower, upper]. Quasi-Monte Carlo methods average
+ * monte_carlo_replicates independently scrambled sequences, plain Monte Carlo uses a single
+ * pseudo-random stream. See integrate_sequences.
+ *
+ * @tparam T floating point type
+ * @tparam F integrand
+ * @param f integrand
+ * @param lower lower corner of the box
+ * @param upper upper corner of the box
+ * @param method sampling method
+ * @param atol absolute tolerance
+ * @param rtol relative tolerance
+ * @param max_points maximal number of evaluations
+ * @param seed seed of the randomisation, the result is reproducible for a given seed
+ * @param parallel distribute the work across the thread pool
+ * @return integral with the error estimate
+ */
+template <typename T, typename F>
+MonteCarloResult<T> monte_carlo(F f, const std::vector<T> &lower, const std::vector<T> &upper,
+                                SamplingMethod method = SamplingMethod::sobol, T atol = T(0), T rtol = T(1e-4),
+                                size_t max_points = size_t(1) << 24, uint64_t seed = 0, bool parallel = true)
+{
+    const size_t d = lower.size();
+    if(method == SamplingMethod::monte_carlo)
+    {
+        std::vector<RandomSequence<T>> stream(1, RandomSequence<T>(d, seed));
+        return integrate_sequences(f, stream, lower, upper, atol, rtol, max_points, parallel);
+    }
+    if(method == SamplingMethod::sobol)
+    {
+        // the unscrambled sequence has at most 2^32 points
+        max_points = std::min<uint64_t>(max_points, (uint64_t) monte_carlo_replicates << 32);
+        std::vector<SobolSequence<T>> sobol;
+        for(size_t r = 0; r < monte_carlo_replicates; ++r)
+            sobol.push_back(SobolSequence<T>(d, counter_random(seed, r)));
+        return integrate_sequences(f, sobol, lower, upper, atol, rtol, max_points, parallel);
+    }
+    std::vector<HaltonSequence<T>> halton;
+    for(size_t r = 0; r < monte_carlo_replicates; ++r)
+        halton.push_back(HaltonSequence<T>(d, counter_random(seed, r)));
+    return integrate_sequences(f, halton, lower, upper, atol, rtol, max_points, parallel);
+}
+
+#endif //NUMERICALC_MONTE_CARLO_HPP
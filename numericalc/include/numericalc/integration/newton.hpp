@@ -1,10 +1,246 @@
 /**
+ * Numerical integration by Newton-Cotes and Gauss-Kronrod rules.
  *
+ * The integrand is a callable f(x, y, count) evaluating count abscissae x into y at once, so
+ * that it can vectorise the evaluation or share work between the points.
  *
  * @file newton.hpp
  * Copyright (c) 2020 Peter Grajcar
  */
-#ifndef NUMERICALC_NEWTON_HPP
-#define NUMERICALC_NEWTON_HPP
+#ifndef NUMERICALC_INTEGRATION_NEWTON_HPP
+#define NUMERICALC_INTEGRATION_NEWTON_HPP
 
-#endif //NUMERICALC_NEWTON_HPP
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+#include <limits>
+#include <queue>
+#include <vector>
+
+/**
+ * Weights of the closed Newton-Cotes rule of given degree, the integral over
+ * \f$[x_0, x_0 + d h]\f$ is \f$h \sum_{j = 0}^{d} c_j f(x_0 + j h)\f$. Tables are converted
+ * to T once and shared.
+ *
+ * @tparam T floating point type
+ */
+template <typename T>
+struct NewtonCotesRule
+{
+    static const size_t max_degree = 4;
+
+    size_t degree;
+    std::vector<T> weights;
+
+    /**
+     * Returns the cached rule, 1 is the trapezoidal rule, 2 Simpson's rule, 3 Simpson's 3/8
+     * rule and 4 Boole's rule.
+     *
+     * @param degree degree from 1 to max_degree
+     * @return rule
+     */
+    static const NewtonCotesRule &get(size_t degree);
+};
+
+/**
+ * Gauss-Kronrod rule on \f$[-1, 1]\f$, the Kronrod extension of the n point Gauss rule with
+ * 2n + 1 nodes. Tables are converted to T once and shared.
+ *
+ * @tparam T floating point type
+ */
+template <typename T>
+struct GaussKronrodRule
+{
+    /**
+     * Nodes in increasing order.
+     */
+    std::vector<T> nodes;
+    std::vector<T> kronrod_weights;
+    /**
+     * Weights of the embedded Gauss rule, zero at the nodes added by Kronrod.
+     */
+    std::vector<T> gauss_weights;
+
+    /**
+     * Returns the cached rule.
+     *
+     * @param points number of nodes, 15 (G7K15) or 21 (G10K21)
+     * @return rule
+     */
+    static const GaussKronrodRule &get(size_t points);
+};
+
+/**
+ * Result of an integration.
+ *
+ * @tparam T floating point type
+ */
+template <typename T>
+struct QuadratureResult
+{
+    T value;
+    /**
+     * Estimate of the absolute error.
+     */
+    T error;
+    size_t evaluations;
+    size_t intervals;
+};
+
+/**
+ * Integrates f over [a, b] by the composite closed Newton-Cotes rule of given degree on
+ * intervals subintervals. The abscissae shared by neighbouring subintervals are evaluated once,
+ * \f$d \cdot intervals + 1\f$ evaluations in total, passed to f in batches.
+ *
+ * @tparam T floating point type
+ * @tparam F integrand
+ * @param f integrand
+ * @param a lower bound
+ * @param b upper bound
+ * @param intervals number of subintervals
+ * @param degree degree of the rule, see NewtonCotesRule
+ * @return integral
+ */
+template <typename T, typename F>
+T newton_cotes(F f, T a, T b, size_t intervals, size_t degree = 2)
+{
+    static const size_t batch = 256;
+    assert(intervals > 0);
+    const NewtonCotesRule<T> &rule = NewtonCotesRule<T>::get(degree);
+    const size_t d = rule.degree, points = intervals * d + 1;
+    const T h = (b - a) / (T) (points - 1);
+
+    T x[batch], y[batch], sum = 0;
+    for(size_t p = 0; p < points; p += batch)
+    {
+        const size_t count = std::min(batch, points - p);
+        for(size_t i = 0; i < count; ++i)
+            x[i] = p + i + 1 == points ? b : a + (T) (p + i) * h;
+        f(x, y, count);
+        for(size_t i = 0; i < count; ++i)
+        {
+            // points joining two subintervals carry the end weights of both
+            const size_t j = (p + i) % d;
+            const bool joint = j == 0 && p + i > 0 && p + i + 1 < points;
+            sum += (joint ? 2 * rule.weights[0] : rule.weights[j]) * y[i];
+        }
+    }
+    return h * sum;
+}
+
+/**
+ * Adaptive Gauss-Kronrod integration of f over [a, b]. The interval with the largest error
+ * estimate is taken from a priority queue and bisected until the sum of the estimates is below
+ * \f$\max(atol, rtol |I|)\f$. Both halves are evaluated by a single call of f. The error of an
+ * interval is estimated from the difference of the Kronrod and Gauss results as in QUADPACK,
+ * which is reliable for smooth integrands and costs no extra evaluations.
+ *
+ * @tparam T floating point type
+ * @tparam F integrand
+ * @param f integrand
+ * @param a lower bound
+ * @param b upper bound
+ * @param atol absolute tolerance
+ * @param rtol relative tolerance
+ * @param points nodes of the rule, 15 or 21
+ * @param max_intervals maximal number of intervals, the result is returned with its error
+ *        estimate once reached
+ * @return integral with the error estimate
+ */
+template <typename T, typename F>
+QuadratureResult<T> gauss_kronrod(F f, T a, T b, T atol = T(1e-12), T rtol = T(1e-10), size_t points = 21,
+                                  size_t max_intervals = 1000)
+{
+    struct Interval
+    {
+        T a, b, value, error;
+
+        bool operator<(const Interval &i) const
+        {
+            return error < i.error;
+        }
+    };
+
+    const GaussKronrodRule<T> &rule = GaussKronrodRule<T>::get(points);
+    const size_t m = rule.nodes.size();
+    std::vector<T> x(2 * m), y(2 * m);
+    QuadratureResult<T> result = {0, 0, 0, 0};
+
+    // value and error estimate of an interval from the integrand at its nodes
+    auto apply = [&](Interval &interval, const T *values) {
+        const T half = (interval.b - interval.a) / 2;
+        T kronrod = 0, gauss = 0;
+        for(size_t j = 0; j < m; ++j)
+        {
+            kronrod += rule.kronrod_weights[j] * values[j];
+            gauss += rule.gauss_weights[j] * values[j];
+        }
+        const T mean = kronrod / 2;
+        T asc = 0, abs_sum = 0;
+        for(size_t j = 0; j < m; ++j)
+        {
+            asc += rule.kronrod_weights[j] * std::abs(values[j] - mean);
+            abs_sum += rule.kronrod_weights[j] * std::abs(values[j]);
+        }
+        interval.value = kronrod * half;
+        T error = std::abs((kronrod - gauss) * half);
+        asc *= std::abs(half);
+        abs_sum *= std::abs(half);
+        if(asc != 0 && error != 0)
+            error = asc * std::min(T(1), std::pow(200 * error / asc, T(1.5)));
+        // error below the rounding of the result is not meaningful
+        const T eps = std::numeric_limits<T>::epsilon();
+        if(abs_sum > std::numeric_limits<T>::min() / (50 * eps))
+            error = std::max(50 * eps * abs_sum, error);
+        interval.error = error;
+    };
+    auto map = [&](const Interval &interval, T *out) {
+        const T center = (interval.a + interval.b) / 2, half = (interval.b - interval.a) / 2;
+        for(size_t j = 0; j < m; ++j)
+            out[j] = center + half * rule.nodes[j];
+    };
+
+    Interval whole = {a, b, 0, 0};
+    map(whole, x.data());
+    f(x.data(), y.data(), m);
+    apply(whole, y.data());
+    result.evaluations = m;
+
+    std::priority_queue<Interval> queue;
+    queue.push(whole);
+    T value = whole.value, error = whole.error;
+    while(queue.size() < max_intervals && error > std::max(atol, rtol * std::abs(value)))
+    {
+        Interval worst = queue.top();
+        const T middle = (worst.a + worst.b) / 2;
+        if(!(middle > std::min(worst.a, worst.b) && middle < std::max(worst.a, worst.b)))
+            break;
+        queue.pop();
+
+        Interval left = {worst.a, middle, 0, 0}, right = {middle, worst.b, 0, 0};
+        map(left, x.data());
+        map(right, x.data() + m);
+        f(x.data(), y.data(), 2 * m);
+        apply(left, y.data());
+        apply(right, y.data() + m);
+        result.evaluations += 2 * m;
+
+        value += left.value + right.value - worst.value;
+        error += left.error + right.error - worst.error;
+        queue.push(left);
+        queue.push(right);
+    }
+
+    // the running sums drift, the result is summed again
+    result.intervals = queue.size();
+    while(!queue.empty())
+    {
+        result.value += queue.top().value;
+        result.error += queue.top().error;
+        queue.pop();
+    }
+    return result;
+}
+
+#endif //NUMERICALC_INTEGRATION_NEWTON_HPP
@@ -0,0 +1,162 @@
+/**
+ * Barycentric Lagrange interpolation.
+ *
+ * @file barycentric.hpp
+ * Copyright (c) 2020 Peter Grajcar
+ */
+#ifndef NUMERICALC_BARYCENTRIC_HPP
+#define NUMERICALC_BARYCENTRIC_HPP
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Interpolation polynomial through \f$(x_j, y_j)\f$ in the barycentric form
+ * \f[
+ *      p(x) = \frac{\sum_j \frac{w_j}{x - x_j} y_j}{\sum_j \frac{w_j}{x - x_j}}, \quad
+ *      w_j = \frac{1}{\prod_{k \neq j} (x_j - x_k)}.
+ * \f]
+ * Only the grid, the weights and the values are stored, i.e. \f$O(n)\f$ memory, evaluation
+ * takes \f$O(n)\f$ and is numerically stable unlike evaluation of the monomial coefficients
+ * as long as the grid has small Lebesgue constant, e.g. Chebyshev points. For large equispaced
+ * grids the interpolation problem itself is ill-conditioned.
+ *
+ * Weights of a general grid are computed in \f$O(n^2)\f$ and memoized in the global basis
+ * cache, so interpolators on a repeated grid only copy them. The known grids use closed forms in
+ * \f$O(n)\f$. Weights are only defined up to a common factor, they are kept scaled so that the
+ * largest one is close to one, which avoids overflow for large grids.
+ *
+ * @tparam T floating point type
+ */
+template <typename T>
+class BarycentricInterpolator
+{
+public:
+    /**
+     * Kind of the grid, the closed form weights assume the nodes in increasing or decreasing
+     * order on any interval.
+     */
+    enum Grid
+    {
+        /**
+         * Distinct nodes in any order, weights are computed in \f$O(n^2)\f$ or taken from the
+         * basis cache.
+         */
+        general,
+        /**
+         * Equispaced nodes, \f$w_j = (-1)^j \binom{n - 1}{j}\f$.
+         */
+        equispaced,
+        /**
+         * Chebyshev points of the first kind \f$\cos \frac{(2j + 1) \pi}{2n}\f$,
+         * \f$w_j = (-1)^j \sin \frac{(2j + 1) \pi}{2n}\f$.
+         */
+        chebyshev_first,
+        /**
+         * Chebyshev points of the second kind \f$\cos \frac{j \pi}{n - 1}\f$,
+         * \f$w_j = (-1)^j \delta_j\f$ with \f$\delta_j = 1/2\f$ at the end points and one
+         * otherwise.
+         */
+        chebyshev_second
+    };
+private:
+    std::vector<T> grid, weight, value;
+    // differences in the weights are multiplied by capacity 4 / (b - a)
+    T capacity;
+
+    void normalise();
+public:
+    /**
+     * Computes the weights of the grid.
+     *
+     * @see BasisCache
+     * @param grid grid points
+     * @param values values at the grid points
+     * @param kind kind of the grid
+     */
+    BarycentricInterpolator(const std::vector<T> &grid, const std::vector<T> &values, Grid kind = general);
+
+    /**
+     *
+     * @return number of nodes
+     */
+    inline size_t size() const
+    {
+        return grid.size();
+    }
+
+    /**
+     *
+     * @return grid points
+     */
+    inline const std::vector<T> &nodes() const
+    {
+        return grid;
+    }
+
+    /**
+     *
+     * @return barycentric weights up to a common factor
+     */
+    inline const std::vector<T> &weights() const
+    {
+        return weight;
+    }
+
+    /**
+     * Replaces the interpolated values, the weights are kept.
+     *
+     * @param values values at the grid points
+     */
+    void set_values(const std::vector<T> &values);
+
+    /**
+     * Adds a node and updates the weights in \f$O(n)\f$.
+     *
+     * @param x new grid point, different from all others
+     * @param y value at x
+     */
+    void add_node(T x, T y);
+
+    /**
+     * Evaluates the interpolant at x. Returns the value of a node if x equals to it.
+     *
+     * @param x x value
+     * @return value of the interpolant at x
+     */
+    T eval(T x) const;
+
+    /**
+     * Evaluates the interpolant at x.
+     *
+     * @param x x value
+     * @return value of the interpolant at x
+     */
+    inline T operator()(T x) const
+    {
+        return eval(x);
+    }
+
+    /**
+     * Evaluates the interpolant at count points. Points are processed in groups with the sums
+     * running across the points of a group, so the independent evaluations vectorise.
+     *
+     * @param xs points
+     * @param out values of the interpolant at xs
+     * @param count number of points
+     * @param parallel split the points across the thread pool
+     */
+    void eval_many(const T *xs, T *out, size_t count, bool parallel = false) const;
+
+    /**
+     * Evaluates the interpolant at each point of xs.
+     *
+     * @see eval_many
+     * @param xs points
+     * @param parallel split the points across the thread pool
+     * @return values of the interpolant at xs
+     */
+    std::vector<T> eval_many(const std::vector<T> &xs, bool parallel = false) const;
+};
+
+#endif //NUMERICALC_BARYCENTRIC_HPP
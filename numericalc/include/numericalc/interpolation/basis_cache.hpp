@@ -0,0 +1,245 @@
+/**
+ * Memoization of interpolation bases.
+ *
+ * @file basis_cache.hpp
+ * Copyright (c) 2020 Peter Grajcar
+ */
+#ifndef NUMERICALC_BASIS_CACHE_HPP
+#define NUMERICALC_BASIS_CACHE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include "numericalc/Polynomial.hpp"
+#include "numericalc/Matrix.hpp"
+
+/**
+ * Approximate memory held by a basis, used for the memory bound of BasisCache. Overload it for
+ * other basis types.
+ *
+ * @tparam T element type
+ * @param v basis
+ * @return size in bytes
+ */
+template <typename T>
+inline size_t basis_memory(const std::vector<T> &v)
+{
+    return v.size() * sizeof(T);
+}
+
+template <typename T>
+inline size_t basis_memory(const std::vector<Polynomial<T>> &v)
+{
+    size_t size = v.size() * sizeof(Polynomial<T>);
+    for(const Polynomial<T> &p : v)
+        size += p.degree() * sizeof(T);
+    return size;
+}
+
+template <typename T>
+inline size_t basis_memory(const Matrix<T> &m)
+{
+    return m.get_rows() * m.get_cols() * sizeof(T);
+}
+
+/**
+ * Thread-safe cache of interpolation bases keyed by the contents of the grid and a tag which
+ * distinguishes variants of the basis built from the same grid. Grids are hashed and compared
+ * in full, so different grids never share a basis.
+ *
+ * Entries are evicted in least recently used order once the memory held by the bases and their
+ * grids exceeds the limit, bases larger than the limit are not cached at all. Bases are handed
+ * out as shared pointers, an evicted basis stays valid for as long as it is used.
+ *
+ * The basis is built outside of the lock, so concurrent misses on the same grid may build it
+ * more than once, only the first one is kept.
+ *
+ * The global caches memoize the \f$O(n^2)\f$ bases of lagrange_polynomials,
+ * lagrange_polynomial_matrix and of BarycentricInterpolator on general grids. Bases built in
+ * \f$O(n)\f$, such as those of CubicSpline, are not cached, a lookup hashes and compares the grid
+ * which costs as much.
+ *
+ * @tparam T grid type
+ * @tparam Basis cached basis type
+ */
+template <typename T, typename Basis>
+class BasisCache
+{
+public:
+    /**
+     * Cache statistics.
+     */
+    struct Statistics
+    {
+        size_t hits;
+        size_t misses;
+        size_t evictions;
+        size_t entries;
+        /**
+         * Memory held by the cached bases and grids in bytes.
+         */
+        size_t memory;
+    };
+private:
+    struct Key
+    {
+        std::vector<T> grid;
+        int tag;
+
+        bool operator==(const Key &k) const
+        {
+            return tag == k.tag && grid == k.grid;
+        }
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key &k) const
+        {
+            // FNV-1a over the hashes of the grid points
+            std::hash<T> hash;
+            size_t h = (size_t) 14695981039346656037ULL ^ (size_t) k.tag;
+            for(const T &x : k.grid)
+                h = (h ^ hash(x)) * (size_t) 1099511628211ULL;
+            return h;
+        }
+    };
+
+    struct Entry
+    {
+        Key key;
+        std::shared_ptr<const Basis> basis;
+        size_t memory;
+    };
+
+    mutable std::mutex mutex;
+    // most recently used entry first
+    std::list<Entry> entries;
+    std::unordered_map<Key, typename std::list<Entry>::iterator, KeyHash> index;
+    size_t limit;
+    Statistics stats;
+
+    void evict()
+    {
+        while(stats.memory > limit && !entries.empty())
+        {
+            stats.memory -= entries.back().memory;
+            index.erase(entries.back().key);
+            entries.pop_back();
+            ++stats.evictions;
+        }
+        stats.entries = entries.size();
+    }
+public:
+    /**
+     * Constructs an empty cache.
+     *
+     * @param memory_limit memory bound in bytes
+     */
+    explicit BasisCache(size_t memory_limit) : limit(memory_limit), stats() {}
+
+    BasisCache(const BasisCache &) = delete;
+    BasisCache &operator=(const BasisCache &) = delete;
+
+    /**
+     * Returns the basis of the grid, builds it by calling build() on a miss.
+     *
+     * @tparam F callable returning Basis
+     * @param grid grid points
+     * @param build builds the basis
+     * @param tag distinguishes variants of the basis of the same grid
+     * @return shared basis
+     */
+    template <typename F>
+    std::shared_ptr<const Basis> get(const std::vector<T> &grid, F build, int tag = 0)
+    {
+        Key key = {grid, tag};
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = index.find(key);
+            if(it != index.end())
+            {
+                entries.splice(entries.begin(), entries, it->second);
+                ++stats.hits;
+                return it->second->basis;
+            }
+            ++stats.misses;
+        }
+
+        std::shared_ptr<const Basis> basis = std::make_shared<const Basis>(build());
+        const size_t memory = basis_memory(*basis) + basis_memory(grid);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = index.find(key);
+        if(it != index.end())
+            return it->second->basis;
+        if(memory > limit)
+            return basis;
+
+        entries.push_front(Entry{std::move(key), basis, memory});
+        index.emplace(entries.front().key, entries.begin());
+        stats.memory += memory;
+        evict();
+        return basis;
+    }
+
+    /**
+     *
+     * @return statistics
+     */
+    Statistics statistics() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stats;
+    }
+
+    /**
+     * Changes the memory bound, evicts entries above it.
+     *
+     * @param memory_limit memory bound in bytes
+     */
+    void set_memory_limit(size_t memory_limit)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        limit = memory_limit;
+        evict();
+    }
+
+    /**
+     * Removes all entries, the statistics are kept.
+     */
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.clear();
+        index.clear();
+        stats.memory = 0;
+        stats.entries = 0;
+    }
+};
+
+/**
+ * Default memory bound of the global caches.
+ */
+static const size_t default_basis_cache_limit = (size_t) 64 << 20;
+
+/**
+ * Returns the global cache of bases of given type.
+ *
+ * @tparam T grid type
+ * @tparam Basis cached basis type
+ * @return global cache
+ */
+template <typename T, typename Basis>
+inline BasisCache<T, Basis> &basis_cache()
+{
+    static BasisCache<T, Basis> cache(default_basis_cache_limit);
+    return cache;
+}
+
+#endif //NUMERICALC_BASIS_CACHE_HPP
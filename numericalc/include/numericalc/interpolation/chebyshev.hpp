@@ -0,0 +1,181 @@
+/**
+ * Chebyshev approximation.
+ *
+ * @file chebyshev.hpp
+ * Copyright (c) 2020 Peter Grajcar
+ */
+#ifndef NUMERICALC_CHEBYSHEV_HPP
+#define NUMERICALC_CHEBYSHEV_HPP
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+/**
+ * Approximation of a function on \f$[a, b]\f$ by a Chebyshev series
+ * \f[
+ *      f(x) \approx \sum_{k = 0}^{n - 1} c_k T_k(t), \quad t = \frac{2x - a - b}{b - a}.
+ * \f]
+ * The coefficients of the interpolant in the Chebyshev points of the second kind
+ * \f$t_j = \cos \frac{j \pi}{n - 1}\f$ are computed in \f$O(n \log n)\f$ by a DCT-I, which is
+ * a real FFT of the even extension of the values. The series is evaluated by Clenshaw's
+ * recurrence in \f$O(n)\f$, which unlike the monomial form is stable at any degree.
+ *
+ * @tparam T floating point type
+ */
+template <typename T>
+class ChebyshevApproximation
+{
+    std::vector<T> coefficient;
+    T lower, upper;
+
+    bool converged(T tolerance) const;
+public:
+    /**
+     * Default relative tolerance of fit in multiples of the machine epsilon.
+     */
+    static const int default_tolerance_epsilons = 16;
+
+    /**
+     * Default maximal number of samples of fit.
+     */
+    static const size_t default_max_size = ((size_t) 1 << 16) + 1;
+
+    /**
+     * Constructs the series from its coefficients.
+     *
+     * @param coefficients Chebyshev coefficients \f$c_0, \dots, c_{n - 1}\f$
+     * @param a lower bound of the interval
+     * @param b upper bound of the interval
+     */
+    explicit ChebyshevApproximation(const std::vector<T> &coefficients, T a = -1, T b = 1);
+
+    /**
+     * Chebyshev points of the second kind on \f$[a, b]\f$ from b down to a.
+     *
+     * @param n number of points
+     * @param a lower bound of the interval
+     * @param b upper bound of the interval
+     * @return points
+     */
+    static std::vector<T> points(size_t n, T a = -1, T b = 1);
+
+    /**
+     * Constructs the interpolant of values at points(n, a, b) in \f$O(n \log n)\f$.
+     *
+     * @param values n values, n - 1 has to be power of two or zero
+     * @param a lower bound of the interval
+     * @param b upper bound of the interval
+     * @return interpolant
+     */
+    static ChebyshevApproximation interpolate(const std::vector<T> &values, T a = -1, T b = 1);
+
+    /**
+     * Approximates f to the relative tolerance. The number of samples is doubled starting from
+     * 17 until the last coefficients fall below tolerance times the largest one, the samples of
+     * the previous round are reused. The series is then truncated to the tolerance.
+     *
+     * @tparam F callable T(T)
+     * @param f approximated function, smooth on [a, b]
+     * @param a lower bound of the interval
+     * @param b upper bound of the interval
+     * @param tolerance relative tolerance
+     * @param max_size maximal number of samples, the approximation stops there even if the
+     *        tolerance was not reached
+     * @return approximation
+     */
+    template <typename F>
+    static ChebyshevApproximation fit(F f, T a = -1, T b = 1,
+                                      T tolerance = default_tolerance_epsilons * std::numeric_limits<T>::epsilon(),
+                                      size_t max_size = default_max_size)
+    {
+        std::vector<T> x = points(17, a, b), values(x.size());
+        for(size_t j = 0; j < x.size(); ++j)
+            values[j] = f(x[j]);
+
+        while(true)
+        {
+            ChebyshevApproximation approximation = interpolate(values, a, b);
+            if(approximation.converged(tolerance) || 2 * values.size() - 1 > max_size)
+            {
+                approximation.truncate(tolerance);
+                return approximation;
+            }
+
+            // points of size n are the even points of size 2n - 1
+            x = points(2 * values.size() - 1, a, b);
+            std::vector<T> next(x.size());
+            for(size_t j = 0; j < x.size(); ++j)
+                next[j] = j % 2 ? f(x[j]) : values[j / 2];
+            values.swap(next);
+        }
+    }
+
+    /**
+     *
+     * @return number of coefficients
+     */
+    inline size_t size() const
+    {
+        return coefficient.size();
+    }
+
+    /**
+     *
+     * @return Chebyshev coefficients
+     */
+    inline const std::vector<T> &coefficients() const
+    {
+        return coefficient;
+    }
+
+    /**
+     * Drops the trailing coefficients smaller than tolerance times the largest one, at least one
+     * coefficient is kept.
+     *
+     * @param tolerance relative tolerance
+     */
+    void truncate(T tolerance);
+
+    /**
+     * Evaluates the series at x by Clenshaw's recurrence.
+     *
+     * @param x x value
+     * @return value of the series at x
+     */
+    T eval(T x) const;
+
+    /**
+     * Evaluates the series at x.
+     *
+     * @param x x value
+     * @return value of the series at x
+     */
+    inline T operator()(T x) const
+    {
+        return eval(x);
+    }
+
+    /**
+     * Evaluates the series at count points. Points are processed in groups with the recurrences
+     * running across the points of a group, so the independent evaluations vectorise.
+     *
+     * @param xs points
+     * @param out values of the series at xs
+     * @param count number of points
+     * @param parallel split the points across the thread pool
+     */
+    void eval_many(const T *xs, T *out, size_t count, bool parallel = false) const;
+
+    /**
+     * Evaluates the series at each point of xs.
+     *
+     * @see eval_many
+     * @param xs points
+     * @param parallel split the points across the thread pool
+     * @return values of the series at xs
+     */
+    std::vector<T> eval_many(const std::vector<T> &xs, bool parallel = false) const;
+};
+
+#endif //NUMERICALC_CHEBYSHEV_HPP
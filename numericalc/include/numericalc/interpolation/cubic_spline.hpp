@@ -1,5 +1,5 @@
 /**
- *
+ * Cubic spline interpolation.
  *
  * @file cubic_spline.hpp
  * Copyright (c) 2020 Peter Grajcar
@@ -7,4 +7,145 @@
 #ifndef NUMERICALC_CUBIC_SPLINE_HPP
 #define NUMERICALC_CUBIC_SPLINE_HPP
 
+#include <cstddef>
+#include <vector>
+
+/**
+ * Cubic spline through \f$(x_i, y_i)\f$, twice continuously differentiable piecewise cubic
+ * polynomial. The slopes at the knots are the solution of a tridiagonal system solved by the
+ * Thomas algorithm, so the spline is built in \f$O(n)\f$.
+ *
+ * The coefficients of each interval are stored next to each other, on the interval
+ * \f$[x_i, x_{i + 1}]\f$ the spline is
+ * \f$s(x) = a_i + b_i t + c_i t^2 + d_i t^3\f$ with \f$t = x - x_i\f$. Interval lookup takes
+ * \f$O(1)\f$ for uniform grids. Other grids are split into n - 1 buckets of equal width, the
+ * bucket of a point restricts a branch-free binary search to the intervals overlapping it, which
+ * are few unless the grid is strongly clustered. Outside of the grid the polynomials of the end
+ * intervals are used.
+ *
+ * @tparam T floating point type
+ */
+template <typename T>
+class CubicSpline
+{
+public:
+    /**
+     * Boundary condition, the two conditions at the end points complete the system.
+     */
+    enum Boundary
+    {
+        /**
+         * Zero second derivative at both end points.
+         */
+        natural,
+        /**
+         * Given first derivative at both end points.
+         */
+        clamped,
+        /**
+         * Continuous third derivative at the second and the last but one knot, i.e. the first
+         * two and the last two intervals are single cubics.
+         */
+        not_a_knot
+    };
+private:
+    std::vector<T> knot;
+    // a, b, c, d of interval i at 4i .. 4i + 3
+    std::vector<T> coefficient;
+    bool uniform;
+    T inverse_step;
+    // first interval overlapping each bucket of width 1 / inverse_step of non-uniform grids
+    std::vector<size_t> guide;
+
+    size_t search(T x) const;
+    size_t interval(T x) const;
+
+    inline T eval_interval(size_t i, T x) const
+    {
+        const T t = x - knot[i];
+        const T *c = coefficient.data() + 4 * i;
+        return c[0] + t * (c[1] + t * (c[2] + t * c[3]));
+    }
+public:
+    /**
+     * Builds the spline.
+     *
+     * @param grid strictly increasing grid points, at least two
+     * @param values values at the grid points
+     * @param boundary boundary condition
+     * @param left first derivative at the first grid point of a clamped spline
+     * @param right first derivative at the last grid point of a clamped spline
+     */
+    CubicSpline(const std::vector<T> &grid, const std::vector<T> &values, Boundary boundary = natural,
+                T left = 0, T right = 0);
+
+    /**
+     *
+     * @return number of knots
+     */
+    inline size_t size() const
+    {
+        return knot.size();
+    }
+
+    /**
+     *
+     * @return grid points
+     */
+    inline const std::vector<T> &knots() const
+    {
+        return knot;
+    }
+
+    /**
+     *
+     * @return coefficients a, b, c, d of each interval one after another
+     */
+    inline const std::vector<T> &coefficients() const
+    {
+        return coefficient;
+    }
+
+    /**
+     * Evaluates the spline at x.
+     *
+     * @param x x value
+     * @return value of the spline at x
+     */
+    T eval(T x) const;
+
+    /**
+     * Evaluates the spline at x.
+     *
+     * @param x x value
+     * @return value of the spline at x
+     */
+    inline T operator()(T x) const
+    {
+        return eval(x);
+    }
+
+    /**
+     * Evaluates the spline at count points. The interval of a point is searched from the
+     * interval of the previous one, so for sorted points the intervals are walked
+     * incrementally, points in any order fall back to the lookup.
+     *
+     * @param xs points
+     * @param out values of the spline at xs
+     * @param count number of points
+     * @param parallel split the points across the thread pool
+     */
+    void eval_many(const T *xs, T *out, size_t count, bool parallel = false) const;
+
+    /**
+     * Evaluates the spline at each point of xs.
+     *
+     * @see eval_many
+     * @param xs points
+     * @param parallel split the points across the thread pool
+     * @return values of the spline at xs
+     */
+    std::vector<T> eval_many(const std::vector<T> &xs, bool parallel = false) const;
+};
+
 #endif //NUMERICALC_CUBIC_SPLINE_HPP
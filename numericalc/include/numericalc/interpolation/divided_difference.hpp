@@ -0,0 +1,121 @@
+/**
+ * Newton divided difference interpolation.
+ *
+ * @file divided_difference.hpp
+ * Copyright (c) 2020 Peter Grajcar
+ */
+#ifndef NUMERICALC_DIVIDED_DIFFERENCE_HPP
+#define NUMERICALC_DIVIDED_DIFFERENCE_HPP
+
+#include <cstddef>
+#include <vector>
+#include "numericalc/Polynomial.hpp"
+
+/**
+ * Interpolation polynomial through \f$(x_0, y_0), \dots, (x_{n - 1}, y_{n - 1})\f$ in the
+ * Newton form
+ * \f[
+ *      p(x) = \sum_{k = 0}^{n - 1} f[x_0, \dots, x_k] \prod_{j < k} (x - x_j),
+ * \f]
+ * built incrementally for points arriving one at a time. Besides the coefficients
+ * \f$f[x_0, \dots, x_k]\f$ the last row of the divided difference table
+ * \f$f[x_j, \dots, x_{n - 1}]\f$ is kept, so that appending a point takes \f$O(n)\f$ as well as
+ * dropping the oldest one. Evaluation takes \f$O(n)\f$ by nested multiplication.
+ *
+ * With a window the oldest point is dropped whenever the number of points would exceed it, the
+ * interpolant then follows the latest points at constant cost per update.
+ *
+ * @tparam T floating point type
+ */
+template <typename T>
+class NewtonInterpolator
+{
+    std::vector<T> grid;
+    // coefficient[k] = f[x_0 .. x_k], row[j] = f[x_j .. x_{n-1}]
+    std::vector<T> coefficient, row;
+    size_t window;
+public:
+    /**
+     * Constructs an empty interpolator.
+     *
+     * @param window maximal number of points, zero for no limit
+     */
+    explicit NewtonInterpolator(size_t window = 0) : window(window) {}
+
+    /**
+     * Constructs the interpolator of the points in \f$O(n^2)\f$.
+     *
+     * @param grid distinct grid points
+     * @param values values at the grid points
+     * @param window maximal number of points, zero for no limit, only the last points are kept
+     */
+    NewtonInterpolator(const std::vector<T> &grid, const std::vector<T> &values, size_t window = 0);
+
+    /**
+     *
+     * @return number of points
+     */
+    inline size_t size() const
+    {
+        return grid.size();
+    }
+
+    /**
+     *
+     * @return grid points from the oldest one
+     */
+    inline const std::vector<T> &nodes() const
+    {
+        return grid;
+    }
+
+    /**
+     *
+     * @return divided differences \f$f[x_0, \dots, x_k]\f$
+     */
+    inline const std::vector<T> &coefficients() const
+    {
+        return coefficient;
+    }
+
+    /**
+     * Appends a point in \f$O(n)\f$, drops the oldest point if the window is full.
+     *
+     * @param x grid point, different from all others
+     * @param y value at x
+     */
+    void add_point(T x, T y);
+
+    /**
+     * Drops the oldest point in \f$O(n)\f$.
+     */
+    void remove_oldest();
+
+    /**
+     * Evaluates the interpolant at x, zero if there are no points.
+     *
+     * @param x x value
+     * @return value of the interpolant at x
+     */
+    T eval(T x) const;
+
+    /**
+     * Evaluates the interpolant at x.
+     *
+     * @param x x value
+     * @return value of the interpolant at x
+     */
+    inline T operator()(T x) const
+    {
+        return eval(x);
+    }
+
+    /**
+     * Converts the interpolant to the monomial basis in \f$O(n^2)\f$.
+     *
+     * @return interpolation polynomial
+     */
+    Polynomial<T> polynomial() const;
+};
+
+#endif //NUMERICALC_DIVIDED_DIFFERENCE_HPP
@@ -8,12 +8,15 @@
 #define NUMERICALC_LAGRANGE_HPP
 
 #include <vector>
+#include <memory>
 #include <numericalc/Polynomial.hpp>
 #include <numericalc/Matrix.hpp>
 
 /**
- * Constructs lagrange polynomials at grid points. \f$O(n^2)\f$ algorithm.
+ * Constructs lagrange polynomials at grid points. \f$O(n^2)\f$ algorithm. The polynomials are
+ * memoized in the global basis cache, a repeated grid only copies them.
  *
+ * @see cached_lagrange_polynomials
  * @tparam T polynomial type
  * @param grid grid points
  * @return Lagrange polynomials
@@ -23,8 +26,10 @@ std::vector<Polynomial<T>> lagrange_polynomials(const std::vector<T> &grid);
 
 /**
  * Constructs lagrange polynomials at grid points. Returns matrix with each row representing
- * coefficients of polynomial \f$l_i\f$. \f$O(n^2)\f$ algorithm.
+ * coefficients of polynomial \f$l_i\f$. \f$O(n^2)\f$ algorithm. The matrix is memoized in the
+ * global basis cache, a repeated grid only copies it.
  *
+ * @see cached_lagrange_polynomial_matrix
  * @tparam T polynomial type
  * @param grid grid points
  * @return Lagrange polynomial matrix
@@ -32,5 +37,31 @@ std::vector<Polynomial<T>> lagrange_polynomials(const std::vector<T> &grid);
 template <typename T>
 Matrix<T> lagrange_polynomial_matrix(const std::vector<T> &grid);
 
+/**
+ * Returns lagrange polynomials of the grid from the global basis cache, they are constructed
+ * only when the grid is not cached. Unlike lagrange_polynomials the cached basis is shared, not
+ * copied.
+ *
+ * @see BasisCache
+ * @tparam T polynomial type
+ * @param grid grid points
+ * @return shared Lagrange polynomials
+ */
+template <typename T>
+std::shared_ptr<const std::vector<Polynomial<T>>> cached_lagrange_polynomials(const std::vector<T> &grid);
+
+/**
+ * Returns lagrange polynomial matrix of the grid from the global basis cache, it is constructed
+ * only when the grid is not cached. Unlike lagrange_polynomial_matrix the cached basis is shared,
+ * not copied.
+ *
+ * @see BasisCache
+ * @tparam T polynomial type
+ * @param grid grid points
+ * @return shared Lagrange polynomial matrix
+ */
+template <typename T>
+std::shared_ptr<const Matrix<T>> cached_lagrange_polynomial_matrix(const std::vector<T> &grid);
+
 
 #endif //NUMERICALC_LAGRANGE_HPP
@@ -0,0 +1,113 @@
+/**
+ * Fast multipoint evaluation and interpolation.
+ *
+ * @file subproduct_tree.hpp
+ * Copyright (c) 2020 Peter Grajcar
+ */
+#ifndef NUMERICALC_SUBPRODUCT_TREE_HPP
+#define NUMERICALC_SUBPRODUCT_TREE_HPP
+
+#include <vector>
+#include "numericalc/Polynomial.hpp"
+#include "numericalc/division/poly_div.hpp"
+
+/**
+ * Subproduct tree of points \f$x_0, \dots, x_{n-1}\f$. Leaves are the linear factors
+ * \f$x - x_i\f$, every inner node is the product of its children and the root is
+ * \f$w(x) = \prod_i (x - x_i)\f$. The tree is built once in \f$O(M(n) \log n)\f$ and can be
+ * reused for any number of evaluations and interpolations on the same points.
+ *
+ * Evaluation reduces the polynomial modulo the nodes from the root downwards (remainder tree),
+ * interpolation combines the scaled values upwards. Both take \f$O(M(n) \log n)\f$ where
+ * \f$M(n)\f$ is the cost of multiplication. Remainders are computed by PolyDivisor with inverses
+ * of the nodes precomputed in the tree. Nodes on one level are processed in
+ * parallel.
+ *
+ * The tree requires exact arithmetic. In the monomial basis the subproducts of real points have
+ * coefficients exponentially larger than their values on the points, even for well spread points
+ * such as Chebyshev nodes, so a floating point remainder tree loses all digits at a few hundred
+ * points. Coefficients are therefore Modular, over \f$\mathbb{Z}_{998244353}\f$ the products are
+ * computed by NTT. Floating point polynomials are evaluated by Polynomial::eval_many and
+ * interpolated by BarycentricInterpolator.
+ *
+ * @tparam T Modular type
+ */
+template <typename T>
+class SubproductTree
+{
+private:
+    std::vector<T> points;
+    // levels[0] are the leaves, levels.back() holds the root only
+    std::vector<std::vector<std::vector<T>>> levels;
+    // divisors[j][i] divides by levels[j][i] with the precision needed by the remainder tree
+    std::vector<std::vector<PolyDivisor<T>>> divisors;
+    // remainders are not reduced further below this level, polynomials are evaluated directly
+    size_t bottom;
+
+    std::vector<std::vector<T>> remainders(const std::vector<T> &p) const;
+public:
+    /**
+     * Builds the tree.
+     *
+     * @param grid distinct evaluation points
+     */
+    explicit SubproductTree(const std::vector<T> &grid);
+
+    /**
+     *
+     * @return number of points
+     */
+    inline size_t size() const
+    {
+        return points.size();
+    }
+
+    /**
+     *
+     * @return \f$w(x) = \prod_i (x - x_i)\f$
+     */
+    Polynomial<T> root() const;
+
+    /**
+     * Evaluates polynomial at all points of the tree.
+     *
+     * @param p polynomial
+     * @return values \f$p(x_i)\f$
+     */
+    std::vector<T> evaluate(const Polynomial<T> &p) const;
+
+    /**
+     * Constructs the interpolation polynomial through \f$(x_i, y_i)\f$. The polynomial has
+     * size n.
+     *
+     * @param values values \f$y_i\f$
+     * @return interpolation polynomial
+     */
+    Polynomial<T> interpolate(const std::vector<T> &values) const;
+};
+
+/**
+ * Evaluates polynomial at n points in \f$O(M(n) \log n)\f$.
+ *
+ * @see SubproductTree
+ * @tparam T Modular type
+ * @param p polynomial
+ * @param points evaluation points
+ * @return values at the points
+ */
+template <typename T>
+std::vector<T> multipoint_eval(const Polynomial<T> &p, const std::vector<T> &points);
+
+/**
+ * Constructs the interpolation polynomial through n points in \f$O(M(n) \log n)\f$.
+ *
+ * @see SubproductTree
+ * @tparam T Modular type
+ * @param grid distinct grid points
+ * @param values values at the grid points
+ * @return interpolation polynomial of size n
+ */
+template <typename T>
+Polynomial<T> multipoint_interpolate(const std::vector<T> &grid, const std::vector<T> &values);
+
+#endif //NUMERICALC_SUBPRODUCT_TREE_HPP
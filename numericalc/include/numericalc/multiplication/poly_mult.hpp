@@ -0,0 +1,103 @@
+/**
+ * Polynomial multiplication algorithms and automatic algorithm selection.
+ *
+ * @file poly_mult.hpp
+ * Copyright (c) 2020 Peter Grajcar
+ */
+#ifndef NUMERICALC_POLY_MULT_HPP
+#define NUMERICALC_POLY_MULT_HPP
+
+#include <cstddef>
+#include "numericalc/Polynomial.hpp"
+
+/**
+ * Crossover sizes used by poly_mult. All thresholds compare against the size of the shorter
+ * operand. The values are global, they should be tuned before the library is used from
+ * multiple threads.
+ */
+struct PolyMultThresholds
+{
+    /**
+     * Shorter operands are multiplied by the schoolbook algorithm.
+     */
+    size_t karatsuba;
+    /**
+     * Floating point operands from this size use Toom-3.
+     */
+    size_t toom3;
+    /**
+     * Double operands from this size use FFT.
+     */
+    size_t fft;
+    /**
+     * Integral operands from this size use NTT.
+     */
+    size_t ntt;
+    /**
+     * Modular operands from this size use NTT, one prime is much cheaper than the several
+     * needed for integers.
+     */
+    size_t ntt_modular;
+};
+
+/**
+ * Returns reference to the global multiplication thresholds.
+ *
+ * @return thresholds
+ */
+PolyMultThresholds &poly_mult_thresholds();
+
+/**
+ * \f$O(mn)\f$ schoolbook multiplication.
+ *
+ * @tparam T polynomial type
+ * @param p polynomial p
+ * @param q polynomial q
+ * @return product of size \f$m + n\f$
+ */
+template <typename T>
+Polynomial<T> schoolbook_mult(const Polynomial<T> &p, const Polynomial<T> &q);
+
+/**
+ * Karatsuba multiplication in \f$O(n^{\log_2 3})\f$ with schoolbook multiplication below the
+ * Karatsuba threshold. Unbalanced operands are split into chunks
+ * of the size of the shorter one. Integral types are computed in unsigned arithmetic, so
+ * overflow wraps exactly as in the schoolbook algorithm.
+ *
+ * @tparam T polynomial type
+ * @param p polynomial p
+ * @param q polynomial q
+ * @return product of size \f$m + n\f$
+ */
+template <typename T>
+Polynomial<T> karatsuba_mult(const Polynomial<T> &p, const Polynomial<T> &q);
+
+/**
+ * Toom-3 multiplication in \f$O(n^{\log_3 5})\f$ with evaluation points \f$0, 1, -1, -2, \infty\f$
+ * and Bodrato's interpolation sequence, Karatsuba is used below the Toom-3 threshold. The interpolation divides by 2 and 3, therefore only
+ * floating point types are supported.
+ *
+ * @tparam T floating point type
+ * @param p polynomial p
+ * @param q polynomial q
+ * @return product of size \f$m + n\f$
+ */
+template <typename T>
+Polynomial<T> toom3_mult(const Polynomial<T> &p, const Polynomial<T> &q);
+
+/**
+ * Multiplies polynomials with the algorithm that is fastest for their size and type:
+ * schoolbook, Karatsuba, Toom-3 (floating point), FFT (double) or NTT (integral and Modular
+ * types). Products that ntt_mult does not support fall back to Karatsuba.
+ * Polynomial::operator* uses this function.
+ *
+ * @see poly_mult_thresholds
+ * @tparam T polynomial type
+ * @param p polynomial p
+ * @param q polynomial q
+ * @return product of size \f$m + n\f$
+ */
+template <typename T>
+Polynomial<T> poly_mult(const Polynomial<T> &p, const Polynomial<T> &q);
+
+#endif //NUMERICALC_POLY_MULT_HPP
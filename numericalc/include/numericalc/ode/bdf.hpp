@@ -0,0 +1,550 @@
+/**
+ * Implicit integrator of stiff ordinary differential equations.
+ *
+ * @file bdf.hpp
+ * Copyright (c) 2020 Peter Grajcar
+ */
+#ifndef NUMERICALC_BDF_HPP
+#define NUMERICALC_BDF_HPP
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "numericalc/Matrix.hpp"
+#include "numericalc/decomposition/lu.hpp"
+
+/**
+ * Variable order (1 to 5) variable step backward differentiation formulas in the quasi-constant
+ * step size form of Shampine and Reichelt with the NDF corrections of the error constants.
+ * The solution history is kept as the backward differences of the last order + 1 values,
+ * changing the step size rescales them.
+ *
+ * Each step solves the implicit formula by a simplified Newton iteration with the matrix
+ * \f$I - c J\f$, \f$c = h / \alpha_k\f$. The matrix is factorized by lu_factorize and the
+ * factorization is reused as long as the step size and the order stay the same, also after
+ * a step rejected for its error. The Jacobian is reused across steps of any size and is only
+ * evaluated again when the Newton iteration fails to converge with a stale one, only then the
+ * step size is halved.
+ *
+ * The right hand side is a callable f(t, y, dydt) writing into dydt, see euler.hpp. The
+ * Jacobian is either given by set_jacobian or approximated by finite differences. A sparse
+ * Jacobian is described by its nonzero pattern, the finite differences then perturb groups of
+ * columns without common rows at once, so a banded or otherwise sparse system of any size costs
+ * only a few evaluations of f per Jacobian. The Jacobian and \f$I - c J\f$ are still stored and
+ * factorized as dense matrices, so each factorization costs \f$O(n^3)\f$.
+ *
+ * @tparam T floating point type
+ * @tparam F right hand side
+ */
+template <typename T, typename F>
+class Bdf
+{
+public:
+    /**
+     * Callable writing \f$\partial f_i / \partial y_j\f$ at (t, y) into J, J is zero on entry
+     * so a sparse Jacobian only writes its nonzero elements.
+     */
+    using Jacobian = std::function<void(T, const std::vector<T> &, Matrix<T> &)>;
+
+    static const size_t max_order = 5;
+    static const size_t newton_iterations = 4;
+private:
+    F f;
+    size_t n;
+    T rtol, atol, newton_tolerance;
+    T alpha[max_order + 1], gamma[max_order + 1], error_constant[max_order + 1];
+
+    Jacobian jacobian;
+    // columns perturbed together and the nonzero rows of each column
+    std::vector<std::vector<size_t>> groups, column_rows;
+    Matrix<T> jac, lu;
+    std::vector<size_t> pivot;
+    bool lu_valid, jacobian_current;
+
+    // backward differences, row k at k * n
+    std::vector<T> D, D_tmp;
+    std::vector<T> y_predict, y_new, psi, d, dy, value, base, scale;
+    size_t order, equal_steps;
+    T t, h_abs;
+
+    T *difference(size_t k)
+    {
+        return D.data() + k * n;
+    }
+
+    T norm(const T *v) const
+    {
+        T sum = 0;
+        for(size_t i = 0; i < n; ++i)
+        {
+            const T r = v[i] / scale[i];
+            sum += r * r;
+        }
+        return std::sqrt(sum / (T) n);
+    }
+
+    /*
+     * Rescales the differences to the step size h * factor.
+     */
+    void change_differences(T factor)
+    {
+        // RU = R(factor) U with R_ij = prod_{r = 1}^{i} (r - 1 - factor j) / r, U = R(1)
+        T R[max_order + 1][max_order + 1], U[max_order + 1][max_order + 1], RU[max_order + 1][max_order + 1];
+        for(size_t j = 0; j <= order; ++j)
+        {
+            R[0][j] = U[0][j] = 1;
+            for(size_t i = 1; i <= order; ++i)
+            {
+                R[i][j] = j ? R[i - 1][j] * ((T) i - 1 - factor * (T) j) / (T) i : 0;
+                U[i][j] = j ? U[i - 1][j] * ((T) i - 1 - (T) j) / (T) i : 0;
+            }
+        }
+        for(size_t i = 0; i <= order; ++i)
+            for(size_t j = 0; j <= order; ++j)
+            {
+                T sum = 0;
+                for(size_t k = 0; k <= order; ++k)
+                    sum += R[i][k] * U[k][j];
+                RU[i][j] = sum;
+            }
+
+        // D_j = sum_k RU_kj D_k
+        for(size_t j = 0; j <= order; ++j)
+        {
+            T *out = D_tmp.data() + j * n;
+            std::fill(out, out + n, T(0));
+            for(size_t k = 0; k <= order; ++k)
+            {
+                const T w = RU[k][j];
+                const T *in = difference(k);
+                for(size_t i = 0; i < n; ++i)
+                    out[i] += w * in[i];
+            }
+        }
+        std::copy(D_tmp.begin(), D_tmp.begin() + (order + 1) * n, D.begin());
+    }
+
+    void evaluate_jacobian(T time, const std::vector<T> &y)
+    {
+        std::fill(jac.elements().begin(), jac.elements().end(), T(0));
+        ++jacobian_evaluations;
+        if(jacobian)
+        {
+            jacobian(time, y, jac);
+            return;
+        }
+
+        // forward differences, the columns of a group share no row
+        const T root_eps = std::sqrt(std::numeric_limits<T>::epsilon());
+        f(time, y, base);
+        ++evaluations;
+        std::vector<T> &perturbed = y_new;
+        for(const std::vector<size_t> &group : groups)
+        {
+            perturbed = y;
+            for(size_t j : group)
+            {
+                const T step = root_eps * std::max(std::abs(y[j]), atol / rtol);
+                perturbed[j] = y[j] + step;
+            }
+            f(time, perturbed, value);
+            ++evaluations;
+            for(size_t j : group)
+            {
+                const T step = perturbed[j] - y[j];
+                for(size_t i : column_rows[j])
+                    jac(i, j) = (value[i] - base[i]) / step;
+            }
+        }
+    }
+
+    bool factorize(T c)
+    {
+        for(size_t i = 0; i < n; ++i)
+            for(size_t j = 0; j < n; ++j)
+                lu(i, j) = (i == j ? T(1) : T(0)) - c * jac(i, j);
+        ++factorizations;
+        lu_valid = lu_factorize(lu, pivot);
+        return lu_valid;
+    }
+
+    /*
+     * Simplified Newton iteration for y_new = y_predict + d with c f(t, y_new) - psi - d = 0.
+     */
+    bool newton(T time, T c, size_t &iterations)
+    {
+        std::fill(d.begin(), d.end(), T(0));
+        y_new = y_predict;
+        T previous = -1;
+        for(iterations = 1; iterations <= newton_iterations; ++iterations)
+        {
+            f(time, y_new, value);
+            ++evaluations;
+            for(size_t i = 0; i < n; ++i)
+            {
+                if(!std::isfinite(value[i]))
+                    return false;
+                dy[i] = c * value[i] - psi[i] - d[i];
+            }
+            lu_solve(lu, pivot, dy.data());
+
+            // the contraction rate bounds the remaining error
+            const T dy_norm = norm(dy.data());
+            const T rate = previous >= 0 ? dy_norm / previous : -1;
+            if(rate >= 0 && (rate >= 1 || std::pow(rate, (T) (newton_iterations - iterations + 1)) / (1 - rate) * dy_norm > newton_tolerance))
+                return false;
+            for(size_t i = 0; i < n; ++i)
+            {
+                y_new[i] += dy[i];
+                d[i] += dy[i];
+            }
+            if(dy_norm == 0 || (rate >= 0 && rate / (1 - rate) * dy_norm < newton_tolerance))
+                return true;
+            previous = dy_norm;
+        }
+        --iterations;
+        return false;
+    }
+public:
+    /**
+     * Number of accepted and rejected steps, evaluations of f including the finite differences,
+     * evaluations of the Jacobian and LU factorizations.
+     */
+    size_t accepted, rejected, evaluations, jacobian_evaluations, factorizations;
+
+    /**
+     *
+     * @param f right hand side
+     * @param n dimension of the system
+     * @param rtol relative tolerance, raised to 100 eps as neither the Newton iteration nor the
+     *             finite differences resolve smaller relative changes
+     * @param atol absolute tolerance
+     */
+    Bdf(F f, size_t n, T rtol = T(1e-6), T atol = T(1e-9))
+        : f(f), n(n), rtol(std::max(rtol, 100 * std::numeric_limits<T>::epsilon())), atol(atol),
+          groups(n), column_rows(n), jac(n, n), lu(n, n),
+          lu_valid(false), jacobian_current(false), D((max_order + 3) * n), D_tmp((max_order + 1) * n),
+          y_predict(n), y_new(n), psi(n), d(n), dy(n), value(n), base(n), scale(n), order(1),
+          equal_steps(0), t(0), h_abs(0), accepted(0), rejected(0), evaluations(0),
+          jacobian_evaluations(0), factorizations(0)
+    {
+        assert(n > 0);
+        const T eps = std::numeric_limits<T>::epsilon();
+        newton_tolerance = std::max(10 * eps / this->rtol, std::min(T(0.03), std::sqrt(this->rtol)));
+
+        // NDF corrections kappa, gamma_k = sum_{j <= k} 1 / j
+        const T kappa[max_order + 1] = {0, T(-0.1850), T(-1.0 / 9), T(-0.0823), T(-0.0415), 0};
+        gamma[0] = 0;
+        for(size_t k = 1; k <= max_order; ++k)
+            gamma[k] = gamma[k - 1] + T(1) / (T) k;
+        for(size_t k = 0; k <= max_order; ++k)
+        {
+            alpha[k] = (1 - kappa[k]) * gamma[k];
+            error_constant[k] = kappa[k] * gamma[k] + T(1) / (T) (k + 1);
+        }
+
+        // dense Jacobian, every column on its own
+        for(size_t j = 0; j < n; ++j)
+        {
+            groups[j].assign(1, j);
+            column_rows[j].resize(n);
+            for(size_t i = 0; i < n; ++i)
+                column_rows[j][i] = i;
+        }
+    }
+
+    /**
+     * Sets the analytic Jacobian, finite differences are used if it is empty.
+     *
+     * @param j Jacobian
+     */
+    void set_jacobian(Jacobian j)
+    {
+        jacobian = j;
+    }
+
+    /**
+     * Sets the nonzero pattern of the Jacobian for the finite differences. Columns are grouped
+     * greedily so that no two columns of a group have a nonzero in the same row.
+     *
+     * @param nonzeros positions (i, j) of the nonzero elements
+     */
+    void set_sparsity(const std::vector<std::pair<size_t, size_t>> &nonzeros)
+    {
+        for(std::vector<size_t> &rows : column_rows)
+            rows.clear();
+        for(const std::pair<size_t, size_t> &nz : nonzeros)
+        {
+            assert(nz.first < n && nz.second < n);
+            column_rows[nz.second].push_back(nz.first);
+        }
+
+        groups.clear();
+        std::vector<std::vector<bool>> used;
+        for(size_t j = 0; j < n; ++j)
+        {
+            size_t g = 0;
+            for(; g < groups.size(); ++g)
+            {
+                bool free = true;
+                for(size_t i : column_rows[j])
+                    free = free && !used[g][i];
+                if(free)
+                    break;
+            }
+            if(g == groups.size())
+            {
+                groups.emplace_back();
+                used.emplace_back(n, false);
+            }
+            groups[g].push_back(j);
+            for(size_t i : column_rows[j])
+                used[g][i] = true;
+        }
+    }
+
+    /**
+     * Starts the integration at (t0, y0) with order one, evaluates the Jacobian there.
+     *
+     * @param t0 initial time
+     * @param y0 initial state
+     * @param h initial step size, zero for an estimate
+     */
+    void reset(T t0, const std::vector<T> &y0, T h = 0)
+    {
+        assert(y0.size() == n);
+        t = t0;
+        order = 1;
+        equal_steps = 0;
+        f(t0, y0, value);
+        ++evaluations;
+
+        if(h <= 0)
+        {
+            // estimate of Hairer, Norsett and Wanner for a method of order one
+            T d0 = 0, d1 = 0, d2 = 0;
+            for(size_t i = 0; i < n; ++i)
+                scale[i] = atol + rtol * std::abs(y0[i]);
+            d0 = norm(y0.data());
+            d1 = norm(value.data());
+            const T h0 = d0 < T(1e-5) || d1 < T(1e-5) ? T(1e-6) : T(0.01) * d0 / d1;
+            for(size_t i = 0; i < n; ++i)
+                y_new[i] = y0[i] + h0 * value[i];
+            f(t0 + h0, y_new, base);
+            ++evaluations;
+            for(size_t i = 0; i < n; ++i)
+                dy[i] = base[i] - value[i];
+            d2 = norm(dy.data()) / h0;
+            const T top = std::max(d1, d2);
+            const T h1 = top <= T(1e-15) ? std::max(T(1e-6), h0 * T(1e-3)) : std::sqrt(T(0.01) / top);
+            h = std::min(100 * h0, h1);
+        }
+        h_abs = h;
+
+        std::fill(D.begin(), D.end(), T(0));
+        std::copy(y0.begin(), y0.end(), difference(0));
+        for(size_t i = 0; i < n; ++i)
+            difference(1)[i] = value[i] * h_abs;
+
+        evaluate_jacobian(t0, y0);
+        lu_valid = false;
+    }
+
+    /**
+     *
+     * @return time of the last accepted step
+     */
+    inline T time() const
+    {
+        return t;
+    }
+
+    /**
+     *
+     * @return order of the next step
+     */
+    inline size_t current_order() const
+    {
+        return order;
+    }
+
+    /**
+     * Makes one step from the last accepted point not beyond t_bound, reset has to be called
+     * before the first step.
+     *
+     * @param t_bound time which is not stepped over
+     * @param y replaced by the state at time()
+     * @return false if the step size fell below the resolution of t
+     */
+    bool step(T t_bound, std::vector<T> &y)
+    {
+        const T min_step = 10 * std::numeric_limits<T>::epsilon() * std::max(std::abs(t), std::numeric_limits<T>::min());
+        jacobian_current = false;
+
+        T t_new = t;
+        size_t iterations = 0;
+        while(true)
+        {
+            if(h_abs < min_step)
+                return false;
+
+            t_new = t + h_abs;
+            if(t_new >= t_bound)
+            {
+                t_new = t_bound;
+                change_differences((t_new - t) / h_abs);
+                equal_steps = 0;
+                lu_valid = false;
+            }
+            const T h = t_new - t;
+            h_abs = h;
+
+            for(size_t i = 0; i < n; ++i)
+            {
+                T predict = 0, history = 0;
+                for(size_t k = 0; k <= order; ++k)
+                    predict += D[k * n + i];
+                for(size_t k = 1; k <= order; ++k)
+                    history += gamma[k] * D[k * n + i];
+                y_predict[i] = predict;
+                psi[i] = history / alpha[order];
+                scale[i] = atol + rtol * std::abs(predict);
+            }
+
+            const T c = h / alpha[order];
+            bool converged = false;
+            while(true)
+            {
+                if(!lu_valid && !factorize(c))
+                    break;
+                converged = newton(t_new, c, iterations);
+                if(converged || jacobian_current)
+                    break;
+                evaluate_jacobian(t_new, y_predict);
+                jacobian_current = true;
+                lu_valid = false;
+            }
+
+            if(!converged)
+            {
+                h_abs /= 2;
+                change_differences(T(0.5));
+                equal_steps = 0;
+                lu_valid = false;
+                ++rejected;
+                continue;
+            }
+
+            for(size_t i = 0; i < n; ++i)
+                scale[i] = atol + rtol * std::abs(y_new[i]);
+            const T safety = T(0.9) * (T) (2 * newton_iterations + 1) / (T) (2 * newton_iterations + iterations);
+            const T error = error_constant[order] * norm(d.data());
+            if(error <= 1)
+                break;
+
+            // the factorization for the old step size still converges, it is kept
+            const T factor = std::max(T(0.2), safety * std::pow(error, T(-1) / (T) (order + 1)));
+            h_abs *= factor;
+            change_differences(factor);
+            equal_steps = 0;
+            ++rejected;
+        }
+
+        ++accepted;
+        ++equal_steps;
+        t = t_new;
+        y = y_new;
+
+        // update of the differences by the correction d
+        for(size_t i = 0; i < n; ++i)
+        {
+            difference(order + 2)[i] = d[i] - difference(order + 1)[i];
+            difference(order + 1)[i] = d[i];
+        }
+        for(size_t k = order + 1; k-- > 0;)
+            for(size_t i = 0; i < n; ++i)
+                difference(k)[i] += difference(k + 1)[i];
+
+        if(equal_steps < order + 1)
+            return true;
+
+        // the order with the largest admissible step among order - 1, order, order + 1
+        const T error = error_constant[order] * norm(d.data());
+        T norms[3] = {
+            order > 1 ? error_constant[order - 1] * norm(difference(order)) : std::numeric_limits<T>::infinity(),
+            error,
+            order < max_order ? error_constant[order + 1] * norm(difference(order + 2)) : std::numeric_limits<T>::infinity()
+        };
+        const T safety = T(0.9) * (T) (2 * newton_iterations + 1) / (T) (2 * newton_iterations + iterations);
+        size_t best = 0;
+        T best_factor = 0;
+        for(size_t i = 0; i < 3; ++i)
+        {
+            const T factor = norms[i] > 0 ? std::pow(norms[i], T(-1) / (T) (order + i)) : std::numeric_limits<T>::infinity();
+            if(factor > best_factor)
+            {
+                best_factor = factor;
+                best = i;
+            }
+        }
+        order = order + best - 1;
+        const T factor = std::min(T(10), safety * best_factor);
+        h_abs *= factor;
+        change_differences(factor);
+        equal_steps = 0;
+        lu_valid = false;
+        return true;
+    }
+
+    /**
+     * Integrates from t0 to t1 > t0.
+     *
+     * @param t0 initial time
+     * @param t1 final time
+     * @param y initial state, replaced by the state at t1
+     * @param h initial step size, zero for an estimate
+     * @return false if the integration stopped early because the step size became too small,
+     *         y is then the state at time()
+     */
+    bool integrate(T t0, T t1, std::vector<T> &y, T h = 0)
+    {
+        assert(t1 > t0);
+        reset(t0, y, h);
+        while(t < t1)
+            if(!step(t1, y))
+                return false;
+        return true;
+    }
+};
+
+template <typename T, typename F>
+const size_t Bdf<T, F>::max_order;
+template <typename T, typename F>
+const size_t Bdf<T, F>::newton_iterations;
+
+/**
+ * Integrates a stiff system by the BDF method with a finite difference Jacobian.
+ *
+ * @see Bdf
+ * @tparam T floating point type
+ * @tparam F right hand side
+ * @param f right hand side
+ * @param t0 initial time
+ * @param t1 final time, t1 > t0
+ * @param y initial state, replaced by the state at t1
+ * @param rtol relative tolerance
+ * @param atol absolute tolerance
+ * @return false if the integration stopped early
+ */
+template <typename T, typename F>
+bool bdf(F f, T t0, T t1, std::vector<T> &y, T rtol = T(1e-6), T atol = T(1e-9))
+{
+    return Bdf<T, F>(f, y.size(), rtol, atol).integrate(t0, t1, y);
+}
+
+#endif //NUMERICALC_BDF_HPP
@@ -0,0 +1,352 @@
+/**
+ * Integration of an ensemble of trajectories of one system.
+ *
+ * @file ensemble.hpp
+ * Copyright (c) 2020 Peter Grajcar
+ */
+#ifndef NUMERICALC_ENSEMBLE_HPP
+#define NUMERICALC_ENSEMBLE_HPP
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <vector>
+#include "numericalc/ode/euler.hpp"
+#include "numericalc/parallel/thread_pool.hpp"
+
+/**
+ * Trajectories integrated together by one lane group.
+ */
+static const size_t ensemble_lanes = 8;
+
+/**
+ * Adaptive Dormand-Prince 5(4) method, see DormandPrince, applied to many trajectories of the
+ * same system at once, e.g. different initial conditions or parameters.
+ *
+ * Trajectories are packed into groups of ensemble_lanes lanes, the state of a group is stored
+ * as n rows of ensemble_lanes values so that the stages are computed by loops across the lanes
+ * which vectorise. Every lane has its own time, step size and error control, a step is accepted
+ * or rejected per lane by masking. A lane whose trajectory reached the final time is refilled
+ * with the next trajectory, so the lanes stay busy until the last few trajectories. Ranges of
+ * trajectories are distributed across the thread pool, each with its own lane group.
+ *
+ * The right hand side is a callable f(ids, t, y, dydt) evaluating the whole group:
+ * <ul>
+ *      <li>ids[l] is the index of the trajectory in lane l, e.g. to look up its parameters,</li>
+ *      <li>t[l] is the time of lane l,</li>
+ *      <li>y[i * ensemble_lanes + l] is component i of lane l and dydt has the same layout.</li>
+ * </ul>
+ * Idle lanes hold a copy of a finished trajectory, their results are ignored.
+ *
+ * As in DormandPrince::integrate, a trajectory stops early when its step size falls below the
+ * resolution of its time or its error is not finite, its final state is then the last accepted
+ * one and the lane moves on to the next trajectory.
+ *
+ * @tparam T floating point type
+ * @tparam F right hand side
+ */
+template <typename T, typename F>
+class EnsembleDormandPrince
+{
+    static constexpr double safety = 0.9, min_factor = 0.2, max_factor = 10, beta = 0.04;
+
+    F f;
+    size_t n;
+    T rtol, atol;
+    T c[7], a[7][6], e[7];
+
+    size_t integrate_range(T t0, T t1, size_t count, const T *y0, T *y1, size_t lo, size_t hi)
+    {
+        if(lo >= hi)
+            return 0;
+        const size_t L = ensemble_lanes;
+        std::vector<T> k[7];
+        for(size_t s = 0; s < 7; ++s)
+            k[s].resize(n * L);
+        std::vector<T> y(n * L), tmp(n * L);
+        // idle lanes take part in every evaluation of f, so all of them are initialised
+        T t[L] = {}, h[L] = {}, stage_t[L] = {}, err[L] = {}, log_previous[L] = {};
+        bool active[L] = {}, rejected_last[L] = {}, last[L] = {}, fresh[L] = {};
+        size_t ids[L] = {};
+        size_t next = lo, accepted_steps = 0, rejected_steps = 0, stopped_trajectories = 0;
+
+        // loads the next trajectory into lane l or marks it idle
+        auto load = [&](size_t l) {
+            fresh[l] = active[l] = next < hi;
+            if(!active[l])
+                return;
+            ids[l] = next++;
+            for(size_t i = 0; i < n; ++i)
+                y[i * L + l] = y0[i * count + ids[l]];
+            t[l] = t0;
+            log_previous[l] = std::log(T(1e-4));
+            rejected_last[l] = false;
+        };
+
+        // stores the state of lane l and loads the next trajectory, returns whether it did
+        auto finish = [&](size_t l) {
+            for(size_t i = 0; i < n; ++i)
+                y1[i * count + ids[l]] = y[i * L + l];
+            load(l);
+            return active[l];
+        };
+
+        // first stage of the fresh lanes and their initial step size
+        auto start = [&]() {
+            f(ids, t, y.data(), k[0].data());
+            T d0[L] = {}, d1[L] = {}, d2[L] = {}, h0[L];
+            for(size_t i = 0; i < n; ++i)
+                for(size_t l = 0; l < L; ++l)
+                {
+                    const T scale = atol + rtol * std::abs(y[i * L + l]);
+                    d0[l] += y[i * L + l] * y[i * L + l] / (scale * scale);
+                    d1[l] += k[0][i * L + l] * k[0][i * L + l] / (scale * scale);
+                }
+            for(size_t l = 0; l < L; ++l)
+            {
+                d0[l] = std::sqrt(d0[l] / (T) n);
+                d1[l] = std::sqrt(d1[l] / (T) n);
+                h0[l] = d0[l] < T(1e-5) || d1[l] < T(1e-5) ? T(1e-6) : T(0.01) * d0[l] / d1[l];
+                stage_t[l] = t[l] + h0[l];
+            }
+            for(size_t i = 0; i < n; ++i)
+                for(size_t l = 0; l < L; ++l)
+                    tmp[i * L + l] = y[i * L + l] + h0[l] * k[0][i * L + l];
+            f(ids, stage_t, tmp.data(), k[1].data());
+            for(size_t i = 0; i < n; ++i)
+                for(size_t l = 0; l < L; ++l)
+                {
+                    const T scale = atol + rtol * std::abs(y[i * L + l]);
+                    const T diff = (k[1][i * L + l] - k[0][i * L + l]) / scale;
+                    d2[l] += diff * diff;
+                }
+            for(size_t l = 0; l < L; ++l)
+            {
+                if(!fresh[l])
+                    continue;
+                d2[l] = std::sqrt(d2[l] / (T) n) / h0[l];
+                const T top = std::max(d1[l], d2[l]);
+                const T h1 = top <= T(1e-15) ? std::max(T(1e-6), h0[l] * T(1e-3)) : std::pow(T(0.01) / top, T(0.2));
+                h[l] = std::min(100 * h0[l], h1);
+                fresh[l] = false;
+            }
+        };
+
+        for(size_t l = 0; l < L; ++l)
+            load(l);
+        // idle lanes duplicate the first one
+        for(size_t l = 0; l < L; ++l)
+            if(!active[l])
+            {
+                ids[l] = ids[0];
+                t[l] = t[0];
+                for(size_t i = 0; i < n; ++i)
+                    y[i * L + l] = y[i * L];
+            }
+        start();
+
+        while(true)
+        {
+            bool any = false, refill = false;
+            for(size_t l = 0; l < L; ++l)
+            {
+                const T min_step = 16 * std::numeric_limits<T>::epsilon() * std::max(std::abs(t[l]), std::numeric_limits<T>::min());
+                if(active[l] && !(h[l] >= min_step))
+                {
+                    ++stopped_trajectories;
+                    refill = finish(l) || refill;
+                }
+            }
+            if(refill)
+                start();
+            refill = false;
+
+            for(size_t l = 0; l < L; ++l)
+            {
+                any = any || active[l];
+                last[l] = t[l] + h[l] >= t1;
+                if(last[l])
+                    h[l] = t1 - t[l];
+            }
+            if(!any)
+                break;
+
+            for(size_t s = 1; s < 7; ++s)
+            {
+                for(size_t i = 0; i < n; ++i)
+                {
+                    T sum[L] = {};
+                    for(size_t j = 0; j < s; ++j)
+                    {
+                        const T w = a[s][j];
+                        const T *kj = k[j].data() + i * L;
+                        for(size_t l = 0; l < L; ++l)
+                            sum[l] += w * kj[l];
+                    }
+                    for(size_t l = 0; l < L; ++l)
+                        tmp[i * L + l] = y[i * L + l] + h[l] * sum[l];
+                }
+                for(size_t l = 0; l < L; ++l)
+                    stage_t[l] = t[l] + c[s] * h[l];
+                f(ids, stage_t, tmp.data(), k[s].data());
+            }
+
+            std::fill(err, err + L, T(0));
+            for(size_t i = 0; i < n; ++i)
+            {
+                T sum[L] = {};
+                for(size_t j = 0; j < 7; ++j)
+                {
+                    const T w = e[j];
+                    const T *kj = k[j].data() + i * L;
+                    for(size_t l = 0; l < L; ++l)
+                        sum[l] += w * kj[l];
+                }
+                for(size_t l = 0; l < L; ++l)
+                {
+                    const T scale = atol + rtol * std::max(std::abs(y[i * L + l]), std::abs(tmp[i * L + l]));
+                    const T r = h[l] * sum[l] / scale;
+                    err[l] += r * r;
+                }
+            }
+
+            // step size factors of all lanes without branches, the powers of the PI controller
+            // are evaluated through the logarithms so that the loop vectorises with vector math
+            bool accept[L];
+            T factor[L];
+            for(size_t l = 0; l < L; ++l)
+            {
+                err[l] = std::sqrt(err[l] / (T) n);
+                accept[l] = active[l] & (err[l] <= 1);
+                const T log_err = std::log(std::max(err[l], T(1e-10)));
+                const T exponent = accept[l] ? (-T(0.2) + T(0.75 * beta)) * log_err + T(beta) * log_previous[l] : -T(0.2) * log_err;
+                const T limit = accept[l] && !rejected_last[l] ? T(max_factor) : T(1);
+                factor[l] = std::min(limit, std::max(T(min_factor), T(safety) * std::exp(exponent)));
+                log_previous[l] = accept[l] ? std::max(log_err, T(std::log(1e-4))) : log_previous[l];
+            }
+            for(size_t i = 0; i < n; ++i)
+            {
+                T *yi = y.data() + i * L, *k0 = k[0].data() + i * L;
+                const T *ti = tmp.data() + i * L, *k6 = k[6].data() + i * L;
+                for(size_t l = 0; l < L; ++l)
+                {
+                    yi[l] = accept[l] ? ti[l] : yi[l];
+                    k0[l] = accept[l] ? k6[l] : k0[l];
+                }
+            }
+
+            for(size_t l = 0; l < L; ++l)
+            {
+                if(!active[l])
+                    continue;
+                rejected_last[l] = !accept[l];
+                if(!accept[l])
+                {
+                    h[l] *= factor[l];
+                    ++rejected_steps;
+                    if(!std::isfinite(err[l]))
+                    {
+                        ++stopped_trajectories;
+                        refill = finish(l) || refill;
+                    }
+                    continue;
+                }
+                ++accepted_steps;
+                if(last[l])
+                    refill = finish(l) || refill;
+                else
+                {
+                    t[l] += h[l];
+                    h[l] *= factor[l];
+                }
+            }
+            if(refill)
+                start();
+        }
+
+        accepted += accepted_steps;
+        rejected += rejected_steps;
+        stopped += stopped_trajectories;
+        return stopped_trajectories;
+    }
+public:
+    /**
+     * Number of accepted and rejected steps of all trajectories and of the trajectories stopped
+     * early.
+     */
+    std::atomic<size_t> accepted, rejected, stopped;
+
+    /**
+     *
+     * @param f right hand side of a lane group
+     * @param n dimension of the system
+     * @param rtol relative tolerance
+     * @param atol absolute tolerance
+     */
+    EnsembleDormandPrince(F f, size_t n, T rtol = T(1e-6), T atol = T(1e-9))
+        : f(f), n(n), rtol(rtol), atol(atol), accepted(0), rejected(0), stopped(0)
+    {
+        for(size_t j = 0; j < 7; ++j)
+        {
+            c[j] = (T) DormandPrinceTableau::c[j];
+            e[j] = (T) DormandPrinceTableau::e[j];
+            for(size_t l = 0; l < 6; ++l)
+                a[j][l] = (T) DormandPrinceTableau::a[j][l];
+        }
+    }
+
+    /**
+     * Integrates count trajectories from t0 to t1 > t0. States are stored as structure of
+     * arrays, component i of trajectory m at i * count + m.
+     *
+     * @param t0 initial time
+     * @param t1 final time
+     * @param count number of trajectories
+     * @param y0 initial states
+     * @param y1 final states, may alias y0
+     * @param parallel split the trajectories across the thread pool
+     * @return false if a trajectory stopped early, see stopped
+     */
+    bool integrate(T t0, T t1, size_t count, const T *y0, T *y1, bool parallel = true)
+    {
+        assert(t1 > t0);
+        std::atomic<size_t> stopped_trajectories(0);
+        auto block = [&](size_t lo, size_t hi) {
+            stopped_trajectories += integrate_range(t0, t1, count, y0, y1, lo, hi);
+        };
+        if(parallel)
+            parallel_for(0, count, 16 * ensemble_lanes, block);
+        else
+            block(0, count);
+        return stopped_trajectories == 0;
+    }
+
+    /**
+     * Integrates count trajectories from t0 to t1 > t0 in place.
+     *
+     * @param t0 initial time
+     * @param t1 final time
+     * @param y states of count trajectories as structure of arrays, replaced by the final states
+     * @param parallel split the trajectories across the thread pool
+     * @return false if a trajectory stopped early
+     */
+    bool integrate(T t0, T t1, std::vector<T> &y, bool parallel = true)
+    {
+        assert(y.size() % n == 0);
+        return integrate(t0, t1, y.size() / n, y.data(), y.data(), parallel);
+    }
+};
+
+template <typename T, typename F>
+constexpr double EnsembleDormandPrince<T, F>::safety;
+template <typename T, typename F>
+constexpr double EnsembleDormandPrince<T, F>::min_factor;
+template <typename T, typename F>
+constexpr double EnsembleDormandPrince<T, F>::max_factor;
+template <typename T, typename F>
+constexpr double EnsembleDormandPrince<T, F>::beta;
+
+#endif //NUMERICALC_ENSEMBLE_HPP
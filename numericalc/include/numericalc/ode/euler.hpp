@@ -1,5 +1,9 @@
 /**
+ * Explicit integrators of ordinary differential equations \f$y' = f(t, y)\f$.
  *
+ * The right hand side is any callable f(t, y, dydt) with y a const std::vector<T> & and dydt a
+ * std::vector<T> & of the same size into which the derivative is written. The integrators
+ * allocate their workspace on construction, steps do not allocate.
  *
  * @file euler.hpp
  * Copyright (c) 2020 Peter Grajcar
@@ -7,4 +11,504 @@
 #ifndef NUMERICALC_EULER_HPP
 #define NUMERICALC_EULER_HPP
 
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+/**
+ * Explicit Euler method of order one, \f$y_{k+1} = y_k + h f(t_k, y_k)\f$.
+ *
+ * @tparam T floating point type
+ * @tparam F right hand side
+ */
+template <typename T, typename F>
+class EulerMethod
+{
+    F f;
+    std::vector<T> k;
+public:
+    /**
+     *
+     * @param f right hand side
+     * @param n dimension of the system
+     */
+    EulerMethod(F f, size_t n) : f(f), k(n) {}
+
+    /**
+     * Advances y from t by h.
+     *
+     * @param t time
+     * @param y state, replaced by the state at t + h
+     * @param h step size
+     */
+    void step(T t, std::vector<T> &y, T h)
+    {
+        f(t, y, k);
+        for(size_t i = 0; i < y.size(); ++i)
+            y[i] += h * k[i];
+    }
+
+    /**
+     * Integrates from t0 to t1 in steps of equal size.
+     *
+     * @param t0 initial time
+     * @param t1 final time
+     * @param y initial state, replaced by the state at t1
+     * @param steps number of steps
+     */
+    void integrate(T t0, T t1, std::vector<T> &y, size_t steps)
+    {
+        const T h = (t1 - t0) / (T) steps;
+        for(size_t s = 0; s < steps; ++s)
+            step(t0 + (T) s * h, y, h);
+    }
+};
+
+/**
+ * Classical Runge-Kutta method of order four.
+ *
+ * @tparam T floating point type
+ * @tparam F right hand side
+ */
+template <typename T, typename F>
+class RungeKutta4
+{
+    F f;
+    std::vector<T> k1, k2, k3, k4, tmp;
+public:
+    /**
+     *
+     * @param f right hand side
+     * @param n dimension of the system
+     */
+    RungeKutta4(F f, size_t n) : f(f), k1(n), k2(n), k3(n), k4(n), tmp(n) {}
+
+    /**
+     * Advances y from t by h.
+     *
+     * @param t time
+     * @param y state, replaced by the state at t + h
+     * @param h step size
+     */
+    void step(T t, std::vector<T> &y, T h)
+    {
+        const size_t n = y.size();
+        f(t, y, k1);
+        for(size_t i = 0; i < n; ++i)
+            tmp[i] = y[i] + h / 2 * k1[i];
+        f(t + h / 2, tmp, k2);
+        for(size_t i = 0; i < n; ++i)
+            tmp[i] = y[i] + h / 2 * k2[i];
+        f(t + h / 2, tmp, k3);
+        for(size_t i = 0; i < n; ++i)
+            tmp[i] = y[i] + h * k3[i];
+        f(t + h, tmp, k4);
+        for(size_t i = 0; i < n; ++i)
+            y[i] += h / 6 * (k1[i] + 2 * (k2[i] + k3[i]) + k4[i]);
+    }
+
+    /**
+     * Integrates from t0 to t1 in steps of equal size.
+     *
+     * @param t0 initial time
+     * @param t1 final time
+     * @param y initial state, replaced by the state at t1
+     * @param steps number of steps
+     */
+    void integrate(T t0, T t1, std::vector<T> &y, size_t steps)
+    {
+        const T h = (t1 - t0) / (T) steps;
+        for(size_t s = 0; s < steps; ++s)
+            step(t0 + (T) s * h, y, h);
+    }
+};
+
+/**
+ * Butcher tableau of the Dormand-Prince 5(4) pair with the coefficients of its continuous
+ * extension of order four.
+ */
+struct DormandPrinceTableau
+{
+    static const double c[7];
+    static const double a[7][6];
+    /**
+     * Weights of the solution of order five, the seventh stage only enters the error estimate.
+     */
+    static const double b[7];
+    /**
+     * Difference of the weights of order five and four.
+     */
+    static const double e[7];
+    /**
+     * Dense output, stage i is weighted by \f$\sum_j d_{ij} \theta^{j + 1}\f$.
+     */
+    static const double d[7][4];
+};
+
+/**
+ * Adaptive Dormand-Prince 5(4) method. The seventh stage equals the first stage of the next
+ * step (first same as last), so an accepted step costs six evaluations of f. The local error
+ * \f$\| e \| = \sqrt{\frac{1}{n} \sum_i (e_i / (atol + rtol \max(|y_i|, |\hat y_i|)))^2}\f$ is
+ * kept below one, the step size is chosen by the PI controller of Hairer and Wanner which
+ * avoids oscillating step sizes. The last accepted step can be interpolated to order four at no
+ * extra evaluations of f.
+ *
+ * @tparam T floating point type
+ * @tparam F right hand side
+ */
+template <typename T, typename F>
+class DormandPrince
+{
+    F f;
+    T rtol, atol;
+    // stages of the last step, k[0] holds f at the start of the next step once swapped with k[6]
+    std::vector<T> k[7];
+    std::vector<T> y_old, tmp;
+    T c[7], a[7][6], e[7], d[7][4];
+    T t_old, h_old, t_last;
+    T previous_error, last_error;
+    bool last_rejected, swap_pending;
+
+    T error_norm(const std::vector<T> &y, const std::vector<T> &y_new) const
+    {
+        T sum = 0;
+        for(size_t i = 0; i < y.size(); ++i)
+        {
+            T err = 0;
+            for(size_t j = 0; j < 7; ++j)
+                err += e[j] * k[j][i];
+            const T scale = atol + rtol * std::max(std::abs(y[i]), std::abs(y_new[i]));
+            err *= h_old / scale;
+            sum += err * err;
+        }
+        return std::sqrt(sum / (T) std::max(y.size(), (size_t) 1));
+    }
+public:
+    /**
+     * Controller constants, the step size changes by a factor within [min_factor, max_factor].
+     */
+    static constexpr double safety = 0.9, min_factor = 0.2, max_factor = 10, beta = 0.04;
+
+    /**
+     * Number of accepted and rejected steps and evaluations of f.
+     */
+    size_t accepted, rejected, evaluations;
+
+    /**
+     *
+     * @param f right hand side
+     * @param n dimension of the system
+     * @param rtol relative tolerance
+     * @param atol absolute tolerance
+     */
+    DormandPrince(F f, size_t n, T rtol = T(1e-6), T atol = T(1e-9))
+        : f(f), rtol(rtol), atol(atol), y_old(n), tmp(n), t_old(0), h_old(0), t_last(0), previous_error(1e-4), last_error(0),
+          last_rejected(false), swap_pending(false), accepted(0), rejected(0), evaluations(0)
+    {
+        for(size_t j = 0; j < 7; ++j)
+        {
+            k[j].resize(n);
+            c[j] = (T) DormandPrinceTableau::c[j];
+            e[j] = (T) DormandPrinceTableau::e[j];
+            for(size_t l = 0; l < 6; ++l)
+                a[j][l] = (T) DormandPrinceTableau::a[j][l];
+            for(size_t l = 0; l < 4; ++l)
+                d[j][l] = (T) DormandPrinceTableau::d[j][l];
+        }
+    }
+
+    /**
+     * Starts the integration at (t, y), evaluates f there.
+     *
+     * @param t time
+     * @param y state
+     */
+    void reset(T t, const std::vector<T> &y)
+    {
+        assert(y.size() == y_old.size());
+        f(t, y, k[0]);
+        ++evaluations;
+        t_old = t_last = t;
+        h_old = 0;
+        previous_error = T(1e-4);
+        last_error = 0;
+        last_rejected = swap_pending = false;
+    }
+
+    /**
+     * Estimates the initial step size at the point passed to reset by the algorithm of Hairer,
+     * Norsett and Wanner, costs one evaluation of f.
+     *
+     * @param t time
+     * @param y state
+     * @return initial step size
+     */
+    T initial_step(T t, const std::vector<T> &y)
+    {
+        const size_t n = y.size();
+        T d0 = 0, d1 = 0;
+        for(size_t i = 0; i < n; ++i)
+        {
+            const T scale = atol + rtol * std::abs(y[i]);
+            d0 += y[i] * y[i] / (scale * scale);
+            d1 += k[0][i] * k[0][i] / (scale * scale);
+        }
+        d0 = std::sqrt(d0 / (T) n);
+        d1 = std::sqrt(d1 / (T) n);
+        const T h0 = d0 < T(1e-5) || d1 < T(1e-5) ? T(1e-6) : T(0.01) * d0 / d1;
+
+        // one explicit Euler step estimates the second derivative
+        for(size_t i = 0; i < n; ++i)
+            tmp[i] = y[i] + h0 * k[0][i];
+        f(t + h0, tmp, k[1]);
+        ++evaluations;
+        T d2 = 0;
+        for(size_t i = 0; i < n; ++i)
+        {
+            const T scale = atol + rtol * std::abs(y[i]);
+            const T diff = (k[1][i] - k[0][i]) / scale;
+            d2 += diff * diff;
+        }
+        d2 = std::sqrt(d2 / (T) n) / h0;
+
+        const T top = std::max(d1, d2);
+        const T h1 = top <= T(1e-15) ? std::max(T(1e-6), h0 * T(1e-3)) : std::pow(T(0.01) / top, T(0.2));
+        return std::min(100 * h0, h1);
+    }
+
+    /**
+     * Attempts a step from (t, y), reset has to be called before the first step.
+     *
+     * @param t time, advanced by the step if accepted
+     * @param y state, replaced by the state at the new t if accepted
+     * @param h step size, replaced by the proposed size of the next step
+     * @return whether the step was accepted
+     */
+    bool step(T &t, std::vector<T> &y, T &h)
+    {
+        const size_t n = y.size();
+        if(swap_pending)
+        {
+            std::swap(k[0], k[6]);
+            swap_pending = false;
+        }
+
+        for(size_t s = 1; s < 7; ++s)
+        {
+            for(size_t i = 0; i < n; ++i)
+            {
+                T sum = 0;
+                for(size_t j = 0; j < s; ++j)
+                    sum += a[s][j] * k[j][i];
+                tmp[i] = y[i] + h * sum;
+            }
+            f(t + c[s] * h, tmp, k[s]);
+        }
+        evaluations += 6;
+
+        // tmp holds the solution of order five, the last row of a equals b
+        h_old = h;
+        const T err = error_norm(y, tmp);
+        last_error = err;
+
+        if(err <= 1)
+        {
+            // PI controller, the factor is limited after a rejection
+            T factor = err > 0 ? T(safety) * std::pow(err, -T(0.2) + T(0.75 * beta)) * std::pow(previous_error, T(beta)) : T(max_factor);
+            factor = std::min(T(max_factor), std::max(T(min_factor), factor));
+            if(last_rejected)
+                factor = std::min(factor, T(1));
+            previous_error = std::max(err, T(1e-4));
+            last_rejected = false;
+            ++accepted;
+
+            std::copy(y.begin(), y.end(), y_old.begin());
+            std::copy(tmp.begin(), tmp.end(), y.begin());
+            t_old = t;
+            t += h;
+            t_last = t;
+            h *= factor;
+            swap_pending = true;
+            return true;
+        }
+
+        const T factor = std::max(T(min_factor), T(safety) * std::pow(err, -T(0.2)));
+        last_rejected = true;
+        ++rejected;
+        h *= factor;
+        return false;
+    }
+
+    /**
+     *
+     * @return time of the last accepted step, or of reset
+     */
+    T time() const
+    {
+        return t_last;
+    }
+
+    /**
+     *
+     * @return error norm of the last attempted step, not finite if f returned a non-finite value
+     */
+    T error() const
+    {
+        return last_error;
+    }
+
+    /**
+     * Interpolates the last accepted step. The stages are overwritten by the next call of step,
+     * even if that step is rejected, so the interpolation is valid only until then, in
+     * particular inside the observer of integrate.
+     *
+     * @param t time within the last accepted step
+     * @param out state at t
+     */
+    void dense_output(T t, std::vector<T> &out) const
+    {
+        const T theta = (t - t_old) / h_old;
+        T weight[7];
+        for(size_t j = 0; j < 7; ++j)
+        {
+            T w = 0;
+            for(size_t l = 4; l-- > 0;)
+                w = (w + d[j][l]) * theta;
+            weight[j] = w * h_old;
+        }
+        // k[0] is the first stage until the next step swaps it
+        for(size_t i = 0; i < y_old.size(); ++i)
+        {
+            T sum = 0;
+            for(size_t j = 0; j < 7; ++j)
+                sum += weight[j] * k[j][i];
+            out[i] = y_old[i] + sum;
+        }
+    }
+
+    /**
+     * Integrates from t0 to t1 > t0, the last step is shortened to end at t1.
+     *
+     * @tparam Observer callable taking (t, y, *this), called after each accepted step
+     * @param t0 initial time
+     * @param t1 final time
+     * @param y initial state, replaced by the state at t1
+     * @param observer observer of the accepted steps, dense_output interpolates within the step
+     * @param h initial step size, zero for an estimate
+     * @return false if the integration stopped early because the step size fell below the
+     *         resolution of t or f returned a non-finite value, y is then the state at time()
+     */
+    template <typename Observer>
+    bool integrate(T t0, T t1, std::vector<T> &y, Observer observer, T h = 0)
+    {
+        assert(t1 >= t0);
+        reset(t0, y);
+        if(h <= 0)
+            h = initial_step(t0, y);
+
+        T t = t0;
+        while(t < t1)
+        {
+            const T min_step = 16 * std::numeric_limits<T>::epsilon() * std::max(std::abs(t), std::numeric_limits<T>::min());
+            if(!(h >= min_step))
+                return false;
+
+            const bool last = t + h >= t1;
+            T step_size = last ? t1 - t : h;
+            if(step(t, y, step_size))
+            {
+                if(last)
+                    t = t1;
+                observer(t, y, *this);
+                if(!last || step_size < h)
+                    h = step_size;
+            }
+            else if(!std::isfinite(last_error))
+                return false;
+            else
+                h = step_size;
+        }
+        return true;
+    }
+
+    /**
+     * Integrates from t0 to t1 > t0.
+     *
+     * @param t0 initial time
+     * @param t1 final time
+     * @param y initial state, replaced by the state at t1
+     * @param h initial step size, zero for an estimate
+     * @return false if the integration stopped early, y is then the state at time()
+     */
+    bool integrate(T t0, T t1, std::vector<T> &y, T h = 0)
+    {
+        return integrate(t0, t1, y, [](T, const std::vector<T> &, const DormandPrince &) {}, h);
+    }
+};
+
+template <typename T, typename F>
+constexpr double DormandPrince<T, F>::safety;
+template <typename T, typename F>
+constexpr double DormandPrince<T, F>::min_factor;
+template <typename T, typename F>
+constexpr double DormandPrince<T, F>::max_factor;
+template <typename T, typename F>
+constexpr double DormandPrince<T, F>::beta;
+
+/**
+ * Integrates by the explicit Euler method in steps of equal size.
+ *
+ * @tparam T floating point type
+ * @tparam F right hand side
+ * @param f right hand side
+ * @param t0 initial time
+ * @param t1 final time
+ * @param y initial state, replaced by the state at t1
+ * @param steps number of steps
+ */
+template <typename T, typename F>
+void euler(F f, T t0, T t1, std::vector<T> &y, size_t steps)
+{
+    EulerMethod<T, F>(f, y.size()).integrate(t0, t1, y, steps);
+}
+
+/**
+ * Integrates by the classical Runge-Kutta method in steps of equal size.
+ *
+ * @tparam T floating point type
+ * @tparam F right hand side
+ * @param f right hand side
+ * @param t0 initial time
+ * @param t1 final time
+ * @param y initial state, replaced by the state at t1
+ * @param steps number of steps
+ */
+template <typename T, typename F>
+void runge_kutta4(F f, T t0, T t1, std::vector<T> &y, size_t steps)
+{
+    RungeKutta4<T, F>(f, y.size()).integrate(t0, t1, y, steps);
+}
+
+/**
+ * Integrates by the adaptive Dormand-Prince method.
+ *
+ * @tparam T floating point type
+ * @tparam F right hand side
+ * @param f right hand side
+ * @param t0 initial time
+ * @param t1 final time, t1 >= t0
+ * @param y initial state, replaced by the state at t1
+ * @param rtol relative tolerance
+ * @param atol absolute tolerance
+ * @return false if the integration stopped early
+ */
+template <typename T, typename F>
+bool dormand_prince(F f, T t0, T t1, std::vector<T> &y, T rtol = T(1e-6), T atol = T(1e-9))
+{
+    return DormandPrince<T, F>(f, y.size(), rtol, atol).integrate(t0, t1, y);
+}
+
 #endif //NUMERICALC_EULER_HPP
@@ -0,0 +1,147 @@
+/**
+ * Fixed-size thread pool shared by the parallel algorithms of the library.
+ *
+ * @file thread_pool.hpp
+ * Copyright (c) 2020 Peter Grajcar
+ */
+#ifndef NUMERICALC_THREAD_POOL_HPP
+#define NUMERICALC_THREAD_POOL_HPP
+
+#include <cstddef>
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+
+/**
+ * Thread pool with a fixed number of workers. Work is usually submitted through parallel_for
+ * which splits an index range into chunks. The calling thread takes part in the computation,
+ * therefore nested parallel_for calls from within a worker cannot deadlock.
+ */
+class ThreadPool
+{
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool stop;
+
+    void worker_loop();
+public:
+    /**
+     * Constructs a pool with given number of worker threads. Zero workers is allowed, in which
+     * case all the work is done by the calling thread.
+     *
+     * @param threads number of worker threads
+     */
+    explicit ThreadPool(size_t threads);
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    ~ThreadPool();
+
+    /**
+     * Returns the global pool. The pool has one worker less than the number of hardware threads
+     * as the calling thread does its share of the work.
+     *
+     * @return global thread pool
+     */
+    static ThreadPool &instance();
+
+    /**
+     *
+     * @return number of worker threads
+     */
+    inline size_t size() const
+    {
+        return workers.size();
+    }
+
+    /**
+     * Submits a task to be executed by one of the workers.
+     *
+     * @param task task
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * Calls f(lo, hi) for consecutive chunks of range [begin, end) of at most grain indices.
+     * Returns after all chunks are processed.
+     *
+     * @tparam F callable taking two size_t arguments
+     * @param begin first index
+     * @param end one past the last index
+     * @param grain maximal chunk size
+     * @param f function
+     */
+    template <typename F>
+    void parallel_for(size_t begin, size_t end, size_t grain, F f);
+};
+
+template <typename F>
+void ThreadPool::parallel_for(size_t begin, size_t end, size_t grain, F f)
+{
+    if(begin >= end) return;
+    if(grain == 0) grain = 1;
+
+    const size_t chunks = (end - begin + grain - 1) / grain;
+    if(chunks == 1 || workers.empty()) {
+        f(begin, end);
+        return;
+    }
+
+    struct State
+    {
+        std::atomic<size_t> next;
+        std::atomic<size_t> done;
+        std::mutex mutex;
+        std::condition_variable cv;
+    };
+    std::shared_ptr<State> state = std::make_shared<State>();
+    state->next = 0;
+    state->done = 0;
+
+    // f is only touched after a chunk is claimed, all claimed chunks are finished before
+    // this function returns, so late helpers never see a dangling reference.
+    F *fp = &f;
+    auto run = [state, fp, chunks, begin, end, grain]() {
+        size_t c;
+        while((c = state->next.fetch_add(1)) < chunks) {
+            size_t lo = begin + c * grain;
+            (*fp)(lo, std::min(end, lo + grain));
+            if(state->done.fetch_add(1) + 1 == chunks) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->cv.notify_all();
+            }
+        }
+    };
+
+    size_t helpers = std::min(workers.size(), chunks - 1);
+    for(size_t i = 0; i < helpers; ++i)
+        submit(run);
+    run();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    while(state->done.load() < chunks)
+        state->cv.wait(lock);
+}
+
+/**
+ * Runs parallel_for on the global thread pool.
+ *
+ * @see ThreadPool::parallel_for
+ */
+template <typename F>
+inline void parallel_for(size_t begin, size_t end, size_t grain, F f)
+{
+    ThreadPool::instance().parallel_for(begin, end, grain, f);
+}
+
+#endif //NUMERICALC_THREAD_POOL_HPP
@@ -0,0 +1,44 @@
+/**
+ * Cache-blocked matrix transposition.
+ *
+ * @file transpose.hpp
+ * Copyright (c) 2020 Peter Grajcar
+ */
+#ifndef NUMERICALC_TRANSPOSE_HPP
+#define NUMERICALC_TRANSPOSE_HPP
+
+#include <cstddef>
+#include <algorithm>
+#include "numericalc/parallel/thread_pool.hpp"
+
+/**
+ * Transposes row-major matrix src \f$M \times N\f$ into dst \f$N \times M\f$. The matrix is
+ * processed in square blocks so that both source and destination lines stay in cache, the
+ * blocks are distributed over the thread pool. The arrays must not overlap.
+ *
+ * @tparam T element type
+ * @param src source matrix
+ * @param dst destination matrix
+ * @param rows rows of the source matrix
+ * @param cols columns of the source matrix
+ */
+template <typename T>
+void transpose_blocked(const T *src, T *dst, size_t rows, size_t cols)
+{
+    const size_t block = 32;
+    parallel_for(0, rows, 4 * block, [=](size_t lo, size_t hi) {
+        for(size_t ib = lo; ib < hi; ib += block)
+        {
+            size_t ie = std::min(ib + block, hi);
+            for(size_t jb = 0; jb < cols; jb += block)
+            {
+                size_t je = std::min(jb + block, cols);
+                for(size_t i = ib; i < ie; ++i)
+                    for(size_t j = jb; j < je; ++j)
+                        dst[j * rows + i] = src[i * cols + j];
+            }
+        }
+    });
+}
+
+#endif //NUMERICALC_TRANSPOSE_HPP
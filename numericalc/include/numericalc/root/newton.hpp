@@ -1,5 +1,5 @@
 /**
- *
+ * Newton-type root finding methods.
  *
  * @file newton.hpp
  * Copyright (c) 2020 Peter Grajcar
@@ -7,4 +7,35 @@
 #ifndef NUMERICALC_NEWTON_HPP
 #define NUMERICALC_NEWTON_HPP
 
+#include <complex>
+#include <vector>
+#include "numericalc/Polynomial.hpp"
+
+/**
+ * Finds all complex roots of polynomial simultaneously by the Aberth–Ehrlich method.
+ *
+ * Every approximation \f$z_k\f$ is updated by the Newton correction \f$N_k = p(z_k) / p'(z_k)\f$
+ * deflated implicitly by the other approximations,
+ * \f[
+ *      z_k \leftarrow z_k - \frac{N_k}{1 - N_k \sum_{j \neq k} \frac{1}{z_k - z_j}}.
+ * \f]
+ * The initial approximations lie on circles whose radii are given by the upper convex hull
+ * of \f$(i, \log |a_i|)\f$ (Newton polygon), so they already match the moduli of the roots.
+ * Approximations of modulus greater than one are evaluated through the reversed polynomial at
+ * \f$1 / z_k\f$, which keeps high degrees from overflowing.
+ *
+ * A root is converged when \f$|p(z_k)|\f$ drops below the running error bound of Horner's
+ * schema, i.e. it is an exact root of a polynomial with coefficients perturbed by a few units
+ * of rounding. From then on it is no longer evaluated or updated. Corrections of one
+ * iteration are computed from the previous approximations, so the roots are split across the
+ * thread pool, evaluation and the sums are vectorised over the roots.
+ *
+ * @tparam T floating point type
+ * @param p polynomial, trailing zero coefficients are ignored
+ * @param max_iterations maximum number of iterations
+ * @return roots, zero roots first, roots which did not converge are the last approximation
+ */
+template <typename T>
+std::vector<std::complex<T>> aberth_roots(const Polynomial<T> &p, size_t max_iterations = 100);
+
 #endif //NUMERICALC_NEWTON_HPP
@@ -5,6 +5,8 @@
  * Copyright (c) 2020 Peter Grajcar
  */
 #include "numericalc/Matrix.hpp"
+#include "numericalc/parallel/thread_pool.hpp"
+#include "numericalc/parallel/transpose.hpp"
 
 template <typename T>
 Matrix<T> Matrix<T>::operator()(size_t i)
@@ -26,11 +28,9 @@ Matrix<T> Matrix<T>::invertElements() const
 template <typename T>
 Matrix<T> Matrix<T>::transpose() const
 {
-    Matrix result(cols, rows, matrix);
-    if(cols == 1 || rows == 1) return result;
-    for(size_t i = 0; i < rows; ++i)
-        for(size_t j = 0; j < cols; ++j)
-            result.matrix[i *rows + j] = matrix[i*cols + j];
+    if(cols == 1 || rows == 1) return Matrix(cols, rows, matrix);
+    Matrix result(cols, rows);
+    transpose_blocked(matrix.data(), result.matrix.data(), rows, cols);
     return result;
 }
 
@@ -75,6 +75,51 @@ Matrix<T> Matrix<T>::operator*(const Matrix<T> &lhs) const
     return result;
 }
 
+template <typename T>
+void Matrix<T>::multiply(const T *x, T *y, bool parallel) const
+{
+    auto block = [this, x, y](size_t lo, size_t hi) {
+        for(size_t i = lo; i < hi; ++i)
+        {
+            const T *row = matrix.data() + i * cols;
+            T sum = 0;
+            for(size_t k = 0; k < cols; ++k)
+                sum += row[k] * x[k];
+            y[i] = sum;
+        }
+    };
+
+    if(parallel)
+        parallel_for(0, rows, std::max<size_t>(1, 65536 / (cols + 1)), block);
+    else
+        block(0, rows);
+}
+
+template <typename T>
+void Matrix<T>::multiply(const T *x, T *y, size_t k, bool parallel) const
+{
+    auto block = [this, x, y, k](size_t lo, size_t hi) {
+        for(size_t i = lo; i < hi; ++i)
+        {
+            const T *row = matrix.data() + i * cols;
+            T *out = y + i * k;
+            std::fill(out, out + k, T(0));
+            for(size_t j = 0; j < cols; ++j)
+            {
+                const T a = row[j];
+                const T *in = x + j * k;
+                for(size_t l = 0; l < k; ++l)
+                    out[l] += a * in[l];
+            }
+        }
+    };
+
+    if(parallel)
+        parallel_for(0, rows, std::max<size_t>(1, 65536 / (cols * k + 1)), block);
+    else
+        block(0, rows);
+}
+
 template <typename T>
 Matrix<T> Matrix<T>::function(T f(T)) const
 {
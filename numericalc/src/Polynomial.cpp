@@ -5,24 +5,116 @@
  * Copyright (c) 2020 Peter Grajcar
  */
 #include "numericalc/Polynomial.hpp"
+#include "numericalc/Modular.hpp"
+#include "numericalc/multiplication/poly_mult.hpp"
+#include "numericalc/parallel/thread_pool.hpp"
+
+/*
+ * Points evaluated together by eval_many, the lanes of the vectorised Horner's schema.
+ */
+static const size_t eval_lanes = 8;
 
 template <typename T>
 T Polynomial<T>::eval(T x) const
 {
     T b = 0;
     if(!deg) return b;
-    for(auto i = coef.rbegin(); i < coef.rend(); ++i) {
-        b *= x;
-        b += *i;
+
+    if(deg < 4 * eval_lanes)
+    {
+        for(size_t i = deg; i-- > 0;)
+            b = b * x + coef[i];
+        return b;
+    }
+
+    // Estrin's scheme on blocks of 8 coefficients, the blocks do not depend on each other
+    const T x2 = x * x, x4 = x2 * x2, x8 = x4 * x4;
+    size_t i = deg;
+    for(; i % 8; --i)
+        b = b * x + coef[i - 1];
+    for(; i; i -= 8)
+    {
+        const T *c = coef.data() + i - 8;
+        T e = ((c[0] + c[1] * x) + (c[2] + c[3] * x) * x2)
+            + ((c[4] + c[5] * x) + (c[6] + c[7] * x) * x2) * x4;
+        b = b * x8 + e;
     }
     return b;
 }
 
+template <typename T>
+void Polynomial<T>::eval_many(const T *xs, T *out, size_t count, bool parallel) const
+{
+    auto block = [this, xs, out](size_t lo, size_t hi) {
+        size_t j = lo;
+        for(; j + eval_lanes <= hi; j += eval_lanes)
+        {
+            T b[eval_lanes] = {}, x[eval_lanes];
+            std::copy(xs + j, xs + j + eval_lanes, x);
+            for(size_t i = deg; i-- > 0;)
+            {
+                const T c = coef[i];
+                for(size_t l = 0; l < eval_lanes; ++l)
+                    b[l] = b[l] * x[l] + c;
+            }
+            std::copy(b, b + eval_lanes, out + j);
+        }
+        for(; j < hi; ++j)
+            out[j] = eval(xs[j]);
+    };
+
+    if(parallel)
+        parallel_for(0, count, 4096, block);
+    else
+        block(0, count);
+}
+
+template <typename T>
+std::vector<T> Polynomial<T>::eval_many(const std::vector<T> &xs, bool parallel) const
+{
+    std::vector<T> out(xs.size());
+    eval_many(xs.data(), out.data(), xs.size(), parallel);
+    return out;
+}
+
+template <typename T>
+void Polynomial<T>::eval_with_derivative(const T *xs, T *values, T *derivatives, size_t count, bool parallel) const
+{
+    // b_i = b_{i+1} x + c_i, d_i = d_{i+1} x + b_{i+1}
+    auto block = [this, xs, values, derivatives](size_t lo, size_t hi) {
+        for(size_t j = lo; j < hi; j += eval_lanes)
+        {
+            const size_t w = std::min(eval_lanes, hi - j);
+            T b[eval_lanes] = {}, d[eval_lanes] = {}, x[eval_lanes] = {};
+            std::copy(xs + j, xs + j + w, x);
+            for(size_t i = deg; i-- > 0;)
+            {
+                const T c = coef[i];
+                for(size_t l = 0; l < eval_lanes; ++l)
+                {
+                    d[l] = d[l] * x[l] + b[l];
+                    b[l] = b[l] * x[l] + c;
+                }
+            }
+            std::copy(b, b + w, values + j);
+            std::copy(d, d + w, derivatives + j);
+        }
+    };
+
+    if(parallel)
+        parallel_for(0, count, 4096, block);
+    else
+        block(0, count);
+}
+
 template <typename T>
 Polynomial<T> Polynomial<T>::derivative() const
 {
-    std::vector<T> d_coef(coef.begin() + 1, coef.end());
-    return Polynomial(std::move(d_coef));
+    if(deg < 2) return Polynomial(0);
+    Polynomial result(deg - 1);
+    for(size_t i = 1; i < deg; ++i)
+        result.coef[i - 1] = coef[i] * (T) i;
+    return result;
 }
 
 template <typename T>
@@ -71,13 +163,12 @@ Polynomial<T> Polynomial<T>::operator-(const Polynomial<T> &q) const
 template <typename T>
 Polynomial<T> Polynomial<T>::operator*(const Polynomial<T> &q) const
 {
-    Polynomial result(deg + q.deg);
-    for(size_t i = 0; i < deg; ++i)
-        for(size_t j = 0; j < q.deg; ++j)
-            result.coef[i + j] += coef[i]*q.coef[j];
-    return result;
+    return poly_mult(*this, q);
 }
 
 template class Polynomial<double>;
 template class Polynomial<float>;
-template class Polynomial<int>;
\ No newline at end of file
+template class Polynomial<int>;
+template class Polynomial<long>;
+template class Polynomial<long long>;
+template class Polynomial<Modular<998244353u>>;
@@ -0,0 +1,133 @@
+/**
+ *
+ *
+ * @file SparseMatrix.cpp
+ * Copyright (c) 2020 Peter Grajcar
+ */
+#include <algorithm>
+#include "numericalc/SparseMatrix.hpp"
+#include "numericalc/parallel/thread_pool.hpp"
+
+template <typename T>
+SparseMatrix<T>::SparseMatrix(size_t m, size_t n, const std::vector<entry> &entries)
+    : rows(m), cols(n), offsets(m + 1, 0)
+{
+    std::vector<entry> sorted(entries);
+    std::sort(sorted.begin(), sorted.end(), [](const entry &a, const entry &b) {
+        return std::get<0>(a) != std::get<0>(b) ? std::get<0>(a) < std::get<0>(b) : std::get<1>(a) < std::get<1>(b);
+    });
+    for(size_t k = 0; k < sorted.size(); ++k)
+    {
+        const size_t i = std::get<0>(sorted[k]), j = std::get<1>(sorted[k]);
+        assert(i < m && j < n);
+        if(k > 0 && i == std::get<0>(sorted[k - 1]) && j == std::get<1>(sorted[k - 1]))
+        {
+            values.back() += std::get<2>(sorted[k]);
+            continue;
+        }
+        columns.push_back(j);
+        values.push_back(std::get<2>(sorted[k]));
+        ++offsets[i + 1];
+    }
+    for(size_t i = 0; i < m; ++i)
+        offsets[i + 1] += offsets[i];
+}
+
+template <typename T>
+SparseMatrix<T>::SparseMatrix(size_t m, size_t n, std::vector<size_t> offsets, std::vector<size_t> columns,
+                              std::vector<T> values)
+    : rows(m), cols(n), offsets(std::move(offsets)), columns(std::move(columns)), values(std::move(values))
+{
+    assert(this->offsets.size() == m + 1 && this->offsets[m] == this->values.size());
+    assert(this->columns.size() == this->values.size());
+}
+
+template <typename T>
+SparseMatrix<T>::SparseMatrix(const Matrix<T> &dense)
+    : rows(dense.get_rows()), cols(dense.get_cols()), offsets(1, 0)
+{
+    for(size_t i = 0; i < rows; ++i)
+    {
+        for(size_t j = 0; j < cols; ++j)
+            if(dense(i, j) != T(0))
+            {
+                columns.push_back(j);
+                values.push_back(dense(i, j));
+            }
+        offsets.push_back(values.size());
+    }
+}
+
+template <typename T>
+T SparseMatrix<T>::operator()(size_t i, size_t j) const
+{
+    assert(i < rows && j < cols);
+    const auto first = columns.begin() + offsets[i], last = columns.begin() + offsets[i + 1];
+    const auto it = std::lower_bound(first, last, j);
+    return it != last && *it == j ? values[it - columns.begin()] : T(0);
+}
+
+template <typename T>
+std::vector<T> SparseMatrix<T>::diagonal() const
+{
+    std::vector<T> d(std::min(rows, cols));
+    for(size_t i = 0; i < d.size(); ++i)
+        d[i] = (*this)(i, i);
+    return d;
+}
+
+template <typename T>
+void SparseMatrix<T>::multiply(const T *x, T *y, bool parallel) const
+{
+    auto block = [this, x, y](size_t lo, size_t hi) {
+        for(size_t i = lo; i < hi; ++i)
+        {
+            T sum = 0;
+            for(size_t k = offsets[i]; k < offsets[i + 1]; ++k)
+                sum += values[k] * x[columns[k]];
+            y[i] = sum;
+        }
+    };
+
+    if(parallel)
+        parallel_for(0, rows, std::max<size_t>(64, 65536 / (nonzeros() / std::max<size_t>(rows, 1) + 1)), block);
+    else
+        block(0, rows);
+}
+
+template <typename T>
+void SparseMatrix<T>::multiply(const T *x, T *y, size_t k, bool parallel) const
+{
+    auto block = [this, x, y, k](size_t lo, size_t hi) {
+        for(size_t i = lo; i < hi; ++i)
+        {
+            T *out = y + i * k;
+            std::fill(out, out + k, T(0));
+            for(size_t e = offsets[i]; e < offsets[i + 1]; ++e)
+            {
+                const T a = values[e];
+                const T *in = x + columns[e] * k;
+                for(size_t l = 0; l < k; ++l)
+                    out[l] += a * in[l];
+            }
+        }
+    };
+
+    if(parallel)
+        parallel_for(0, rows, std::max<size_t>(16, 65536 / ((nonzeros() / std::max<size_t>(rows, 1) + 1) * k)), block);
+    else
+        block(0, rows);
+}
+
+template <typename T>
+Matrix<T> SparseMatrix<T>::dense() const
+{
+    Matrix<T> result(rows, cols);
+    for(size_t i = 0; i < rows; ++i)
+        for(size_t k = offsets[i]; k < offsets[i + 1]; ++k)
+            result(i, columns[k]) = values[k];
+    return result;
+}
+
+template class SparseMatrix<double>;
+template class SparseMatrix<float>;
@@ -0,0 +1,166 @@
+/**
+ *
+ *
+ * @file SparsePolynomial.cpp
+ * Copyright (c) 2020 Peter Grajcar
+ */
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include "numericalc/SparsePolynomial.hpp"
+
+template <typename T>
+const size_t SparsePolynomial<T>::dense_mult_ratio;
+
+template <typename T>
+static T power(T x, size_t e)
+{
+    T r = 1;
+    for(; e; e >>= 1, x = x * x)
+        if(e & 1) r = r * x;
+    return r;
+}
+
+template <typename T>
+SparsePolynomial<T>::SparsePolynomial(const std::vector<term> &terms) : data(terms)
+{
+    normalise();
+}
+
+template <typename T>
+SparsePolynomial<T>::SparsePolynomial(const Polynomial<T> &p)
+{
+    for(size_t i = 0; i < p.degree(); ++i)
+        if(p[i] != T(0))
+            data.push_back(term(i, p[i]));
+}
+
+template <typename T>
+void SparsePolynomial<T>::normalise()
+{
+    std::stable_sort(data.begin(), data.end(), [](const term &a, const term &b) { return a.first < b.first; });
+
+    size_t n = 0;
+    for(size_t i = 0; i < data.size();)
+    {
+        term t = data[i];
+        for(++i; i < data.size() && data[i].first == t.first; ++i)
+            t.second += data[i].second;
+        if(t.second != T(0))
+            data[n++] = t;
+    }
+    data.resize(n);
+}
+
+template <typename T>
+Polynomial<T> SparsePolynomial<T>::dense() const
+{
+    Polynomial<T> p(std::max<size_t>(degree(), 1));
+    for(const term &t : data)
+        p[t.first] = t.second;
+    return p;
+}
+
+template <typename T>
+T SparsePolynomial<T>::eval(T x) const
+{
+    if(data.empty()) return 0;
+
+    T b = data.back().second;
+    for(size_t i = data.size() - 1; i > 0; --i)
+        b = b * power(x, data[i].first - data[i - 1].first) + data[i - 1].second;
+    return b * power(x, data[0].first);
+}
+
+template <typename T>
+SparsePolynomial<T> SparsePolynomial<T>::operator-() const
+{
+    SparsePolynomial result(*this);
+    for(term &t : result.data)
+        t.second = -t.second;
+    return result;
+}
+
+template <typename T>
+SparsePolynomial<T> SparsePolynomial<T>::operator+(const SparsePolynomial<T> &q) const
+{
+    SparsePolynomial result;
+    result.data.reserve(data.size() + q.data.size());
+
+    size_t i = 0, j = 0;
+    while(i < data.size() || j < q.data.size())
+    {
+        if(j == q.data.size() || (i < data.size() && data[i].first < q.data[j].first))
+            result.data.push_back(data[i++]);
+        else if(i == data.size() || q.data[j].first < data[i].first)
+            result.data.push_back(q.data[j++]);
+        else {
+            const T c = data[i].second + q.data[j].second;
+            if(c != T(0))
+                result.data.push_back(term(data[i].first, c));
+            ++i, ++j;
+        }
+    }
+
+    return result;
+}
+
+template <typename T>
+SparsePolynomial<T> SparsePolynomial<T>::operator-(const SparsePolynomial<T> &q) const
+{
+    return *this + -q;
+}
+
+template <typename T>
+SparsePolynomial<T> SparsePolynomial<T>::operator*(const SparsePolynomial<T> &q) const
+{
+    if(data.empty() || q.data.empty())
+        return SparsePolynomial();
+
+    if(data.size() * q.data.size() > dense_mult_ratio * (degree() + q.degree()))
+        return SparsePolynomial(dense() * q.dense());
+
+    // the heap holds one entry (exponent, i, j) per term i of the shorter operand, j is
+    // the next term of the longer one to be multiplied with it
+    const std::vector<term> &f = data.size() <= q.data.size() ? data : q.data;
+    const std::vector<term> &g = data.size() <= q.data.size() ? q.data : data;
+    using entry = std::pair<size_t, std::pair<size_t, size_t>>;
+    std::priority_queue<entry, std::vector<entry>, std::greater<entry>> heap;
+    for(size_t i = 0; i < f.size(); ++i)
+        heap.push(entry(f[i].first + g[0].first, std::make_pair(i, (size_t) 0)));
+
+    SparsePolynomial result;
+    while(!heap.empty())
+    {
+        const size_t e = heap.top().first;
+        T c = 0;
+        while(!heap.empty() && heap.top().first == e)
+        {
+            const size_t i = heap.top().second.first, j = heap.top().second.second;
+            heap.pop();
+            c += f[i].second * g[j].second;
+            if(j + 1 < g.size())
+                heap.push(entry(f[i].first + g[j + 1].first, std::make_pair(i, j + 1)));
+        }
+        if(c != T(0))
+            result.data.push_back(term(e, c));
+    }
+
+    return result;
+}
+
+template <typename T>
+SparsePolynomial<T> SparsePolynomial<T>::operator*(T n) const
+{
+    SparsePolynomial result(*this);
+    for(term &t : result.data)
+        t.second *= n;
+    result.normalise();
+    return result;
+}
+
+template class SparsePolynomial<double>;
+template class SparsePolynomial<float>;
+template class SparsePolynomial<int>;
+template class SparsePolynomial<long>;
+template class SparsePolynomial<long long>;
@@ -0,0 +1,214 @@
+/**
+ *
+ *
+ * @file composition.cpp
+ * Copyright (c) 2020 Peter Grajcar
+ */
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+#include "numericalc/composition/composition.hpp"
+
+/*
+ * Polynomials up to this size are shifted by the classical scheme.
+ */
+static const size_t taylor_shift_threshold = 64;
+
+/*
+ * Parts of the outer polynomial up to this size are composed by Horner's schema.
+ */
+static const size_t compose_threshold = 8;
+
+/*
+ * Integral coefficients are accumulated in the corresponding unsigned type so that overflow
+ * wraps as in poly_mult instead of being undefined.
+ */
+template <typename T, typename = void>
+struct shift_word
+{
+    using type = T;
+};
+
+template <typename T>
+struct shift_word<T, typename std::enable_if<std::is_integral<T>::value>::type>
+{
+    using type = typename std::make_unsigned<T>::type;
+};
+
+/*
+ * Returns a + b.
+ */
+template <typename T>
+static inline T add(T a, T b)
+{
+    using U = typename shift_word<T>::type;
+    return (T) ((U) a + (U) b);
+}
+
+/*
+ * Returns c + a * b.
+ */
+template <typename T>
+static inline T multiply_add(T c, T a, T b)
+{
+    using U = typename shift_word<T>::type;
+    return (T) ((U) c + (U) a * (U) b);
+}
+
+/*
+ * Returns a * b with m + n - 1 coefficients.
+ */
+template <typename T>
+static std::vector<T> mult(const T *a, size_t m, const std::vector<T> &b)
+{
+    Polynomial<T> r = Polynomial<T>(std::vector<T>(a, a + m)) * Polynomial<T>(b);
+    r.coefficients().resize(m + b.size() - 1);
+    return r.coefficients();
+}
+
+/*
+ * Largest j such that 2^j < n, n > 1.
+ */
+static size_t split_exponent(size_t n)
+{
+    size_t j = 0;
+    while(((size_t) 2 << j) < n)
+        ++j;
+    return j;
+}
+
+template <typename T>
+static void shift_classical(T *c, size_t n, T a)
+{
+    for(size_t k = 0; k + 1 < n; ++k)
+        for(size_t j = n - 1; j-- > k;)
+            c[j] = multiply_add(c[j], a, c[j + 1]);
+}
+
+/*
+ * Shifts c[0 .. n) in place, powers[j] = (x + a)^(2^j).
+ */
+template <typename T>
+static void shift_recursive(T *c, size_t n, T a, const std::vector<std::vector<T>> &powers)
+{
+    if(n <= taylor_shift_threshold)
+    {
+        shift_classical(c, n, a);
+        return;
+    }
+
+    const size_t j = split_exponent(n), h = (size_t) 1 << j;
+    shift_recursive(c, h, a, powers);
+    shift_recursive(c + h, n - h, a, powers);
+
+    // c_lo(x + a) + (x + a)^h c_hi(x + a), the product has exactly n coefficients
+    std::vector<T> hi = mult(c + h, n - h, powers[j]);
+    std::fill(c + h, c + n, T(0));
+    for(size_t i = 0; i < n; ++i)
+        c[i] = add(c[i], hi[i]);
+}
+
+/*
+ * Returns c(q) for c[0 .. n), powers[j] = q^(2^j).
+ */
+template <typename T>
+static std::vector<T> compose_recursive(const T *c, size_t n, const std::vector<T> &q,
+                                        const std::vector<std::vector<T>> &powers)
+{
+    if(n <= compose_threshold)
+    {
+        std::vector<T> r(1, c[n - 1]);
+        for(size_t i = n - 1; i-- > 0;)
+        {
+            r = mult(r.data(), r.size(), q);
+            r[0] = add(r[0], c[i]);
+        }
+        return r;
+    }
+
+    const size_t j = split_exponent(n), h = (size_t) 1 << j;
+    std::vector<T> lo = compose_recursive(c, h, q, powers);
+    std::vector<T> hi = compose_recursive(c + h, n - h, q, powers);
+
+    std::vector<T> r = mult(hi.data(), hi.size(), powers[j]);
+    for(size_t i = 0; i < lo.size(); ++i)
+        r[i] = add(r[i], lo[i]);
+    return r;
+}
+
+/*
+ * Returns b^(2^j) for j = 0 .. split_exponent(n).
+ */
+template <typename T>
+static std::vector<std::vector<T>> square_powers(const std::vector<T> &b, size_t n)
+{
+    std::vector<std::vector<T>> powers(1, b);
+    for(size_t j = split_exponent(n); powers.size() <= j;)
+        powers.push_back(mult(powers.back().data(), powers.back().size(), powers.back()));
+    return powers;
+}
+
+template <typename T>
+void taylor_shift_inplace(Polynomial<T> &p, T a)
+{
+    const size_t n = p.degree();
+    if(n <= taylor_shift_threshold)
+    {
+        shift_classical(p.coefficients().data(), n, a);
+        return;
+    }
+
+    std::vector<std::vector<T>> powers = square_powers(std::vector<T>{a, T(1)}, n);
+    shift_recursive(p.coefficients().data(), n, a, powers);
+}
+
+template <typename T>
+Polynomial<T> taylor_shift(const Polynomial<T> &p, T a)
+{
+    Polynomial<T> r(p);
+    taylor_shift_inplace(r, a);
+    return r;
+}
+
+template <typename T>
+void compose_inplace(Polynomial<T> &p, const Polynomial<T> &q)
+{
+    const size_t n = p.degree();
+    if(n < 2) return;
+
+    std::vector<T> inner = q.degree() ? q.coefficients() : std::vector<T>(1, T(0));
+    std::vector<std::vector<T>> powers = square_powers(inner, n);
+    p = Polynomial<T>(compose_recursive(p.coefficients().data(), n, inner, powers));
+}
+
+template <typename T>
+Polynomial<T> compose(const Polynomial<T> &p, const Polynomial<T> &q)
+{
+    Polynomial<T> r(p);
+    compose_inplace(r, q);
+    return r;
+}
+
+template void taylor_shift_inplace(Polynomial<double> &p, double a);
+template void taylor_shift_inplace(Polynomial<float> &p, float a);
+template void taylor_shift_inplace(Polynomial<int> &p, int a);
+template void taylor_shift_inplace(Polynomial<long> &p, long a);
+template void taylor_shift_inplace(Polynomial<long long> &p, long long a);
+
+template Polynomial<double> taylor_shift(const Polynomial<double> &p, double a);
+template Polynomial<float> taylor_shift(const Polynomial<float> &p, float a);
+template Polynomial<int> taylor_shift(const Polynomial<int> &p, int a);
+template Polynomial<long> taylor_shift(const Polynomial<long> &p, long a);
+template Polynomial<long long> taylor_shift(const Polynomial<long long> &p, long long a);
+
+template void compose_inplace(Polynomial<double> &p, const Polynomial<double> &q);
+template void compose_inplace(Polynomial<float> &p, const Polynomial<float> &q);
+template void compose_inplace(Polynomial<int> &p, const Polynomial<int> &q);
+template void compose_inplace(Polynomial<long> &p, const Polynomial<long> &q);
+template void compose_inplace(Polynomial<long long> &p, const Polynomial<long long> &q);
+
+template Polynomial<double> compose(const Polynomial<double> &p, const Polynomial<double> &q);
+template Polynomial<float> compose(const Polynomial<float> &p, const Polynomial<float> &q);
+template Polynomial<int> compose(const Polynomial<int> &p, const Polynomial<int> &q);
+template Polynomial<long> compose(const Polynomial<long> &p, const Polynomial<long> &q);
+template Polynomial<long long> compose(const Polynomial<long long> &p, const Polynomial<long long> &q);
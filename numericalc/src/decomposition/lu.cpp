@@ -4,6 +4,8 @@
  * @file lu.cpp
  * Copyright (c) 2020 Peter Grajcar
  */
+#include <cmath>
+#include <utility>
 #include "numericalc/decomposition/lu.hpp"
 
 template<typename T>
@@ -16,7 +18,7 @@ Matrix<T> lu_decomposition(const Matrix<T> a)
         for (size_t i = 0; i < a.get_cols(); ++i) {
             if (i > m) {
                 T sum_col = 0;
-                for (size_t k = 0; k + 1 < m; ++k)
+                for (size_t k = 0; k < m; ++k)
                     sum_col += lu(i, k) * lu(k, m);
                 lu(i, m) = (a(i, m) - sum_col) / lu(m, m);
             }
@@ -32,6 +34,68 @@ Matrix<T> lu_decomposition(const Matrix<T> a)
     return lu;
 }
 
+template<typename T>
+bool lu_factorize(Matrix<T> &a, std::vector<size_t> &pivot)
+{
+    assert(a.get_rows() == a.get_cols());
+    const size_t n = a.get_rows();
+    T *lu = a.elements().data();
+    pivot.resize(n);
+
+    for (size_t m = 0; m < n; ++m) {
+        size_t p = m;
+        for (size_t i = m + 1; i < n; ++i)
+            if (std::abs(lu[i * n + m]) > std::abs(lu[p * n + m]))
+                p = i;
+        pivot[m] = p;
+        if (lu[p * n + m] == T(0))
+            return false;
+        if (p != m)
+            std::swap_ranges(lu + m * n, lu + (m + 1) * n, lu + p * n);
+
+        // row-wise elimination keeps the inner loop contiguous
+        const T inv = T(1) / lu[m * n + m];
+        for (size_t i = m + 1; i < n; ++i) {
+            T *row = lu + i * n;
+            const T l = row[m] *= inv;
+            const T *top = lu + m * n;
+            for (size_t j = m + 1; j < n; ++j)
+                row[j] -= l * top[j];
+        }
+    }
+
+    return true;
+}
+
+template<typename T>
+void lu_solve(const Matrix<T> &lu, const std::vector<size_t> &pivot, T *b)
+{
+    const size_t n = lu.get_rows();
+    const T *a = lu.elements().data();
+
+    for (size_t m = 0; m < n; ++m)
+        if (pivot[m] != m)
+            std::swap(b[m], b[pivot[m]]);
+    for (size_t i = 1; i < n; ++i) {
+        T sum = b[i];
+        for (size_t k = 0; k < i; ++k)
+            sum -= a[i * n + k] * b[k];
+        b[i] = sum;
+    }
+    for (size_t i = n; i-- > 0;) {
+        T sum = b[i];
+        for (size_t k = i + 1; k < n; ++k)
+            sum -= a[i * n + k] * b[k];
+        b[i] = sum / a[i * n + i];
+    }
+}
+
 template Matrix<double> lu_decomposition(const Matrix<double> a);
 template Matrix<float> lu_decomposition(const Matrix<float> a);
 template Matrix<int> lu_decomposition(const Matrix<int> a);
+
+template bool lu_factorize(Matrix<double> &a, std::vector<size_t> &pivot);
+template bool lu_factorize(Matrix<float> &a, std::vector<size_t> &pivot);
+
+template void lu_solve(const Matrix<double> &lu, const std::vector<size_t> &pivot, double *b);
+template void lu_solve(const Matrix<float> &lu, const std::vector<size_t> &pivot, float *b);
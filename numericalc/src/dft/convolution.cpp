@@ -0,0 +1,136 @@
+/**
+ *
+ *
+ * @file convolution.cpp
+ * Copyright (c) 2020 Peter Grajcar
+ */
+#include <cassert>
+#include <algorithm>
+#include "numericalc/dft/convolution.hpp"
+
+template <typename T>
+Convolver<T>::Convolver(const std::vector<T> &filter, size_t block_size, Method method)
+        : method(method), block(block_size),
+          partitions(std::max<size_t>(1, (filter.size() + block_size - 1) / block_size)),
+          filter_len(filter.size()), plan(2 * block_size),
+          filter_spectra(partitions * (block_size + 1)), delay_line(partitions * (block_size + 1)),
+          head(0), accumulator(block_size + 1),
+          frame(2 * block_size), result(2 * block_size), overlap(block_size),
+          pending(block_size), pending_count(0), consumed(0), emitted(0)
+{
+    assert(block_size > 0 && (block_size & (block_size - 1)) == 0);
+    assert(!filter.empty());
+
+    // H_p = FFT(h_{pB}, ..., h_{pB+B-1}, 0, ..., 0)
+    for(size_t p = 0; p < partitions; ++p)
+    {
+        std::fill(frame.begin(), frame.end(), T(0));
+        size_t end = std::min(filter.size(), (p + 1) * block);
+        std::copy(filter.begin() + p * block, filter.begin() + end, frame.begin());
+        plan.forward(frame.data(), filter_spectra.data() + p * (block + 1));
+    }
+    std::fill(frame.begin(), frame.end(), T(0));
+}
+
+template <typename T>
+void Convolver<T>::reset()
+{
+    std::fill(delay_line.begin(), delay_line.end(), complex(0));
+    std::fill(frame.begin(), frame.end(), T(0));
+    std::fill(overlap.begin(), overlap.end(), T(0));
+    head = 0;
+    pending_count = 0;
+    consumed = 0;
+    emitted = 0;
+}
+
+/*
+ * Convolves the pending block and appends first count output samples to out.
+ */
+template <typename T>
+void Convolver<T>::process_block(std::vector<T> &out, size_t count)
+{
+    const size_t bins = block + 1;
+
+    if(method == overlap_save)
+    {
+        // frame = [previous block, current block]
+        std::copy(frame.begin() + block, frame.end(), frame.begin());
+        std::copy(pending.begin(), pending.end(), frame.begin() + block);
+    }
+    else
+    {
+        // frame = [current block, zeros]
+        std::copy(pending.begin(), pending.end(), frame.begin());
+    }
+
+    complex *x = delay_line.data() + head * bins;
+    plan.forward(frame.data(), x);
+
+    // Y = sum_p X_{k-p} H_p, the product is written out so that the loop vectorises
+    std::fill(accumulator.begin(), accumulator.end(), complex(0));
+    T *acc = reinterpret_cast<T *>(accumulator.data());
+    for(size_t p = 0, slot = head; p < partitions; ++p, slot = slot ? slot - 1 : partitions - 1)
+    {
+        const T *xs = reinterpret_cast<const T *>(delay_line.data() + slot * bins);
+        const T *hs = reinterpret_cast<const T *>(filter_spectra.data() + p * bins);
+        for(size_t k = 0; k < 2 * bins; k += 2)
+        {
+            acc[k]     += xs[k] * hs[k] - xs[k + 1] * hs[k + 1];
+            acc[k + 1] += xs[k] * hs[k + 1] + xs[k + 1] * hs[k];
+        }
+    }
+    head = head + 1 == partitions ? 0 : head + 1;
+
+    plan.inverse(accumulator.data(), result.data());
+
+    if(method == overlap_save)
+    {
+        out.insert(out.end(), result.begin() + block, result.begin() + block + count);
+    }
+    else
+    {
+        for(size_t i = 0; i < count; ++i)
+            out.push_back(result[i] + overlap[i]);
+        std::copy(result.begin() + block, result.end(), overlap.begin());
+    }
+}
+
+template <typename T>
+void Convolver<T>::process(const T *in, size_t count, std::vector<T> &out)
+{
+    consumed += count;
+    while(count)
+    {
+        size_t take = std::min(count, block - pending_count);
+        std::copy(in, in + take, pending.begin() + pending_count);
+        pending_count += take;
+        in += take;
+        count -= take;
+
+        if(pending_count == block)
+        {
+            process_block(out, block);
+            emitted += block;
+            pending_count = 0;
+        }
+    }
+}
+
+template <typename T>
+void Convolver<T>::flush(std::vector<T> &out)
+{
+    const size_t total = consumed + filter_len - 1;
+    while(emitted < total)
+    {
+        std::fill(pending.begin() + pending_count, pending.end(), T(0));
+        size_t count = std::min(block, total - emitted);
+        process_block(out, count);
+        emitted += count;
+        pending_count = 0;
+    }
+    reset();
+}
+
+template class Convolver<double>;
+template class Convolver<float>;
@@ -6,20 +6,58 @@
  */
 #include <complex>
 #include <cmath>
+#include <cassert>
 #include "numericalc/dft/fft.hpp"
+#include "numericalc/parallel/thread_pool.hpp"
+#include "numericalc/parallel/transpose.hpp"
 
 template <typename T>
-Polynomial<std::complex<T>> fft_gen(const Polynomial<std::complex<T>> &p, bool inv)
-{
-    using complex = std::complex<T>;
+const size_t FftPlan<T>::default_four_step_threshold;
 
-    size_t deg = p.degree();
-    if(p.degree() < 2) return p;
+template <typename T>
+FftPlan<T>::FftPlan(size_t n, size_t four_step_threshold) : n(n), n1(0), n2(0), log_n1(0)
+{
     //degree has to be power of two
-    assert((deg & (deg - 1)) == 0);
+    assert(n > 0 && (n & (n - 1)) == 0);
 
-    Polynomial<complex> y(p);
+    if(n < four_step_threshold || n < 4)
+    {
+        twiddle.resize(n / 2);
+        for(size_t j = 0; j < n / 2; ++j)
+        {
+            double angle = 2 * M_PI * j / n;
+            twiddle[j] = complex(cos(angle), sin(angle));
+        }
+        return;
+    }
+
+    size_t log_n = 0;
+    while(((size_t) 1 << log_n) < n)
+        ++log_n;
+    log_n1 = log_n / 2;
+    n1 = (size_t) 1 << log_n1;
+    n2 = n / n1;
+
+    row_plan = std::make_shared<FftPlan>(n1, four_step_threshold);
+    col_plan = n1 == n2 ? row_plan : std::make_shared<FftPlan>(n2, four_step_threshold);
 
+    twiddle_lo.resize(n1);
+    for(size_t j = 0; j < n1; ++j)
+    {
+        double angle = 2 * M_PI * j / n;
+        twiddle_lo[j] = complex(cos(angle), sin(angle));
+    }
+    twiddle_hi.resize(n2);
+    for(size_t j = 0; j < n2; ++j)
+    {
+        double angle = 2 * M_PI * (j * n1) / n;
+        twiddle_hi[j] = complex(cos(angle), sin(angle));
+    }
+}
+
+template <typename T>
+void FftPlan<T>::radix2(complex *y, bool inv) const
+{
     // swap coefficients as they would be swapped by recursion
     // i.e. each recursion splits the polynomial into two
     // one with even coefficients and the other with odd.
@@ -32,40 +70,256 @@ Polynomial<std::complex<T>> fft_gen(const Polynomial<std::complex<T>> &p, bool i
     // even then even then odd and even again. Number which
     // meets this criteria is 4, in binary 0100 which is
     // incidentally 0010 with reversed bits.
-    for(size_t i = 1; i < deg; ++i)
+    // The reversed index j is maintained incrementally.
+    for(size_t i = 1, j = 0; i < n; ++i)
     {
-        size_t k = i, j = 0;
-        for(size_t pow = 1; pow < deg; pow <<= 1)
-        {
-            j <<= 1;
-            j |= k & 1;
-            k >>= 1;
-        }
+        size_t bit = n >> 1;
+        for(; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
 
         if(i < j)
             std::swap(y[i], y[j]);
     }
 
-    for(size_t n = 2; n <= deg; n <<= 1)
+    for(size_t len = 2, stride = n / 2; len <= n; len <<= 1, stride >>= 1)
     {
-        T angle = (inv ? -1 : 1) * 2 * M_PI / n;
-        complex w(cos(angle), sin(angle));
-        for(size_t i = 0; i < deg; i += n)
+        size_t half = len / 2;
+        for(size_t i = 0; i < n; i += len)
         {
-            complex wj(1);
-            for(size_t j = 0; j < n / 2; ++j, wj *= w)
+            for(size_t j = 0; j < half; ++j)
             {
+                complex w = inv ? std::conj(twiddle[j * stride]) : twiddle[j * stride];
                 complex s = y[i + j];
-                complex l = y[i + j + n / 2] * wj;
-                y[i + j]         = s + l;
-                y[i + j + n / 2] = s - l;
+                complex l = y[i + j + half] * w;
+                y[i + j]        = s + l;
+                y[i + j + half] = s - l;
             }
         }
     }
+}
+
+template <typename T>
+void FftPlan<T>::six_step(complex *data, bool inv) const
+{
+    std::vector<complex> scratch(n);
+    complex *s = scratch.data();
+
+    // x[j1 * n2 + j2] is viewed as matrix n1 x n2, transform of length n1 runs over columns
+    transpose_blocked(data, s, n1, n2);
+    parallel_for(0, n2, std::max<size_t>(1, 16384 / n1), [this, s, inv](size_t lo, size_t hi) {
+        for(size_t r = lo; r < hi; ++r)
+        {
+            complex *row = s + r * n1;
+            row_plan->transform(row, inv);
+            for(size_t k = 1; k < n1; ++k)
+            {
+                size_t m = r * k;
+                complex w = twiddle_lo[m & (n1 - 1)] * twiddle_hi[m >> log_n1];
+                row[k] *= inv ? std::conj(w) : w;
+            }
+        }
+    });
+
+    transpose_blocked(s, data, n2, n1);
+    parallel_for(0, n1, std::max<size_t>(1, 16384 / n2), [this, data, inv](size_t lo, size_t hi) {
+        for(size_t r = lo; r < hi; ++r)
+            col_plan->transform(data + r * n2, inv);
+    });
+
+    // X[k1 + n1 * k2] is stored at [k1][k2]
+    transpose_blocked(data, s, n1, n2);
+    parallel_for(0, n, 65536, [data, s](size_t lo, size_t hi) {
+        std::copy(s + lo, s + hi, data + lo);
+    });
+}
+
+template <typename T>
+void FftPlan<T>::transform(complex *data, bool inv) const
+{
+    if(n1)
+        six_step(data, inv);
+    else
+        radix2(data, inv);
+}
+
+template <typename T>
+void FftPlan<T>::forward(complex *data) const
+{
+    transform(data, false);
+}
+
+template <typename T>
+void FftPlan<T>::inverse(complex *data) const
+{
+    transform(data, true);
+    const T scale = T(1) / n;
+    for(size_t i = 0; i < n; ++i)
+        data[i] *= scale;
+}
+
+template <typename T>
+void FftPlan<T>::radix2_lanes(complex *data, size_t stride, size_t lo, size_t hi, bool inv) const
+{
+    // same as radix2 with every element replaced by a row of independent lanes [lo, hi)
+    for(size_t i = 1, j = 0; i < n; ++i)
+    {
+        size_t bit = n >> 1;
+        for(; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+
+        if(i < j)
+            std::swap_ranges(data + i * stride + lo, data + i * stride + hi, data + j * stride + lo);
+    }
+
+    for(size_t len = 2, stride_tw = n / 2; len <= n; len <<= 1, stride_tw >>= 1)
+    {
+        size_t half = len / 2;
+        for(size_t i = 0; i < n; i += len)
+        {
+            for(size_t j = 0; j < half; ++j)
+            {
+                const T wr = twiddle[j * stride_tw].real();
+                const T wi = inv ? -twiddle[j * stride_tw].imag() : twiddle[j * stride_tw].imag();
+                complex *x = data + (i + j) * stride;
+                complex *y = data + (i + j + half) * stride;
+                // explicit complex product keeps the lane loop free of the NaN checks of operator*
+                for(size_t b = lo; b < hi; ++b)
+                {
+                    const T yr = y[b].real(), yi = y[b].imag();
+                    const complex l(yr * wr - yi * wi, yr * wi + yi * wr);
+                    const complex s = x[b];
+                    x[b] = s + l;
+                    y[b] = s - l;
+                }
+            }
+        }
+    }
+}
+
+template <typename T>
+void FftPlan<T>::transform_batch(complex *data, size_t count, size_t stride, size_t dist, bool inv) const
+{
+    if(!count) return;
+
+    if(!n1 && dist == 1 && stride >= count)
+    {
+        // lane blocks are sized so that one block of all n rows stays in cache
+        parallel_for(0, count, std::max<size_t>(8, 16384 / n), [=](size_t lo, size_t hi) {
+            radix2_lanes(data, stride, lo, hi, inv);
+        });
+        return;
+    }
+
+    parallel_for(0, count, std::max<size_t>(1, 16384 / n), [=](size_t lo, size_t hi) {
+        std::vector<complex> buffer(stride == 1 ? 0 : n);
+        for(size_t b = lo; b < hi; ++b)
+        {
+            complex *signal = data + b * dist;
+            if(stride == 1) {
+                transform(signal, inv);
+                continue;
+            }
+            for(size_t j = 0; j < n; ++j)
+                buffer[j] = signal[j * stride];
+            transform(buffer.data(), inv);
+            for(size_t j = 0; j < n; ++j)
+                signal[j * stride] = buffer[j];
+        }
+    });
+}
+
+template <typename T>
+void FftPlan<T>::forward_batch(complex *data, size_t count, size_t stride, size_t dist) const
+{
+    transform_batch(data, count, stride, dist, false);
+}
+
+template <typename T>
+void FftPlan<T>::inverse_batch(complex *data, size_t count, size_t stride, size_t dist) const
+{
+    transform_batch(data, count, stride, dist, true);
+    const T scale = T(1) / n;
+    parallel_for(0, count, std::max<size_t>(1, 65536 / n), [=](size_t lo, size_t hi) {
+        for(size_t b = lo; b < hi; ++b)
+            for(size_t j = 0; j < n; ++j)
+                data[b * dist + j * stride] *= scale;
+    });
+}
+
+template <typename T>
+RealFftPlan<T>::RealFftPlan(size_t n) : n(n), half_plan(n / 2), twiddle(n / 2)
+{
+    assert(n >= 2);
+    for(size_t k = 0; k < n / 2; ++k)
+    {
+        double angle = 2 * M_PI * k / n;
+        twiddle[k] = complex(cos(angle), sin(angle));
+    }
+}
+
+template <typename T>
+void RealFftPlan<T>::forward(const T *in, complex *out) const
+{
+    const size_t h = n / 2;
+
+    // z_m = x_{2m} + i x_{2m+1}
+    for(size_t m = 0; m < h; ++m)
+        out[m] = complex(in[2 * m], in[2 * m + 1]);
+    half_plan.forward(out);
+    out[h] = out[0];
+
+    // E_k = (Z_k + conj(Z_{h-k})) / 2, O_k = (Z_k - conj(Z_{h-k})) / 2i, X_k = E_k + w^k O_k
+    // pairs k and h - k are processed together so that the transform can be done in place
+    const complex half_i(0, T(-0.5));
+    for(size_t k = 0, l = h; k <= l; ++k, --l)
+    {
+        complex zk = out[k], zl = out[l];
+        complex ek = (zk + std::conj(zl)) * T(0.5);
+        complex ok = (zk - std::conj(zl)) * half_i;
+        complex el = (zl + std::conj(zk)) * T(0.5);
+        complex ol = (zl - std::conj(zk)) * half_i;
+        out[k] = ek + (k < h ? twiddle[k] : -complex(1)) * ok;
+        out[l] = el + (l < h ? twiddle[l] : -complex(1)) * ol;
+    }
+}
+
+template <typename T>
+void RealFftPlan<T>::inverse(const complex *in, T *out) const
+{
+    const size_t h = n / 2;
+    // complex values are laid out as pairs of reals, so z_m = x_{2m} + i x_{2m+1} can live in out
+    complex *z = reinterpret_cast<complex *>(out);
+
+    // E_k = (X_k + conj(X_{h-k})) / 2, O_k = (X_k - conj(X_{h-k})) / 2w^k, Z_k = E_k + i O_k
+    for(size_t k = 0; k < h; ++k)
+    {
+        complex xk = in[k], xl = std::conj(in[h - k]);
+        complex ek = (xk + xl) * T(0.5);
+        complex ok = (xk - xl) * T(0.5) * std::conj(twiddle[k]);
+        z[k] = ek + complex(0, 1) * ok;
+    }
+    half_plan.inverse(z);
+}
+
+template <typename T>
+Polynomial<std::complex<T>> fft_gen(const Polynomial<std::complex<T>> &p, bool inv)
+{
+    using complex = std::complex<T>;
+
+    size_t deg = p.degree();
+    if(p.degree() < 2) return p;
+    //degree has to be power of two
+    assert((deg & (deg - 1)) == 0);
+
+    Polynomial<complex> y(p);
+    FftPlan<T> plan(deg);
 
     if(inv)
-        for(size_t i = 0; i < deg; ++i)
-            y[i] /= deg;
+        plan.inverse(y.coefficients().data());
+    else
+        plan.forward(y.coefficients().data());
 
     return y;
 }
@@ -99,11 +353,12 @@ Polynomial<T> fft_mult(const Polynomial<T> &p, const Polynomial<T> &q)
     for(size_t i = 0; i < q.degree(); ++i)
         b[i] = complex(q[i]);
 
-    a = fft(a);
-    b = fft(b);
+    FftPlan<T> plan(deg);
+    plan.forward(a.coefficients().data());
+    plan.forward(b.coefficients().data());
     for(size_t i = 0; i < deg; ++i)
         a[i] *= b[i];
-    a = fft_inv(a);
+    plan.inverse(a.coefficients().data());
 
     Polynomial<T> r(deg);
     for(size_t i = 0; i < deg; ++i)
@@ -112,6 +367,11 @@ Polynomial<T> fft_mult(const Polynomial<T> &p, const Polynomial<T> &q)
     return r;
 }
 
+template class FftPlan<double>;
+template class FftPlan<float>;
+template class RealFftPlan<double>;
+template class RealFftPlan<float>;
+
 template Polynomial<std::complex<double>> fft(const Polynomial<std::complex<double>> &p);
 template Polynomial<std::complex<double>> fft_inv(const Polynomial<std::complex<double>> &p);
-template Polynomial<double> fft_mult(const Polynomial<double> &p, const Polynomial<double> &q);
\ No newline at end of file
+template Polynomial<double> fft_mult(const Polynomial<double> &p, const Polynomial<double> &q);
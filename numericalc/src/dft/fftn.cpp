@@ -0,0 +1,155 @@
+/**
+ *
+ *
+ * @file fftn.cpp
+ * Copyright (c) 2020 Peter Grajcar
+ */
+#include <cassert>
+#include "numericalc/dft/fftn.hpp"
+#include "numericalc/parallel/thread_pool.hpp"
+#include "numericalc/parallel/transpose.hpp"
+
+/*
+ * Transforms row-major array in place along one axis. The array is viewed as
+ * outer x len x inner where inner is the product of the trailing dimensions.
+ */
+template <typename T>
+static void fft_axis(std::complex<T> *data, size_t outer, size_t len, size_t inner, bool inv,
+                     std::complex<T> *scratch)
+{
+    if(len < 2) return;
+    FftPlan<T> plan(len);
+
+    if(inner == 1)
+    {
+        if(inv)
+            plan.inverse_batch(data, outer, 1, len);
+        else
+            plan.forward_batch(data, outer, 1, len);
+        return;
+    }
+
+    const size_t slice = len * inner;
+    parallel_for(0, outer, 1, [=](size_t lo, size_t hi) {
+        for(size_t o = lo; o < hi; ++o)
+            transpose_blocked(data + o * slice, scratch + o * slice, len, inner);
+    });
+    if(inv)
+        plan.inverse_batch(scratch, outer * inner, 1, len);
+    else
+        plan.forward_batch(scratch, outer * inner, 1, len);
+    parallel_for(0, outer, 1, [=](size_t lo, size_t hi) {
+        for(size_t o = lo; o < hi; ++o)
+            transpose_blocked(scratch + o * slice, data + o * slice, inner, len);
+    });
+}
+
+template <typename T>
+static std::vector<std::complex<T>> fftn_gen(std::vector<std::complex<T>> a, const std::vector<size_t> &shape, bool inv)
+{
+    size_t total = 1;
+    for(size_t d : shape)
+    {
+        //dimensions have to be power of two
+        assert(d > 0 && (d & (d - 1)) == 0);
+        total *= d;
+    }
+    assert(total == a.size());
+
+    std::vector<std::complex<T>> scratch(shape.size() > 1 ? total : 0);
+    size_t outer = 1;
+    for(size_t d : shape)
+    {
+        fft_axis(a.data(), outer, d, total / (outer * d), inv, scratch.data());
+        outer *= d;
+    }
+
+    return a;
+}
+
+template <typename T>
+std::vector<std::complex<T>> fftn(const std::vector<std::complex<T>> &a, const std::vector<size_t> &shape)
+{
+    return fftn_gen(a, shape, false);
+}
+
+template <typename T>
+std::vector<std::complex<T>> fftn_inv(const std::vector<std::complex<T>> &a, const std::vector<size_t> &shape)
+{
+    return fftn_gen(a, shape, true);
+}
+
+template <typename T>
+Matrix<std::complex<T>> fft2(const Matrix<std::complex<T>> &a)
+{
+    std::vector<size_t> shape = {a.get_rows(), a.get_cols()};
+    return Matrix<std::complex<T>>(a.get_rows(), a.get_cols(), fftn_gen(a.elements(), shape, false));
+}
+
+template <typename T>
+Matrix<std::complex<T>> fft2_inv(const Matrix<std::complex<T>> &a)
+{
+    std::vector<size_t> shape = {a.get_rows(), a.get_cols()};
+    return Matrix<std::complex<T>>(a.get_rows(), a.get_cols(), fftn_gen(a.elements(), shape, true));
+}
+
+template <typename T>
+Matrix<std::complex<T>> rfft2(const Matrix<T> &a)
+{
+    using complex = std::complex<T>;
+
+    const size_t rows = a.get_rows(), cols = a.get_cols(), half = cols / 2 + 1;
+    RealFftPlan<T> plan(cols);
+    Matrix<complex> result(rows, half);
+
+    const T *src = a.elements().data();
+    complex *dst = result.elements().data();
+    parallel_for(0, rows, std::max<size_t>(1, 16384 / cols), [=, &plan](size_t lo, size_t hi) {
+        for(size_t r = lo; r < hi; ++r)
+            plan.forward(src + r * cols, dst + r * half);
+    });
+
+    std::vector<complex> scratch(rows * half);
+    fft_axis(dst, 1, rows, half, false, scratch.data());
+
+    return result;
+}
+
+template <typename T>
+Matrix<T> rfft2_inv(const Matrix<std::complex<T>> &a, size_t cols)
+{
+    using complex = std::complex<T>;
+
+    const size_t rows = a.get_rows(), half = cols / 2 + 1;
+    assert(a.get_cols() == half);
+    RealFftPlan<T> plan(cols);
+    Matrix<T> result(rows, cols);
+
+    std::vector<complex> spectrum(a.elements());
+    std::vector<complex> scratch(rows * half);
+    fft_axis(spectrum.data(), 1, rows, half, true, scratch.data());
+
+    const complex *src = spectrum.data();
+    T *dst = result.elements().data();
+    parallel_for(0, rows, std::max<size_t>(1, 16384 / cols), [=, &plan](size_t lo, size_t hi) {
+        for(size_t r = lo; r < hi; ++r)
+            plan.inverse(src + r * half, dst + r * cols);
+    });
+
+    return result;
+}
+
+template std::vector<std::complex<double>> fftn(const std::vector<std::complex<double>> &a, const std::vector<size_t> &shape);
+template std::vector<std::complex<double>> fftn_inv(const std::vector<std::complex<double>> &a, const std::vector<size_t> &shape);
+template std::vector<std::complex<float>> fftn(const std::vector<std::complex<float>> &a, const std::vector<size_t> &shape);
+template std::vector<std::complex<float>> fftn_inv(const std::vector<std::complex<float>> &a, const std::vector<size_t> &shape);
+
+template Matrix<std::complex<double>> fft2(const Matrix<std::complex<double>> &a);
+template Matrix<std::complex<double>> fft2_inv(const Matrix<std::complex<double>> &a);
+template Matrix<std::complex<float>> fft2(const Matrix<std::complex<float>> &a);
+template Matrix<std::complex<float>> fft2_inv(const Matrix<std::complex<float>> &a);
+
+template Matrix<std::complex<double>> rfft2(const Matrix<double> &a);
+template Matrix<double> rfft2_inv(const Matrix<std::complex<double>> &a, size_t cols);
+template Matrix<std::complex<float>> rfft2(const Matrix<float> &a);
+template Matrix<float> rfft2_inv(const Matrix<std::complex<float>> &a, size_t cols);
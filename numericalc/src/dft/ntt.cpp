@@ -0,0 +1,383 @@
+/**
+ *
+ *
+ * @file ntt.cpp
+ * Copyright (c) 2020 Peter Grajcar
+ */
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
+#include "numericalc/dft/ntt.hpp"
+#include "numericalc/parallel/thread_pool.hpp"
+
+/*
+ * Primes p = c * 2^k + 1 below 2^31 with primitive root g, ordered by k. The bits column is
+ * floor(log2(p)), the product of the first i primes is at least 2^(sum of bits).
+ */
+struct NttPrime
+{
+    uint32_t p;
+    uint32_t g;
+    unsigned log_len;
+    unsigned bits;
+};
+
+static const NttPrime ntt_primes[] = {
+        {2013265921u, 31, 27, 30},
+        {1811939329u, 13, 26, 30},
+        {469762049u,  3,  26, 28},
+        {2113929217u, 5,  25, 30},
+        {754974721u,  11, 24, 29},
+        {998244353u,  3,  23, 29},
+};
+static const size_t ntt_prime_count = sizeof(ntt_primes) / sizeof(ntt_primes[0]);
+
+/*
+ * Montgomery arithmetic modulo odd p < 2^31 with R = 2^32. Values are kept in [0, p).
+ */
+class Montgomery
+{
+private:
+    uint32_t p, p_neg_inv, r2;
+public:
+    explicit Montgomery(uint32_t p) : p(p)
+    {
+        // Newton iteration for p^-1 mod 2^32, each step doubles the number of correct bits
+        uint32_t inv = p;
+        for(int i = 0; i < 4; ++i)
+            inv *= 2 - p * inv;
+        p_neg_inv = 0u - inv;
+        r2 = (uint32_t) ((((uint64_t) 1 << 32) % p) * (((uint64_t) 1 << 32) % p) % p);
+    }
+
+    inline uint32_t reduce(uint64_t t) const
+    {
+        uint32_t m = (uint32_t) t * p_neg_inv;
+        uint32_t u = (uint32_t) ((t + (uint64_t) m * p) >> 32);
+        return u >= p ? u - p : u;
+    }
+
+    inline uint32_t mul(uint32_t a, uint32_t b) const
+    {
+        return reduce((uint64_t) a * b);
+    }
+
+    inline uint32_t add(uint32_t a, uint32_t b) const
+    {
+        uint32_t s = a + b;
+        return s >= p ? s - p : s;
+    }
+
+    inline uint32_t sub(uint32_t a, uint32_t b) const
+    {
+        return a >= b ? a - b : a + p - b;
+    }
+
+    inline uint32_t to_mont(uint32_t a) const
+    {
+        return mul(a, r2);
+    }
+
+    inline uint32_t from_mont(uint32_t a) const
+    {
+        return reduce(a);
+    }
+
+    uint32_t pow(uint32_t a, uint64_t e) const
+    {
+        uint32_t r = to_mont(1);
+        for(; e; e >>= 1, a = mul(a, a))
+            if(e & 1)
+                r = mul(r, a);
+        return r;
+    }
+};
+
+static uint64_t pow_mod(uint64_t a, uint64_t e, uint64_t m)
+{
+    uint64_t r = 1 % m;
+    for(a %= m; e; e >>= 1, a = a * a % m)
+        if(e & 1)
+            r = r * a % m;
+    return r;
+}
+
+/*
+ * In-place cyclic NTT of length n over Montgomery-form values. tw holds n/2 powers of
+ * the n-th root of unity in Montgomery form.
+ */
+static void ntt_transform(uint32_t *a, size_t n, const std::vector<uint32_t> &tw, const Montgomery &mg)
+{
+    for(size_t i = 1, j = 0; i < n; ++i)
+    {
+        size_t bit = n >> 1;
+        for(; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+
+        if(i < j)
+            std::swap(a[i], a[j]);
+    }
+
+    for(size_t len = 2, stride = n / 2; len <= n; len <<= 1, stride >>= 1)
+    {
+        size_t half = len / 2;
+        for(size_t i = 0; i < n; i += len)
+        {
+            for(size_t j = 0; j < half; ++j)
+            {
+                uint32_t u = a[i + j];
+                uint32_t v = mg.mul(a[i + j + half], tw[j * stride]);
+                a[i + j]        = mg.add(u, v);
+                a[i + j + half] = mg.sub(u, v);
+            }
+        }
+    }
+}
+
+/*
+ * Cyclic convolution of residues modulo prime, result is stored in a in standard form.
+ */
+static void ntt_convolve(std::vector<uint32_t> &a, std::vector<uint32_t> &b, const NttPrime &prime)
+{
+    const size_t n = a.size();
+    Montgomery mg(prime.p);
+
+    uint32_t w = mg.pow(mg.to_mont(prime.g), (prime.p - 1) / n);
+    uint32_t w_inv = mg.pow(w, n - 1);
+    std::vector<uint32_t> tw(n / 2), tw_inv(n / 2);
+    uint32_t wj = mg.to_mont(1), wj_inv = wj;
+    for(size_t j = 0; j < n / 2; ++j)
+    {
+        tw[j] = wj;
+        tw_inv[j] = wj_inv;
+        wj = mg.mul(wj, w);
+        wj_inv = mg.mul(wj_inv, w_inv);
+    }
+
+    for(size_t i = 0; i < n; ++i)
+    {
+        a[i] = mg.to_mont(a[i]);
+        b[i] = mg.to_mont(b[i]);
+    }
+    ntt_transform(a.data(), n, tw, mg);
+    ntt_transform(b.data(), n, tw, mg);
+    for(size_t i = 0; i < n; ++i)
+        a[i] = mg.mul(a[i], b[i]);
+    ntt_transform(a.data(), n, tw_inv, mg);
+
+    // from_mont(x * n^-1) in one step: n^-1 in standard form cancels the Montgomery factor
+    uint32_t n_inv = (uint32_t) pow_mod(n % prime.p, prime.p - 2, prime.p);
+    for(size_t i = 0; i < n; ++i)
+        a[i] = mg.mul(a[i], n_inv);
+}
+
+static unsigned bit_length(uint64_t x)
+{
+    unsigned bits = 0;
+    for(; x; x >>= 1)
+        ++bits;
+    return bits;
+}
+
+template <typename T>
+static uint64_t magnitude(T x)
+{
+    return x < 0 ? 0 - (uint64_t) x : (uint64_t) x;
+}
+
+template <typename T>
+static uint32_t residue(T x, uint32_t p)
+{
+    uint32_t r = (uint32_t) (magnitude(x) % p);
+    return x < 0 && r ? p - r : r;
+}
+
+/*
+ * Chooses the number of primes k and the transform length for the product of p and q. Returns
+ * false if the primes cannot represent the coefficients or do not have roots of unity of the
+ * needed order.
+ */
+template <typename T>
+static bool ntt_plan(const Polynomial<T> &p, const Polynomial<T> &q, size_t &k, size_t &len)
+{
+    const size_t m = p.degree(), n = q.degree();
+    k = 0;
+    len = 0;
+    uint64_t p_max = 0, q_max = 0;
+    for(size_t i = 0; i < m; ++i)
+        p_max = std::max(p_max, magnitude(p[i]));
+    for(size_t i = 0; i < n; ++i)
+        q_max = std::max(q_max, magnitude(q[i]));
+    if(!p_max || !q_max) return true;
+
+    // |c| < 2^bound and the product of primes has to exceed 2|c|
+    unsigned bound = bit_length(p_max) + bit_length(q_max) + bit_length(std::min(m, n));
+    for(unsigned bits = 0; bits < bound + 1; ++k)
+    {
+        if(k == ntt_prime_count)
+            return false;
+        bits += ntt_primes[k].bits;
+    }
+
+    len = 1;
+    while(len < m + n - 1)
+        len <<= 1;
+    return len <= ((size_t) 1 << ntt_primes[k - 1].log_len);
+}
+
+template <typename T>
+bool ntt_supported(const Polynomial<T> &p, const Polynomial<T> &q)
+{
+    size_t k, len;
+    return ntt_plan(p, q, k, len);
+}
+
+template <typename T>
+Polynomial<T> ntt_mult(const Polynomial<T> &p, const Polynomial<T> &q)
+{
+    const size_t m = p.degree(), n = q.degree();
+    Polynomial<T> r(m + n);
+    if(!m || !n) return r;
+
+    size_t k, len;
+    if(!ntt_plan(p, q, k, len))
+        throw std::length_error("ntt_mult: product exceeds the transform length or the coefficient range of the primes");
+    if(!k) return r;
+
+    std::vector<std::vector<uint32_t>> res(k);
+    parallel_for(0, k, 1, [&](size_t lo, size_t hi) {
+        for(size_t i = lo; i < hi; ++i)
+        {
+            const uint32_t mod = ntt_primes[i].p;
+            std::vector<uint32_t> a(len), b(len);
+            for(size_t j = 0; j < m; ++j)
+                a[j] = residue(p[j], mod);
+            for(size_t j = 0; j < n; ++j)
+                b[j] = residue(q[j], mod);
+            ntt_convolve(a, b, ntt_primes[i]);
+            res[i] = std::move(a);
+        }
+    });
+
+    // Garner's algorithm: x = t_0 + t_1 m_0 + t_2 m_0 m_1 + ..., digits t_i in [0, m_i)
+    // prefix[i][j] = m_0 ... m_{j-1} mod m_i, inv[i] = (m_0 ... m_{i-1})^-1 mod m_i
+    std::vector<std::vector<uint64_t>> prefix(k, std::vector<uint64_t>(k));
+    std::vector<uint64_t> inv(k), prefix_wrap(k);
+    for(size_t i = 0; i < k; ++i)
+    {
+        const uint64_t mi = ntt_primes[i].p;
+        uint64_t prod = 1;
+        for(size_t j = 0; j < k; ++j)
+        {
+            prefix[i][j] = prod;
+            prod = prod * ntt_primes[j].p % mi;
+        }
+        inv[i] = pow_mod(prefix[i][i], mi - 2, mi);
+    }
+    uint64_t m_wrap = 1;
+    for(size_t i = 0; i < k; ++i)
+    {
+        prefix_wrap[i] = m_wrap;
+        m_wrap *= ntt_primes[i].p;
+    }
+
+    auto digits = [&](const std::vector<uint64_t> &rem, std::vector<uint64_t> &t) {
+        for(size_t i = 0; i < k; ++i)
+        {
+            const uint64_t mi = ntt_primes[i].p;
+            uint64_t s = 0;
+            for(size_t j = 0; j < i; ++j)
+                s = (s + t[j] * prefix[i][j]) % mi;
+            t[i] = (rem[i] + mi - s) % mi * inv[i] % mi;
+        }
+    };
+
+    // values above (M - 1) / 2 represent negative numbers, (M - 1) / 2 = (m_i - 1) / 2 mod m_i
+    std::vector<uint64_t> half_rem(k), half(k);
+    for(size_t i = 0; i < k; ++i)
+        half_rem[i] = (ntt_primes[i].p - 1) / 2;
+    digits(half_rem, half);
+
+    parallel_for(0, m + n - 1, 4096, [&](size_t lo, size_t hi) {
+        std::vector<uint64_t> rem(k), t(k);
+        for(size_t j = lo; j < hi; ++j)
+        {
+            for(size_t i = 0; i < k; ++i)
+                rem[i] = res[i][j];
+            digits(rem, t);
+
+            uint64_t x = 0;
+            for(size_t i = 0; i < k; ++i)
+                x += t[i] * prefix_wrap[i];
+
+            size_t i = k;
+            while(i-- > 0 && t[i] == half[i])
+                /* nothing */;
+            if(i < k && t[i] > half[i])
+                x -= m_wrap;
+
+            r[j] = (T) x;
+        }
+    });
+
+    return r;
+}
+
+/*
+ * Returns the table entry of prime p, null if p is not an NTT prime.
+ */
+static const NttPrime *find_prime(uint32_t p)
+{
+    for(size_t i = 0; i < ntt_prime_count; ++i)
+        if(ntt_primes[i].p == p)
+            return &ntt_primes[i];
+    return nullptr;
+}
+
+template <uint32_t P>
+bool ntt_supported(const Polynomial<Modular<P>> &p, const Polynomial<Modular<P>> &q)
+{
+    const NttPrime *prime = find_prime(P);
+    if(!prime)
+        return false;
+    size_t len = 1;
+    while(len + 1 < p.degree() + q.degree())
+        len <<= 1;
+    return len <= ((size_t) 1 << prime->log_len);
+}
+
+template <uint32_t P>
+Polynomial<Modular<P>> ntt_mult(const Polynomial<Modular<P>> &p, const Polynomial<Modular<P>> &q)
+{
+    const size_t m = p.degree(), n = q.degree();
+    Polynomial<Modular<P>> r(m + n);
+    if(!m || !n) return r;
+    if(!ntt_supported(p, q))
+        throw std::length_error("ntt_mult: modulus is not an NTT prime or the product is too long");
+
+    size_t len = 1;
+    while(len < m + n - 1)
+        len <<= 1;
+    std::vector<uint32_t> a(len), b(len);
+    for(size_t j = 0; j < m; ++j)
+        a[j] = p[j].value();
+    for(size_t j = 0; j < n; ++j)
+        b[j] = q[j].value();
+    ntt_convolve(a, b, *find_prime(P));
+    for(size_t j = 0; j < m + n - 1; ++j)
+        r[j] = a[j];
+    return r;
+}
+
+template bool ntt_supported(const Polynomial<int> &p, const Polynomial<int> &q);
+template bool ntt_supported(const Polynomial<long> &p, const Polynomial<long> &q);
+template bool ntt_supported(const Polynomial<long long> &p, const Polynomial<long long> &q);
+
+template Polynomial<int> ntt_mult(const Polynomial<int> &p, const Polynomial<int> &q);
+template Polynomial<long> ntt_mult(const Polynomial<long> &p, const Polynomial<long> &q);
+template Polynomial<long long> ntt_mult(const Polynomial<long long> &p, const Polynomial<long long> &q);
+
+template bool ntt_supported<998244353u>(const Polynomial<Modular<998244353u>> &p, const Polynomial<Modular<998244353u>> &q);
+template Polynomial<Modular<998244353u>> ntt_mult<998244353u>(const Polynomial<Modular<998244353u>> &p, const Polynomial<Modular<998244353u>> &q);
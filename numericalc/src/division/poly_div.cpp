@@ -0,0 +1,146 @@
+/**
+ *
+ *
+ * @file poly_div.cpp
+ * Copyright (c) 2020 Peter Grajcar
+ */
+#include <cassert>
+#include <algorithm>
+#include "numericalc/division/poly_div.hpp"
+#include "numericalc/Modular.hpp"
+
+/*
+ * Divisors and quotients shorter than this are divided by classical long division.
+ */
+static const size_t newton_division_threshold = 32;
+
+template <typename T>
+static std::vector<T> mult(const T *a, size_t m, const T *b, size_t n)
+{
+    Polynomial<T> r = Polynomial<T>(std::vector<T>(a, a + m)) * Polynomial<T>(std::vector<T>(b, b + n));
+    r.coefficients().resize(m + n - 1);
+    return r.coefficients();
+}
+
+/*
+ * Returns 1 / f mod x^k computed by Newton iteration g = g (2 - f g), f[0] must be non-zero.
+ */
+template <typename T>
+static std::vector<T> series_inverse(const std::vector<T> &f, size_t k)
+{
+    std::vector<T> g(1, T(1) / f[0]);
+    for(size_t len = 1; len < k;)
+    {
+        len = std::min(2 * len, k);
+        std::vector<T> e = mult(f.data(), std::min(len, f.size()), g.data(), g.size());
+        e.resize(len);
+        for(auto &v : e)
+            v = -v;
+        e[0] += 2;
+        g = mult(g.data(), g.size(), e.data(), e.size());
+        g.resize(len);
+    }
+    g.resize(k);
+    return g;
+}
+
+template <typename T>
+PolyDivisor<T>::PolyDivisor(const Polynomial<T> &b, size_t dividend_size) : divisor(b.coefficients())
+{
+    while(!divisor.empty() && divisor.back() == T(0))
+        divisor.pop_back();
+    assert(!divisor.empty());
+
+    const size_t n = divisor.size();
+    if(dividend_size == 0)
+        dividend_size = 2 * n - 1;
+    if(dividend_size < n)
+        return;
+
+    // longer quotients are computed in chunks of n - 1 coefficients, each costs O(M(n))
+    const size_t k = std::min(dividend_size - n + 1, n - 1);
+    if(k > newton_division_threshold && n > newton_division_threshold)
+        inverse = series_inverse(std::vector<T>(divisor.rbegin(), divisor.rend()), k);
+}
+
+/*
+ * Replaces r by its remainder, stores the quotient in q unless it is null.
+ */
+template <typename T>
+void PolyDivisor<T>::reduce(std::vector<T> &r, std::vector<T> *q) const
+{
+    const size_t nb = divisor.size();
+    const T *b = divisor.data();
+    if(q) q->assign(r.size() >= nb ? r.size() - nb + 1 : 1, T(0));
+    if(r.size() < nb) return;
+
+    if(inverse.empty())
+    {
+        const T lead = b[nb - 1];
+        for(size_t i = r.size(); i >= nb; --i)
+        {
+            const T c = r[i - 1] / lead;
+            if(q) (*q)[i - nb] = c;
+            for(size_t j = 0; j < nb; ++j)
+                r[i - nb + j] -= c * b[j];
+        }
+        r.resize(nb - 1);
+        return;
+    }
+
+    // each step computes c quotient coefficients from the top c coefficients of r
+    while(r.size() >= nb)
+    {
+        const size_t c = std::min(inverse.size(), r.size() - nb + 1);
+        const size_t offset = r.size() - nb + 1 - c;
+
+        std::vector<T> ra(r.rbegin(), r.rbegin() + c);
+        std::vector<T> qr = mult(ra.data(), c, inverse.data(), c);
+        std::vector<T> qc(qr.rend() - c, qr.rend());
+        if(q) std::copy(qc.begin(), qc.end(), q->begin() + offset);
+
+        // the top c coefficients cancel, only the low nb - 1 coefficients of qc b are needed
+        std::vector<T> qb = mult(qc.data(), std::min(c, nb - 1), b, nb - 1);
+        r.resize(offset + nb - 1);
+        for(size_t i = 0; i < nb - 1; ++i)
+            r[offset + i] -= qb[i];
+    }
+}
+
+template <typename T>
+std::pair<Polynomial<T>, Polynomial<T>> PolyDivisor<T>::divmod(const Polynomial<T> &a) const
+{
+    std::vector<T> r(a.coefficients()), q;
+    reduce(r, &q);
+    r.resize(std::max<size_t>(divisor.size() - 1, 1));
+    return std::make_pair(Polynomial<T>(q), Polynomial<T>(r));
+}
+
+template <typename T>
+Polynomial<T> PolyDivisor<T>::quotient(const Polynomial<T> &a) const
+{
+    return divmod(a).first;
+}
+
+template <typename T>
+Polynomial<T> PolyDivisor<T>::remainder(const Polynomial<T> &a) const
+{
+    std::vector<T> r(a.coefficients());
+    reduce(r, nullptr);
+    r.resize(std::max<size_t>(divisor.size() - 1, 1));
+    return Polynomial<T>(r);
+}
+
+template <typename T>
+std::pair<Polynomial<T>, Polynomial<T>> divmod(const Polynomial<T> &a, const Polynomial<T> &b)
+{
+    return PolyDivisor<T>(b, a.degree()).divmod(a);
+}
+
+template class PolyDivisor<double>;
+template class PolyDivisor<float>;
+template class PolyDivisor<Modular<998244353u>>;
+
+template std::pair<Polynomial<double>, Polynomial<double>> divmod(const Polynomial<double> &a, const Polynomial<double> &b);
+template std::pair<Polynomial<float>, Polynomial<float>> divmod(const Polynomial<float> &a, const Polynomial<float> &b);
+template std::pair<Polynomial<Modular<998244353u>>, Polynomial<Modular<998244353u>>> divmod(const Polynomial<Modular<998244353u>> &a, const Polynomial<Modular<998244353u>> &b);
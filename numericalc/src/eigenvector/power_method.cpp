@@ -4,4 +4,268 @@
  * @file power_method.cpp
  * Copyright (c) 2020 Peter Grajcar
  */
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <random>
+#include "numericalc/eigenvector/power_method.hpp"
+#include "numericalc/parallel/thread_pool.hpp"
 
+/*
+ * Rows processed by one task of the block kernels.
+ */
+static const size_t block_chunk = 1024;
+
+template <typename T>
+void symmetric_eigen(size_t m, T *a, T *values, T *vectors)
+{
+    std::fill(vectors, vectors + m * m, T(0));
+    for(size_t i = 0; i < m; ++i)
+        vectors[i * m + i] = 1;
+
+    T total = 0;
+    for(size_t i = 0; i < m * m; ++i)
+        total += a[i] * a[i];
+    const T eps = std::numeric_limits<T>::epsilon();
+
+    for(size_t sweep = 0; sweep < 64; ++sweep)
+    {
+        T off = 0;
+        for(size_t p = 0; p < m; ++p)
+            for(size_t q = p + 1; q < m; ++q)
+                off += a[p * m + q] * a[p * m + q];
+        if(off <= eps * eps * total)
+            break;
+
+        for(size_t p = 0; p < m; ++p)
+            for(size_t q = p + 1; q < m; ++q)
+            {
+                const T apq = a[p * m + q];
+                if(apq == 0)
+                    continue;
+                // rotation annihilating a_pq, Numerical Recipes 11.1
+                const T theta = (a[q * m + q] - a[p * m + p]) / (2 * apq);
+                const T t = (theta >= 0 ? 1 : -1) / (std::abs(theta) + std::sqrt(theta * theta + 1));
+                const T c = 1 / std::sqrt(t * t + 1), s = t * c;
+                for(size_t r = 0; r < m; ++r)
+                {
+                    if(r == p || r == q)
+                        continue;
+                    const T arp = a[r * m + p], arq = a[r * m + q];
+                    a[r * m + p] = a[p * m + r] = c * arp - s * arq;
+                    a[r * m + q] = a[q * m + r] = s * arp + c * arq;
+                }
+                a[p * m + p] -= t * apq;
+                a[q * m + q] += t * apq;
+                a[p * m + q] = a[q * m + p] = 0;
+                for(size_t r = 0; r < m; ++r)
+                {
+                    const T vrp = vectors[r * m + p], vrq = vectors[r * m + q];
+                    vectors[r * m + p] = c * vrp - s * vrq;
+                    vectors[r * m + q] = s * vrp + c * vrq;
+                }
+            }
+    }
+    for(size_t i = 0; i < m; ++i)
+        values[i] = a[i * m + i];
+}
+
+template <typename T>
+void random_vector(T *x, size_t count, uint64_t seed)
+{
+    std::minstd_rand engine((std::minstd_rand::result_type) (seed % (std::minstd_rand::modulus - 1) + 1));
+    const T scale = T(2) / ((T) std::minstd_rand::max() + 1);
+    for(size_t i = 0; i < count; ++i)
+        x[i] = (T) engine() * scale - 1;
+}
+
+template <typename T>
+void block_gram(const T *a, const T *b, size_t n, size_t p, size_t q, T *c, bool parallel)
+{
+    const size_t chunks = (n + block_chunk - 1) / block_chunk;
+    std::vector<T> partial(chunks * p * q, T(0));
+    auto block = [=, &partial](size_t lo, size_t hi) {
+        for(size_t chunk = lo; chunk < hi; ++chunk)
+        {
+            T *out = partial.data() + chunk * p * q;
+            for(size_t i = chunk * block_chunk; i < std::min(n, (chunk + 1) * block_chunk); ++i)
+                for(size_t j = 0; j < p; ++j)
+                {
+                    const T aij = a[i * p + j];
+                    const T *row = b + i * q;
+                    T *cj = out + j * q;
+                    for(size_t l = 0; l < q; ++l)
+                        cj[l] += aij * row[l];
+                }
+        }
+    };
+
+    if(parallel)
+        parallel_for(0, chunks, 1, block);
+    else
+        block(0, chunks);
+
+    std::fill(c, c + p * q, T(0));
+    for(size_t chunk = 0; chunk < chunks; ++chunk)
+        for(size_t i = 0; i < p * q; ++i)
+            c[i] += partial[chunk * p * q + i];
+}
+
+template <typename T>
+void block_combine(const T *a, const T *v, size_t n, size_t p, size_t q, T *b, bool parallel)
+{
+    auto block = [=](size_t lo, size_t hi) {
+        for(size_t i = lo; i < hi; ++i)
+        {
+            T *out = b + i * q;
+            std::fill(out, out + q, T(0));
+            for(size_t j = 0; j < p; ++j)
+            {
+                const T aij = a[i * p + j];
+                const T *row = v + j * q;
+                for(size_t l = 0; l < q; ++l)
+                    out[l] += aij * row[l];
+            }
+        }
+    };
+
+    if(parallel)
+        parallel_for(0, n, block_chunk, block);
+    else
+        block(0, n);
+}
+
+/*
+ * Modified Gram-Schmidt by columns, dependent columns are replaced by random ones.
+ */
+template <typename T>
+static void gram_schmidt(T *x, size_t n, size_t k)
+{
+    uint64_t seed = 0x5eed;
+    for(size_t j = 0; j < k; ++j)
+    {
+        T original = 0;
+        for(size_t i = 0; i < n; ++i)
+            original += x[i * k + j] * x[i * k + j];
+        for(size_t attempt = 0;; ++attempt)
+        {
+            for(size_t pass = 0; pass < 2; ++pass)
+                for(size_t l = 0; l < j; ++l)
+                {
+                    T c = 0;
+                    for(size_t i = 0; i < n; ++i)
+                        c += x[i * k + l] * x[i * k + j];
+                    for(size_t i = 0; i < n; ++i)
+                        x[i * k + j] -= c * x[i * k + l];
+                }
+            T norm = 0;
+            for(size_t i = 0; i < n; ++i)
+                norm += x[i * k + j] * x[i * k + j];
+            if(norm > T(1e-4) * original && norm > 0)
+            {
+                norm = std::sqrt(norm);
+                for(size_t i = 0; i < n; ++i)
+                    x[i * k + j] /= norm;
+                break;
+            }
+            assert(attempt < 8 && k <= n);
+            std::vector<T> column(n);
+            random_vector(column.data(), n, seed++);
+            original = 0;
+            for(size_t i = 0; i < n; ++i)
+            {
+                x[i * k + j] = column[i];
+                original += column[i] * column[i];
+            }
+        }
+    }
+}
+
+template <typename T>
+void block_orthonormalize(T *x, size_t n, size_t k, bool parallel)
+{
+    std::vector<T> g(k * k);
+    const T eps = std::numeric_limits<T>::epsilon();
+    for(size_t pass = 0; pass < 2; ++pass)
+    {
+        // G = X^T X = R^T R
+        block_gram(x, x, n, k, k, g.data(), parallel);
+        for(size_t j = 0; j < k; ++j)
+        {
+            T d = g[j * k + j];
+            for(size_t l = 0; l < j; ++l)
+                d -= g[l * k + j] * g[l * k + j];
+            // the Cholesky factor of an ill-conditioned block is inaccurate
+            if(!(d > 100 * eps * g[j * k + j]))
+            {
+                gram_schmidt(x, n, k);
+                return;
+            }
+            d = std::sqrt(d);
+            g[j * k + j] = d;
+            for(size_t i = j + 1; i < k; ++i)
+            {
+                T s = g[j * k + i];
+                for(size_t l = 0; l < j; ++l)
+                    s -= g[l * k + j] * g[l * k + i];
+                g[j * k + i] = s / d;
+            }
+        }
+
+        // X = X R^{-1} row by row
+        auto block = [&](size_t lo, size_t hi) {
+            for(size_t i = lo; i < hi; ++i)
+            {
+                T *row = x + i * k;
+                for(size_t j = 0; j < k; ++j)
+                {
+                    T s = row[j];
+                    for(size_t l = 0; l < j; ++l)
+                        s -= row[l] * g[l * k + j];
+                    row[j] = s / g[j * k + j];
+                }
+            }
+        };
+        if(parallel)
+            parallel_for(0, n, block_chunk, block);
+        else
+            block(0, n);
+    }
+}
+
+template <typename T>
+void combine_vectors(const T *v, size_t n, size_t m, const T *y, size_t l, T *w, bool parallel)
+{
+    auto block = [=](size_t lo, size_t hi) {
+        for(size_t i = 0; i < l; ++i)
+        {
+            T *out = w + i * n;
+            std::fill(out + lo, out + hi, T(0));
+            for(size_t j = 0; j < m; ++j)
+            {
+                const T c = y[j * l + i];
+                const T *vj = v + j * n;
+                for(size_t r = lo; r < hi; ++r)
+                    out[r] += c * vj[r];
+            }
+        }
+    };
+
+    if(parallel)
+        parallel_for(0, n, block_chunk, block);
+    else
+        block(0, n);
+}
+
+template void symmetric_eigen<double>(size_t, double *, double *, double *);
+template void symmetric_eigen<float>(size_t, float *, float *, float *);
+template void random_vector<double>(double *, size_t, uint64_t);
+template void random_vector<float>(float *, size_t, uint64_t);
+template void block_gram<double>(const double *, const double *, size_t, size_t, size_t, double *, bool);
+template void block_gram<float>(const float *, const float *, size_t, size_t, size_t, float *, bool);
+template void block_combine<double>(const double *, const double *, size_t, size_t, size_t, double *, bool);
+template void block_combine<float>(const float *, const float *, size_t, size_t, size_t, float *, bool);
+template void block_orthonormalize<double>(double *, size_t, size_t, bool);
+template void block_orthonormalize<float>(float *, size_t, size_t, bool);
+template void combine_vectors<double>(const double *, size_t, size_t, const double *, size_t, double *, bool);
+template void combine_vectors<float>(const float *, size_t, size_t, const float *, size_t, float *, bool);
@@ -1,7 +1,183 @@
 /**
  *
  *
- * @file conjugate.hpp
+ * @file conjugate.cpp
  * Copyright (c) 2020 Peter Grajcar
  */
+#include <cassert>
+#include <cmath>
+#include <algorithm>
 #include "numericalc/gradient/conjugate.hpp"
+
+template <typename T>
+JacobiPreconditioner<T>::JacobiPreconditioner(const std::vector<T> &diagonal)
+    : inverse(diagonal.size())
+{
+    for(size_t i = 0; i < diagonal.size(); ++i)
+    {
+        assert(diagonal[i] != T(0));
+        inverse[i] = 1 / diagonal[i];
+    }
+}
+
+template <typename T>
+JacobiPreconditioner<T>::JacobiPreconditioner(const SparseMatrix<T> &matrix)
+    : JacobiPreconditioner(matrix.diagonal())
+{
+}
+
+template <typename T>
+static std::vector<T> dense_diagonal(const Matrix<T> &matrix)
+{
+    std::vector<T> d(std::min(matrix.get_rows(), matrix.get_cols()));
+    for(size_t i = 0; i < d.size(); ++i)
+        d[i] = matrix(i, i);
+    return d;
+}
+
+template <typename T>
+JacobiPreconditioner<T>::JacobiPreconditioner(const Matrix<T> &matrix)
+    : JacobiPreconditioner(dense_diagonal(matrix))
+{
+}
+
+template <typename T>
+void JacobiPreconditioner<T>::operator()(const T *r, T *z) const
+{
+    for(size_t i = 0; i < inverse.size(); ++i)
+        z[i] = inverse[i] * r[i];
+}
+
+template <typename T>
+SsorPreconditioner<T>::SsorPreconditioner(const SparseMatrix<T> &matrix, T omega)
+    : matrix(matrix), diagonal(matrix.get_rows()), omega(omega)
+{
+    assert(matrix.get_rows() == matrix.get_cols() && omega > 0 && omega < 2);
+    const std::vector<size_t> &offsets = matrix.row_offsets(), &columns = matrix.column_indices();
+    for(size_t i = 0; i < diagonal.size(); ++i)
+    {
+        const auto it = std::lower_bound(columns.begin() + offsets[i], columns.begin() + offsets[i + 1], i);
+        assert(it != columns.begin() + offsets[i + 1] && *it == i);
+        diagonal[i] = it - columns.begin();
+    }
+}
+
+template <typename T>
+void SsorPreconditioner<T>::operator()(const T *r, T *z) const
+{
+    const std::vector<size_t> &offsets = matrix.row_offsets(), &columns = matrix.column_indices();
+    const std::vector<T> &values = matrix.elements();
+    const size_t n = diagonal.size();
+
+    // (D + omega L) y = r
+    for(size_t i = 0; i < n; ++i)
+    {
+        T sum = r[i];
+        for(size_t k = offsets[i]; k < diagonal[i]; ++k)
+            sum -= omega * values[k] * z[columns[k]];
+        z[i] = sum / values[diagonal[i]];
+    }
+    // (D + omega L^T) z = D y
+    for(size_t i = n; i-- > 0;)
+    {
+        T sum = 0;
+        for(size_t k = diagonal[i] + 1; k < offsets[i + 1]; ++k)
+            sum += values[k] * z[columns[k]];
+        z[i] -= omega * sum / values[diagonal[i]];
+    }
+    const T scale = omega * (2 - omega);
+    for(size_t i = 0; i < n; ++i)
+        z[i] *= scale;
+}
+
+template <typename T>
+bool IncompleteCholeskyPreconditioner<T>::factorize(const SparseMatrix<T> &matrix, T shift)
+{
+    const std::vector<size_t> &a_offsets = matrix.row_offsets(), &a_columns = matrix.column_indices();
+    const std::vector<T> &a_values = matrix.elements();
+    offsets.assign(1, 0);
+    columns.clear();
+    values.clear();
+
+    for(size_t i = 0; i < n; ++i)
+    {
+        T d = 0;
+        for(size_t k = a_offsets[i]; k < a_offsets[i + 1] && a_columns[k] <= i; ++k)
+        {
+            const size_t j = a_columns[k];
+            if(j == i)
+            {
+                d = a_values[k] * (1 + shift);
+                break;
+            }
+            // l_ij = (a_ij - sum_{c < j} l_ic l_jc) / l_jj over the common pattern of rows i and j
+            T sum = a_values[k];
+            size_t p = offsets[i], q = offsets[j];
+            const size_t p_end = columns.size(), q_end = offsets[j + 1] - 1;
+            while(p < p_end && q < q_end)
+            {
+                if(columns[p] < columns[q])
+                    ++p;
+                else if(columns[q] < columns[p])
+                    ++q;
+                else
+                    sum -= values[p++] * values[q++];
+            }
+            columns.push_back(j);
+            values.push_back(sum / values[q_end]);
+        }
+        for(size_t k = offsets[i]; k < columns.size(); ++k)
+            d -= values[k] * values[k];
+        if(!(d > 0))
+            return false;
+        columns.push_back(i);
+        values.push_back(std::sqrt(d));
+        offsets.push_back(columns.size());
+    }
+    return true;
+}
+
+template <typename T>
+IncompleteCholeskyPreconditioner<T>::IncompleteCholeskyPreconditioner(const SparseMatrix<T> &matrix)
+    : n(matrix.get_rows()), alpha(0)
+{
+    assert(matrix.get_rows() == matrix.get_cols());
+    // Manteuffel's shift, doubled until the pivots stay positive
+    bool factorized = factorize(matrix, alpha);
+    while(!factorized && alpha < T(1e3))
+    {
+        alpha = alpha == 0 ? T(1e-3) : 2 * alpha;
+        factorized = factorize(matrix, alpha);
+    }
+    // a zero or negative diagonal element cannot be fixed by a shift
+    assert(factorized);
+}
+
+template <typename T>
+void IncompleteCholeskyPreconditioner<T>::operator()(const T *r, T *z) const
+{
+    // L y = r
+    for(size_t i = 0; i < n; ++i)
+    {
+        T sum = r[i];
+        const size_t last = offsets[i + 1] - 1;
+        for(size_t k = offsets[i]; k < last; ++k)
+            sum -= values[k] * z[columns[k]];
+        z[i] = sum / values[last];
+    }
+    // L^T z = y, by columns of L^T which are the rows of L
+    for(size_t i = n; i-- > 0;)
+    {
+        const size_t last = offsets[i + 1] - 1;
+        z[i] /= values[last];
+        for(size_t k = offsets[i]; k < last; ++k)
+            z[columns[k]] -= values[k] * z[i];
+    }
+}
+
+template class JacobiPreconditioner<double>;
+template class JacobiPreconditioner<float>;
+template class SsorPreconditioner<double>;
+template class SsorPreconditioner<float>;
+template class IncompleteCholeskyPreconditioner<double>;
+template class IncompleteCholeskyPreconditioner<float>;
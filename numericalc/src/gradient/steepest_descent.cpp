@@ -1,7 +1,109 @@
 /**
  *
  *
- * @file steepest_descent.hpp
+ * @file steepest_descent.cpp
  * Copyright (c) 2020 Peter Grajcar
  */
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include "numericalc/gradient/steepest_descent.hpp"
 
+template <typename T>
+LbfgsMemory<T>::LbfgsMemory(size_t n, size_t m)
+    : n(n), m(m), head(0), count(0), s(n * m), y(n * m), rho(m), alpha(m)
+{
+    assert(m > 0);
+}
+
+template <typename T>
+void LbfgsMemory<T>::clear()
+{
+    head = 0;
+    count = 0;
+}
+
+template <typename T>
+bool LbfgsMemory<T>::push(const T *step, const T *change)
+{
+    T sy = 0, yy = 0;
+    for(size_t i = 0; i < n; ++i)
+    {
+        sy += step[i] * change[i];
+        yy += change[i] * change[i];
+    }
+    if(!(sy > std::numeric_limits<T>::epsilon() * yy))
+        return false;
+
+    std::copy(step, step + n, s.begin() + head * n);
+    std::copy(change, change + n, y.begin() + head * n);
+    rho[head] = 1 / sy;
+    head = (head + 1) % m;
+    count = std::min(count + 1, m);
+    return true;
+}
+
+template <typename T>
+void LbfgsMemory<T>::direction(const T *g, T *d)
+{
+    for(size_t i = 0; i < n; ++i)
+        d[i] = -g[i];
+    if(count == 0)
+        return;
+
+    // newest to oldest
+    for(size_t k = 0; k < count; ++k)
+    {
+        const size_t j = (head + m - 1 - k) % m;
+        const T *sj = s.data() + j * n, *yj = y.data() + j * n;
+        T a = 0;
+        for(size_t i = 0; i < n; ++i)
+            a += sj[i] * d[i];
+        a *= rho[j];
+        alpha[j] = a;
+        for(size_t i = 0; i < n; ++i)
+            d[i] -= a * yj[i];
+    }
+
+    const size_t newest = (head + m - 1) % m;
+    const T *yn = y.data() + newest * n;
+    T yy = 0;
+    for(size_t i = 0; i < n; ++i)
+        yy += yn[i] * yn[i];
+    const T gamma = 1 / (rho[newest] * yy);
+    for(size_t i = 0; i < n; ++i)
+        d[i] *= gamma;
+
+    // oldest to newest
+    for(size_t k = count; k-- > 0;)
+    {
+        const size_t j = (head + m - 1 - k) % m;
+        const T *sj = s.data() + j * n, *yj = y.data() + j * n;
+        T b = 0;
+        for(size_t i = 0; i < n; ++i)
+            b += yj[i] * d[i];
+        b = alpha[j] - rho[j] * b;
+        for(size_t i = 0; i < n; ++i)
+            d[i] += b * sj[i];
+    }
+}
+
+template <typename T>
+T cubic_minimizer(T a, T fa, T da, T b, T fb, T db)
+{
+    // Nocedal and Wright (3.59)
+    const T d1 = da + db - 3 * (fa - fb) / (a - b);
+    const T discriminant = d1 * d1 - da * db;
+    if(!(discriminant >= 0) || a == b)
+        return (a + b) / 2;
+    const T d2 = (b > a ? 1 : -1) * std::sqrt(discriminant);
+    const T denominator = db - da + 2 * d2;
+    if(denominator == 0)
+        return (a + b) / 2;
+    return b - (b - a) * (db + d2 - d1) / denominator;
+}
+
+template class LbfgsMemory<double>;
+template class LbfgsMemory<float>;
+template double cubic_minimizer<double>(double, double, double, double, double, double);
+template float cubic_minimizer<float>(float, float, float, float, float, float);
@@ -0,0 +1,289 @@
+/**
+ *
+ *
+ * @file monte_carlo.cpp
+ * Copyright (c) 2020 Peter Grajcar
+ */
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include "numericalc/integration/monte_carlo.hpp"
+
+/*
+ * Streams of counter_random reserved for the construction of the sequences.
+ */
+static const uint64_t sobol_initial_key = 0x536f626f6cull, sobol_scramble_key = 0x536372616d626c65ull;
+
+/*
+ * Product of polynomials a and b over GF(2) modulo p of given degree.
+ */
+static uint64_t gf2_multiply(uint64_t a, uint64_t b, uint64_t p, unsigned degree)
+{
+    uint64_t product = 0;
+    for(; b; b >>= 1, a <<= 1)
+    {
+        if(a >> degree & 1)
+            a ^= p;
+        if(b & 1)
+            product ^= a;
+    }
+    return product;
+}
+
+static uint64_t gf2_power(uint64_t e, uint64_t p, unsigned degree)
+{
+    uint64_t result = 1, base = degree == 1 ? 1 : 2;
+    for(; e; e >>= 1, base = gf2_multiply(base, base, p, degree))
+        if(e & 1)
+            result = gf2_multiply(result, base, p, degree);
+    return result;
+}
+
+/*
+ * Tests whether x generates the multiplicative group modulo p, i.e. its order is 2^degree - 1.
+ */
+static bool gf2_primitive(uint64_t p, unsigned degree)
+{
+    const uint64_t order = (uint64_t(1) << degree) - 1;
+    if(gf2_power(order, p, degree) != 1)
+        return false;
+    uint64_t rest = order;
+    for(uint64_t q = 2; q <= rest; ++q)
+    {
+        if(rest % q)
+            continue;
+        while(rest % q == 0)
+            rest /= q;
+        if(gf2_power(order / q, p, degree) == 1)
+            return false;
+    }
+    return true;
+}
+
+/*
+ * Primitive polynomials over GF(2) ordered by degree and value, enough for max_dimension.
+ */
+static const std::vector<uint64_t> &primitive_polynomials()
+{
+    static const std::vector<uint64_t> polynomials = []() {
+        std::vector<uint64_t> found;
+        for(unsigned degree = 1; found.size() + 1 < SobolSequence<double>::max_dimension; ++degree)
+            for(uint64_t p = (uint64_t(1) << degree) | 1; p >> degree == 1; p += 2)
+                if(found.size() + 1 < SobolSequence<double>::max_dimension && gf2_primitive(p, degree))
+                    found.push_back(p);
+        return found;
+    }();
+    return polynomials;
+}
+
+static unsigned polynomial_degree(uint64_t p)
+{
+    unsigned degree = 0;
+    while(p >> (degree + 1))
+        ++degree;
+    return degree;
+}
+
+/*
+ * Nested uniform scramble of the binary digits of x, the hash of Laine and Karras applied to
+ * the reversed bits as proposed by Burley, every bit is flipped depending only on the more
+ * significant ones.
+ */
+static uint32_t owen_scramble(uint32_t x, uint32_t seed)
+{
+    auto reverse = [](uint32_t v) {
+        v = (v >> 1 & 0x55555555u) | (v & 0x55555555u) << 1;
+        v = (v >> 2 & 0x33333333u) | (v & 0x33333333u) << 2;
+        v = (v >> 4 & 0x0f0f0f0fu) | (v & 0x0f0f0f0fu) << 4;
+        v = (v >> 8 & 0x00ff00ffu) | (v & 0x00ff00ffu) << 8;
+        return v >> 16 | v << 16;
+    };
+    x = reverse(x);
+    x += seed;
+    x ^= x * 0x6c50b47cu;
+    x ^= x * 0xb82f1e52u;
+    x ^= x * 0xc7afe638u;
+    x ^= x * 0x8d22f6e6u;
+    return reverse(x);
+}
+
+/*
+ * Random bits to a number in [0, 1) with the full precision of T.
+ */
+template <typename T>
+static T unit(uint64_t bits)
+{
+    const int digits = std::numeric_limits<T>::digits;
+    return (T) (bits >> (64 - digits)) * (T(1) / (T) (uint64_t(1) << digits));
+}
+
+template <typename T>
+SobolSequence<T>::SobolSequence(size_t dimension)
+    : dimension(dimension), direction(32 * dimension), scrambled(false)
+{
+    assert(dimension > 0 && dimension <= max_dimension);
+    for(unsigned k = 0; k < 32; ++k)
+        direction[k] = uint32_t(1) << (31 - k);
+
+    const std::vector<uint64_t> &polynomials = primitive_polynomials();
+    uint32_t m[32];
+    for(size_t j = 1; j < dimension; ++j)
+    {
+        const uint64_t p = polynomials[j - 1];
+        const unsigned s = polynomial_degree(p);
+        for(unsigned k = 0; k < s; ++k)
+            m[k] = ((uint32_t) counter_random(sobol_initial_key, 32 * j + k) & ((uint32_t(2) << k) - 1)) | 1;
+        // m_k = 2 a_1 m_{k-1} ^ 4 a_2 m_{k-2} ^ ... ^ 2^s m_{k-s} ^ m_{k-s}
+        for(unsigned k = s; k < 32; ++k)
+        {
+            m[k] = m[k - s] ^ m[k - s] << s;
+            for(unsigned i = 1; i < s; ++i)
+                if(p >> (s - i) & 1)
+                    m[k] ^= m[k - i] << i;
+        }
+        for(unsigned k = 0; k < 32; ++k)
+            direction[32 * j + k] = m[k] << (31 - k);
+    }
+}
+
+template <typename T>
+SobolSequence<T>::SobolSequence(size_t dimension, uint64_t seed)
+    : SobolSequence(dimension)
+{
+    scrambled = true;
+    seeds.resize(dimension);
+    for(size_t j = 0; j < dimension; ++j)
+        seeds[j] = (uint32_t) counter_random(seed ^ sobol_scramble_key, j);
+}
+
+template <typename T>
+void SobolSequence<T>::generate(uint64_t first, size_t count, T *x) const
+{
+    assert(first + count <= uint64_t(1) << 32);
+    const int digits = std::min(32, std::numeric_limits<T>::digits);
+    const T scale = T(1) / (T) (uint64_t(1) << digits);
+    std::vector<uint32_t> state(dimension, 0);
+
+    // the points are taken in Gray code order, consecutive codes differ in one bit
+    const uint64_t gray = first ^ first >> 1;
+    for(unsigned k = 0; k < 32; ++k)
+        if(gray >> k & 1)
+            for(size_t j = 0; j < dimension; ++j)
+                state[j] ^= direction[32 * j + k];
+
+    for(size_t p = 0; p < count; ++p)
+    {
+        if(p > 0)
+        {
+            unsigned k = 0;
+            while(!((first + p) >> k & 1))
+                ++k;
+            for(size_t j = 0; j < dimension; ++j)
+                state[j] ^= direction[32 * j + k];
+        }
+        for(size_t j = 0; j < dimension; ++j)
+        {
+            const uint32_t v = scrambled ? owen_scramble(state[j], seeds[j]) : state[j];
+            x[p * dimension + j] = (T) (v >> (32 - digits)) * scale;
+        }
+    }
+}
+
+template <typename T>
+HaltonSequence<T>::HaltonSequence(size_t dimension)
+    : dimension(dimension), permutations(dimension), shift(dimension, 0)
+{
+    assert(dimension > 0);
+    for(uint32_t b = 2; bases.size() < dimension; ++b)
+    {
+        bool prime = true;
+        for(size_t i = 0; i < bases.size() && bases[i] * bases[i] <= b; ++i)
+            prime = prime && b % bases[i] != 0;
+        if(prime)
+            bases.push_back(b);
+    }
+    for(size_t j = 0; j < dimension; ++j)
+        for(uint32_t i = 0; i < bases[j]; ++i)
+            permutations[j].push_back(i);
+}
+
+template <typename T>
+HaltonSequence<T>::HaltonSequence(size_t dimension, uint64_t seed)
+    : HaltonSequence(dimension)
+{
+    uint64_t counter = 0;
+    for(size_t j = 0; j < dimension; ++j)
+    {
+        // Fisher-Yates on the non-zero digits, zero is fixed so that the leading zeros vanish
+        std::vector<uint32_t> &permutation = permutations[j];
+        for(uint32_t i = bases[j] - 1; i > 1; --i)
+            std::swap(permutation[i], permutation[1 + counter_random(seed, counter++) % i]);
+        shift[j] = unit<double>(counter_random(seed, counter++));
+    }
+}
+
+template <typename T>
+void HaltonSequence<T>::generate(uint64_t first, size_t count, T *x) const
+{
+    const T below_one = std::nextafter(T(1), T(0));
+    for(size_t j = 0; j < dimension; ++j)
+    {
+        const uint32_t b = bases[j];
+        const uint32_t *permutation = permutations[j].data();
+        uint32_t digit[64];
+        double weight[64];
+        size_t length = 0;
+        double r = 0;
+        for(uint64_t i = first; i; i /= b, ++length)
+        {
+            digit[length] = i % b;
+            weight[length] = (length ? weight[length - 1] : 1.0) / b;
+            r += permutation[digit[length]] * weight[length];
+        }
+
+        // the digits of consecutive indices are counted up, the radical inverse follows the
+        // changed digits only
+        for(size_t p = 0; p < count; ++p)
+        {
+            double v = r + shift[j];
+            v -= v >= 1 ? 1 : 0;
+            x[p * dimension + j] = std::min((T) v, below_one);
+
+            for(size_t k = 0;; ++k)
+            {
+                if(k == length)
+                {
+                    digit[k] = 0;
+                    weight[k] = (k ? weight[k - 1] : 1.0) / b;
+                    ++length;
+                }
+                const uint32_t old = permutation[digit[k]];
+                digit[k] = digit[k] + 1 == b ? 0 : digit[k] + 1;
+                r += ((double) permutation[digit[k]] - old) * weight[k];
+                if(digit[k])
+                    break;
+            }
+        }
+    }
+}
+
+template <typename T>
+RandomSequence<T>::RandomSequence(size_t dimension, uint64_t seed)
+    : dimension(dimension), seed(seed)
+{
+    assert(dimension > 0);
+}
+
+template <typename T>
+void RandomSequence<T>::generate(uint64_t first, size_t count, T *x) const
+{
+    for(size_t i = 0; i < count * dimension; ++i)
+        x[i] = unit<T>(counter_random(seed, first * dimension + i));
+}
+
+template class SobolSequence<double>;
+template class SobolSequence<float>;
+template class HaltonSequence<double>;
+template class HaltonSequence<float>;
+template class RandomSequence<double>;
+template class RandomSequence<float>;
@@ -4,4 +4,115 @@
  * @file newton.cpp
  * Copyright (c) 2020 Peter Grajcar
  */
+#include <cassert>
 #include "numericalc/integration/newton.hpp"
+
+/*
+ * Closed Newton-Cotes weights c_j of degree 1 to 4, the rows are padded by zeros.
+ */
+static const double newton_cotes_weights[4][5] = {
+    {1.0 / 2, 1.0 / 2},
+    {1.0 / 3, 4.0 / 3, 1.0 / 3},
+    {3.0 / 8, 9.0 / 8, 9.0 / 8, 3.0 / 8},
+    {14.0 / 45, 64.0 / 45, 24.0 / 45, 64.0 / 45, 14.0 / 45},
+};
+
+/*
+ * Non-negative Kronrod nodes in decreasing order with their Kronrod weights and the Gauss
+ * weights of every other node, tables of QUADPACK.
+ */
+static const double g7k15_nodes[8] = {
+    0.991455371120812639206854697526329, 0.949107912342758524526189684047851,
+    0.864864423359769072789712788640926, 0.741531185599394439863864773280788,
+    0.586087235467691130294144845693013, 0.405845151377397166906606412076961,
+    0.207784955007898467600689403773245, 0.000000000000000000000000000000000,
+};
+static const double g7k15_kronrod[8] = {
+    0.022935322010529224963732008058970, 0.063092092629978553290700663189204,
+    0.104790010322250183839876322541518, 0.140653259715525918745189590510238,
+    0.169004726639267902826583426598550, 0.190350578064785409913256402421014,
+    0.204432940075298892414161999234649, 0.209482141084727828012999174891714,
+};
+static const double g7k15_gauss[4] = {
+    0.129484966168869693270611432679082, 0.279705391489276667901467771423780,
+    0.381830050505118944950369775488975, 0.417959183673469387755102040816327,
+};
+static const double g10k21_nodes[11] = {
+    0.995657163025808080735527280689003, 0.973906528517171720077964012084452,
+    0.930157491355708226001207180059508, 0.865063366688984510732096688423493,
+    0.780817726586416897063717578345042, 0.679409568299024406234327365114874,
+    0.562757134668604683339000099272694, 0.433395394129247190799265943165784,
+    0.294392862701460198131126603103866, 0.148874338981631210884826001129720,
+    0.000000000000000000000000000000000,
+};
+static const double g10k21_kronrod[11] = {
+    0.011694638867371874278064396062192, 0.032558162307964727478818972459390,
+    0.054755896574351996031381300244580, 0.075039674810919952767043140916190,
+    0.093125454583697605535065465083366, 0.109387158802297641899210590325805,
+    0.123491976262065851077208745368761, 0.134709217311473325928054001771707,
+    0.142775938577060080797094273138717, 0.147739104901338491374841515972068,
+    0.149445554002916905664936468389821,
+};
+static const double g10k21_gauss[5] = {
+    0.066671344308688137593568809893332, 0.149451349150580593145776339657697,
+    0.219086362515982043995534934228163, 0.269266719309996355091226921569469,
+    0.295524224714752870173892994651338,
+};
+
+template <typename T>
+static NewtonCotesRule<T> make_newton_cotes(size_t degree)
+{
+    NewtonCotesRule<T> rule;
+    rule.degree = degree;
+    for(size_t j = 0; j <= degree; ++j)
+        rule.weights.push_back((T) newton_cotes_weights[degree - 1][j]);
+    return rule;
+}
+
+template <typename T>
+const NewtonCotesRule<T> &NewtonCotesRule<T>::get(size_t degree)
+{
+    assert(degree >= 1 && degree <= max_degree);
+    static const NewtonCotesRule rules[max_degree] = {
+        make_newton_cotes<T>(1), make_newton_cotes<T>(2), make_newton_cotes<T>(3), make_newton_cotes<T>(4),
+    };
+    return rules[degree - 1];
+}
+
+/*
+ * Expands the half tables, node half - 1 is zero, to all nodes in increasing order.
+ */
+template <typename T>
+static GaussKronrodRule<T> make_gauss_kronrod(const double *nodes, const double *kronrod, const double *gauss,
+                                              size_t half)
+{
+    GaussKronrodRule<T> rule;
+    const size_t m = 2 * half - 1;
+    rule.nodes.resize(m);
+    rule.kronrod_weights.resize(m);
+    rule.gauss_weights.resize(m);
+    for(size_t j = 0; j < half; ++j)
+    {
+        // the Gauss nodes are the odd ones counted from the largest
+        const T w = j % 2 ? (T) gauss[j / 2] : T(0);
+        rule.nodes[j] = -(T) nodes[j];
+        rule.nodes[m - 1 - j] = (T) nodes[j];
+        rule.kronrod_weights[j] = rule.kronrod_weights[m - 1 - j] = (T) kronrod[j];
+        rule.gauss_weights[j] = rule.gauss_weights[m - 1 - j] = w;
+    }
+    return rule;
+}
+
+template <typename T>
+const GaussKronrodRule<T> &GaussKronrodRule<T>::get(size_t points)
+{
+    static const GaussKronrodRule g7k15 = make_gauss_kronrod<T>(g7k15_nodes, g7k15_kronrod, g7k15_gauss, 8);
+    static const GaussKronrodRule g10k21 = make_gauss_kronrod<T>(g10k21_nodes, g10k21_kronrod, g10k21_gauss, 11);
+    assert(points == 15 || points == 21);
+    return points == 15 ? g7k15 : g10k21;
+}
+
+template struct NewtonCotesRule<double>;
+template struct NewtonCotesRule<float>;
+template struct GaussKronrodRule<double>;
+template struct GaussKronrodRule<float>;
@@ -0,0 +1,237 @@
+/**
+ *
+ *
+ * @file barycentric.cpp
+ * Copyright (c) 2020 Peter Grajcar
+ */
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include "numericalc/interpolation/barycentric.hpp"
+#include "numericalc/interpolation/basis_cache.hpp"
+#include "numericalc/parallel/thread_pool.hpp"
+
+/*
+ * Nodes or points summed together, the lanes of the vectorised sums.
+ */
+static const size_t barycentric_lanes = 8;
+
+/*
+ * Products of more factors than this are renormalised so they cannot overflow.
+ */
+static const size_t product_block = 8;
+
+/*
+ * Weights of a general grid, w_j = 1 / prod (x_j - x_k) with the differences scaled by the
+ * capacity, normalised so that the largest one is close to one.
+ */
+template <typename T>
+static std::vector<T> general_weights(const std::vector<T> &grid, T capacity)
+{
+    const size_t n = grid.size();
+    std::vector<T> weight(n);
+    // kept as mantissa and exponent
+    std::vector<int> exponent(n);
+    parallel_for(0, n, 16, [&](size_t lo, size_t hi) {
+        for(size_t j = lo; j < hi; ++j)
+        {
+            T m = 1;
+            int e = 0;
+            for(size_t k = 0; k < n; ++k)
+            {
+                if(k != j) m *= capacity * (grid[j] - grid[k]);
+                if(k % product_block == 0 || k + 1 == n)
+                {
+                    int ex;
+                    m = std::frexp(m, &ex);
+                    e += ex;
+                }
+            }
+            weight[j] = 1 / m;
+            exponent[j] = -e;
+        }
+    });
+    const int top = *std::max_element(exponent.begin(), exponent.end());
+    for(size_t j = 0; j < n; ++j)
+        weight[j] = std::ldexp(weight[j], exponent[j] - top);
+    return weight;
+}
+
+template <typename T>
+BarycentricInterpolator<T>::BarycentricInterpolator(const std::vector<T> &grid, const std::vector<T> &values, Grid kind)
+    : grid(grid), weight(grid.size(), T(1)), value(values), capacity(1)
+{
+    const size_t n = grid.size();
+    assert(n > 0 && values.size() == n);
+
+    // differences scaled by the capacity keep the products of O(1) for well spread grids
+    const auto range = std::minmax_element(grid.begin(), grid.end());
+    if(*range.second > *range.first)
+        capacity = 4 / (*range.second - *range.first);
+
+    const T pi = std::acos(T(-1));
+    switch(kind)
+    {
+        case general: {
+            // the capacity is a function of the grid, so the weights are too
+            const T c = capacity;
+            weight = *basis_cache<T, std::vector<T>>().get(grid, [&grid, c]() { return general_weights(grid, c); }, kind);
+            break;
+        }
+        case equispaced: {
+            // binomial coefficients from the middle outwards, the largest one is one
+            const size_t mid = (n - 1) / 2;
+            weight[mid] = mid % 2 ? T(-1) : T(1);
+            for(size_t j = mid; j > 0; --j)
+                weight[j - 1] = -weight[j] * (T) j / (T) (n - j);
+            for(size_t j = mid; j + 1 < n; ++j)
+                weight[j + 1] = -weight[j] * (T) (n - 1 - j) / (T) (j + 1);
+            break;
+        }
+        case chebyshev_first:
+            for(size_t j = 0; j < n; ++j)
+                weight[j] = (j % 2 ? -1 : 1) * std::sin((2 * j + 1) * pi / (2 * n));
+            break;
+        case chebyshev_second:
+            for(size_t j = 0; j < n; ++j)
+                weight[j] = (j % 2 ? -1 : 1) * (j == 0 || j + 1 == n ? T(0.5) : T(1));
+            if(n == 1) weight[0] = 1;
+            break;
+    }
+}
+
+template <typename T>
+void BarycentricInterpolator<T>::normalise()
+{
+    T top = 0;
+    for(T w : weight)
+        top = std::max(top, std::abs(w));
+    if(!(top > 0) || !std::isfinite(top)) return;
+
+    int ex;
+    std::frexp(top, &ex);
+    for(T &w : weight)
+        w = std::ldexp(w, -ex);
+}
+
+template <typename T>
+void BarycentricInterpolator<T>::set_values(const std::vector<T> &values)
+{
+    assert(values.size() == grid.size());
+    value = values;
+}
+
+template <typename T>
+void BarycentricInterpolator<T>::add_node(T x, T y)
+{
+    const size_t n = grid.size();
+
+    // the stored weights differ from the true ones by a common factor, the new weight is
+    // derived from w_0 as w_x = w_0 prod_{k > 0} (x_0 - x_k) / (x - x_k) / (x - x_0)
+    T m = weight[0] / (capacity * (x - grid[0]));
+    int e = 0;
+    for(size_t k = 1; k < n; ++k)
+    {
+        m *= (grid[0] - grid[k]) / (x - grid[k]);
+        if(k % product_block == 0)
+        {
+            int ex;
+            m = std::frexp(m, &ex);
+            e += ex;
+        }
+    }
+
+    for(size_t j = 0; j < n; ++j)
+        weight[j] /= capacity * (grid[j] - x);
+
+    // bring the old weights to the scale of the new one if it would not be representable
+    int top;
+    std::frexp(*std::max_element(weight.begin(), weight.end(), [](T a, T b) { return std::abs(a) < std::abs(b); }), &top);
+    for(T &w : weight)
+        w = std::ldexp(w, -top);
+    grid.push_back(x);
+    value.push_back(y);
+    weight.push_back(std::ldexp(m, e - top));
+    normalise();
+}
+
+template <typename T>
+T BarycentricInterpolator<T>::eval(T x) const
+{
+    const size_t n = grid.size();
+    T num[barycentric_lanes] = {}, den[barycentric_lanes] = {};
+
+    size_t j = 0;
+    for(; j + barycentric_lanes <= n; j += barycentric_lanes)
+        for(size_t l = 0; l < barycentric_lanes; ++l)
+        {
+            const T t = weight[j + l] / (x - grid[j + l]);
+            num[l] += t * value[j + l];
+            den[l] += t;
+        }
+    for(; j < n; ++j)
+    {
+        const T t = weight[j] / (x - grid[j]);
+        num[0] += t * value[j];
+        den[0] += t;
+    }
+
+    T a = 0, b = 0;
+    for(size_t l = 0; l < barycentric_lanes; ++l)
+    {
+        a += num[l];
+        b += den[l];
+    }
+    const T r = a / b;
+    if(std::isfinite(r)) return r;
+
+    // x is a node
+    for(j = 0; j < n; ++j)
+        if(x == grid[j]) return value[j];
+    return r;
+}
+
+template <typename T>
+void BarycentricInterpolator<T>::eval_many(const T *xs, T *out, size_t count, bool parallel) const
+{
+    auto block = [this, xs, out](size_t lo, size_t hi) {
+        for(size_t j = lo; j < hi; j += barycentric_lanes)
+        {
+            const size_t w = std::min(barycentric_lanes, hi - j);
+            T x[barycentric_lanes], num[barycentric_lanes] = {}, den[barycentric_lanes] = {};
+            for(size_t l = 0; l < barycentric_lanes; ++l)
+                x[l] = xs[j + std::min(l, w - 1)];
+            for(size_t k = 0; k < grid.size(); ++k)
+            {
+                const T wk = weight[k], gk = grid[k], vk = value[k];
+                for(size_t l = 0; l < barycentric_lanes; ++l)
+                {
+                    const T t = wk / (x[l] - gk);
+                    num[l] += t * vk;
+                    den[l] += t;
+                }
+            }
+            for(size_t l = 0; l < w; ++l)
+            {
+                const T r = num[l] / den[l];
+                out[j + l] = std::isfinite(r) ? r : eval(x[l]);
+            }
+        }
+    };
+
+    if(parallel)
+        parallel_for(0, count, 64, block);
+    else
+        block(0, count);
+}
+
+template <typename T>
+std::vector<T> BarycentricInterpolator<T>::eval_many(const std::vector<T> &xs, bool parallel) const
+{
+    std::vector<T> out(xs.size());
+    eval_many(xs.data(), out.data(), xs.size(), parallel);
+    return out;
+}
+
+template class BarycentricInterpolator<double>;
+template class BarycentricInterpolator<float>;
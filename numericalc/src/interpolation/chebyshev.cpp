@@ -0,0 +1,165 @@
+/**
+ *
+ *
+ * @file chebyshev.cpp
+ * Copyright (c) 2020 Peter Grajcar
+ */
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <algorithm>
+#include "numericalc/interpolation/chebyshev.hpp"
+#include "numericalc/dft/fft.hpp"
+#include "numericalc/parallel/thread_pool.hpp"
+
+/*
+ * Points evaluated together, the lanes of the vectorised recurrence.
+ */
+static const size_t chebyshev_lanes = 8;
+
+/*
+ * Interpolants of up to this many values are computed by the direct O(n^2) DCT.
+ */
+static const size_t chebyshev_direct_threshold = 33;
+
+template <typename T>
+ChebyshevApproximation<T>::ChebyshevApproximation(const std::vector<T> &coefficients, T a, T b)
+    : coefficient(coefficients), lower(a), upper(b)
+{
+    assert(!coefficients.empty() && a < b);
+}
+
+template <typename T>
+std::vector<T> ChebyshevApproximation<T>::points(size_t n, T a, T b)
+{
+    std::vector<T> x(n, (a + b) / 2);
+    const T pi = std::acos(T(-1));
+    // sin of the angle from pi / 2 keeps the points symmetric
+    for(size_t j = 0; n > 1 && j < n; ++j)
+        x[j] = (a + b) / 2 + (b - a) / 2 * std::sin(pi * ((T) (n - 1) - 2 * (T) j) / (2 * (T) (n - 1)));
+    return x;
+}
+
+template <typename T>
+ChebyshevApproximation<T> ChebyshevApproximation<T>::interpolate(const std::vector<T> &values, T a, T b)
+{
+    const size_t n = values.size();
+    assert(n > 0 && ((n - 1) & (n - 2)) == 0);
+    if(n == 1)
+        return ChebyshevApproximation(values, a, b);
+
+    // DCT-I, c_k = 2 / N sum_j'' f_j cos(pi j k / N) halved for k = 0 and k = N
+    const size_t m = n - 1;
+    std::vector<T> c(n);
+    if(n <= chebyshev_direct_threshold)
+    {
+        const T pi = std::acos(T(-1));
+        for(size_t k = 0; k < n; ++k)
+        {
+            T s = (values[0] + (k % 2 ? -values[m] : values[m])) / 2;
+            for(size_t j = 1; j < m; ++j)
+                s += values[j] * std::cos(pi * (T) ((j * k) % (2 * m)) / (T) m);
+            c[k] = 2 * s / (T) m;
+        }
+    }
+    else
+    {
+        // the real transform of the even extension f_0 .. f_N, f_{N-1} .. f_1 is real
+        std::vector<T> extension(2 * m);
+        std::copy(values.begin(), values.end(), extension.begin());
+        std::reverse_copy(values.begin() + 1, values.end() - 1, extension.begin() + n);
+        std::vector<std::complex<T>> spectrum(m + 1);
+        RealFftPlan<T>(2 * m).forward(extension.data(), spectrum.data());
+        for(size_t k = 0; k < n; ++k)
+            c[k] = spectrum[k].real() / (T) m;
+    }
+    c[0] /= 2;
+    c[m] /= 2;
+    return ChebyshevApproximation(c, a, b);
+}
+
+template <typename T>
+bool ChebyshevApproximation<T>::converged(T tolerance) const
+{
+    // the last three coefficients, a single one may vanish for even or odd functions
+    const size_t n = coefficient.size();
+    if(n < 3)
+        return true;
+    T scale = 0;
+    for(T c : coefficient)
+        scale = std::max(scale, std::abs(c));
+    for(size_t k = n - 3; k < n; ++k)
+        if(std::abs(coefficient[k]) > tolerance * scale)
+            return false;
+    return true;
+}
+
+template <typename T>
+void ChebyshevApproximation<T>::truncate(T tolerance)
+{
+    T scale = 0;
+    for(T c : coefficient)
+        scale = std::max(scale, std::abs(c));
+    size_t n = coefficient.size();
+    while(n > 1 && std::abs(coefficient[n - 1]) <= tolerance * scale)
+        --n;
+    coefficient.resize(n);
+}
+
+template <typename T>
+T ChebyshevApproximation<T>::eval(T x) const
+{
+    // b_k = c_k + 2t b_{k+1} - b_{k+2}, f = c_0 + t b_1 - b_2
+    const T t = (2 * x - lower - upper) / (upper - lower);
+    const T t2 = 2 * t;
+    T b1 = 0, b2 = 0;
+    for(size_t k = coefficient.size(); k-- > 1;)
+    {
+        const T b0 = coefficient[k] + t2 * b1 - b2;
+        b2 = b1;
+        b1 = b0;
+    }
+    return coefficient[0] + t * b1 - b2;
+}
+
+template <typename T>
+void ChebyshevApproximation<T>::eval_many(const T *xs, T *out, size_t count, bool parallel) const
+{
+    auto block = [this, xs, out](size_t lo, size_t hi) {
+        for(size_t j = lo; j < hi; j += chebyshev_lanes)
+        {
+            const size_t w = std::min(chebyshev_lanes, hi - j);
+            T t[chebyshev_lanes], b1[chebyshev_lanes] = {}, b2[chebyshev_lanes] = {};
+            for(size_t l = 0; l < chebyshev_lanes; ++l)
+                t[l] = (2 * xs[j + std::min(l, w - 1)] - lower - upper) / (upper - lower);
+            for(size_t k = coefficient.size(); k-- > 1;)
+            {
+                const T ck = coefficient[k];
+                for(size_t l = 0; l < chebyshev_lanes; ++l)
+                {
+                    const T b0 = ck + 2 * t[l] * b1[l] - b2[l];
+                    b2[l] = b1[l];
+                    b1[l] = b0;
+                }
+            }
+            for(size_t l = 0; l < w; ++l)
+                out[j + l] = coefficient[0] + t[l] * b1[l] - b2[l];
+        }
+    };
+
+    if(parallel)
+        parallel_for(0, count, 256, block);
+    else
+        block(0, count);
+}
+
+template <typename T>
+std::vector<T> ChebyshevApproximation<T>::eval_many(const std::vector<T> &xs, bool parallel) const
+{
+    std::vector<T> out(xs.size());
+    eval_many(xs.data(), out.data(), xs.size(), parallel);
+    return out;
+}
+
+template class ChebyshevApproximation<double>;
+template class ChebyshevApproximation<float>;
@@ -1,6 +1,215 @@
 /**
  *
  *
- * @file cubic_cpline.cpp
+ * @file cubic_spline.cpp
  * Copyright (c) 2020 Peter Grajcar
- */
\ No newline at end of file
+ */
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include "numericalc/interpolation/cubic_spline.hpp"
+#include "numericalc/parallel/thread_pool.hpp"
+
+/*
+ * Intervals walked from the previous point in eval_many before falling back to the lookup.
+ */
+static const size_t spline_walk_limit = 8;
+
+template <typename T>
+CubicSpline<T>::CubicSpline(const std::vector<T> &grid, const std::vector<T> &values, Boundary boundary, T left, T right)
+    : knot(grid), coefficient(4 * (grid.size() - 1)), uniform(false), inverse_step(0)
+{
+    const size_t n = grid.size();
+    assert(n > 1 && values.size() == n);
+
+    std::vector<T> h(n - 1), d(n - 1);
+    for(size_t i = 0; i + 1 < n; ++i)
+    {
+        h[i] = grid[i + 1] - grid[i];
+        assert(h[i] > 0);
+        d[i] = (values[i + 1] - values[i]) / h[i];
+    }
+
+    // not-a-knot spline of three points is the parabola through them, of two points the line
+    if(boundary == not_a_knot && n == 3)
+    {
+        const T c = (d[1] - d[0]) / (h[0] + h[1]);
+        boundary = clamped;
+        left = d[0] - c * h[0];
+        right = d[0] + c * (h[0] + 2 * h[1]);
+    }
+    else if(boundary == not_a_knot && n == 2)
+        boundary = natural;
+
+    // row i of the system for the slopes, l s_{i-1} + m s_i + u s_{i+1} = r
+    auto row = [&](size_t i, T &l, T &m, T &u, T &r) {
+        if(i == 0)
+        {
+            l = 0;
+            switch(boundary)
+            {
+                case natural: m = 2; u = 1; r = 3 * d[0]; break;
+                case clamped: m = 1; u = 0; r = left; break;
+                case not_a_knot:
+                    m = h[1];
+                    u = h[0] + h[1];
+                    r = ((h[0] + 2 * u) * h[1] * d[0] + h[0] * h[0] * d[1]) / u;
+                    break;
+            }
+        }
+        else if(i + 1 == n)
+        {
+            u = 0;
+            switch(boundary)
+            {
+                case natural: l = 1; m = 2; r = 3 * d[n - 2]; break;
+                case clamped: l = 0; m = 1; r = right; break;
+                case not_a_knot:
+                    l = h[n - 3] + h[n - 2];
+                    m = h[n - 3];
+                    r = (h[n - 2] * h[n - 2] * d[n - 3] + (2 * l + h[n - 2]) * h[n - 3] * d[n - 2]) / l;
+                    break;
+            }
+        }
+        else
+        {
+            l = h[i];
+            m = 2 * (h[i - 1] + h[i]);
+            u = h[i - 1];
+            r = 3 * (h[i] * d[i - 1] + h[i - 1] * d[i]);
+        }
+    };
+
+    // Thomas algorithm, the rows are formed on the fly
+    std::vector<T> slope(n), upper(n);
+    T l = 0, m = 1, u = 0, r = 0;
+    for(size_t i = 0; i < n; ++i)
+    {
+        row(i, l, m, u, r);
+        const T pivot = i ? m - l * upper[i - 1] : m;
+        upper[i] = u / pivot;
+        slope[i] = (i ? r - l * slope[i - 1] : r) / pivot;
+    }
+    for(size_t i = n - 1; i-- > 0;)
+        slope[i] -= upper[i] * slope[i + 1];
+
+    parallel_for(0, n - 1, 4096, [&](size_t lo, size_t hi) {
+        for(size_t i = lo; i < hi; ++i)
+        {
+            T *c = coefficient.data() + 4 * i;
+            c[0] = values[i];
+            c[1] = slope[i];
+            c[2] = (3 * d[i] - 2 * slope[i] - slope[i + 1]) / h[i];
+            c[3] = (slope[i] + slope[i + 1] - 2 * d[i]) / (h[i] * h[i]);
+        }
+    });
+
+    // uniform grids up to rounding of the grid points are looked up directly
+    const T step = (grid[n - 1] - grid[0]) / (T) (n - 1);
+    const T tolerance = 8 * std::numeric_limits<T>::epsilon() * std::max(std::abs(grid[0]), std::abs(grid[n - 1]));
+    uniform = true;
+    for(size_t i = 0; i < n && uniform; ++i)
+        uniform = std::abs(grid[i] - (grid[0] + (T) i * step)) <= tolerance;
+    inverse_step = 1 / step;
+
+    // other grids split the range into buckets of the average interval width, the bucket of a
+    // point bounds the binary search to the few intervals it overlaps
+    if(!uniform)
+    {
+        guide.resize(n);
+        size_t i = 0;
+        for(size_t b = 0; b < n; ++b)
+        {
+            const T x = grid[0] + (T) b * step;
+            while(i + 2 < n && grid[i + 1] <= x)
+                ++i;
+            guide[b] = i;
+        }
+    }
+}
+
+template <typename T>
+size_t CubicSpline<T>::search(T x) const
+{
+    // largest i < n - 1 with x_i <= x, the loop has no data dependent branches
+    const T f = (x - knot[0]) * inverse_step;
+    const size_t last = guide.size() - 1;
+    const size_t b = f > 0 ? (f < (T) last ? (size_t) f : last) : 0;
+    const T *base = knot.data() + guide[b];
+    size_t length = guide[b < last ? b + 1 : last] - guide[b] + 1;
+    while(length > 1)
+    {
+        const size_t half = length / 2;
+        base = base[half] <= x ? base + half : base;
+        length -= half;
+    }
+    return base - knot.data();
+}
+
+template <typename T>
+size_t CubicSpline<T>::interval(T x) const
+{
+    if(!uniform)
+        return search(x);
+
+    // a point next to a knot may land in the neighbouring interval, the spline is smooth there
+    const T f = (x - knot[0]) * inverse_step;
+    const size_t last = knot.size() - 2;
+    if(!(f > 0))
+        return 0;
+    if(f >= (T) last)
+        return last;
+    return (size_t) f;
+}
+
+template <typename T>
+T CubicSpline<T>::eval(T x) const
+{
+    return eval_interval(interval(x), x);
+}
+
+template <typename T>
+void CubicSpline<T>::eval_many(const T *xs, T *out, size_t count, bool parallel) const
+{
+    auto block = [this, xs, out](size_t lo, size_t hi) {
+        const size_t last = knot.size() - 2;
+        size_t i = interval(xs[lo]);
+        for(size_t j = lo; j < hi; ++j)
+        {
+            const T x = xs[j];
+            if(x < knot[i])
+                i = interval(x);
+            else
+            {
+                size_t steps = 0;
+                while(i < last && x >= knot[i + 1] && steps < spline_walk_limit)
+                {
+                    ++i;
+                    ++steps;
+                }
+                if(i < last && x >= knot[i + 1])
+                    i = interval(x);
+            }
+            out[j] = eval_interval(i, x);
+        }
+    };
+
+    if(count == 0)
+        return;
+    if(parallel)
+        parallel_for(0, count, 4096, block);
+    else
+        block(0, count);
+}
+
+template <typename T>
+std::vector<T> CubicSpline<T>::eval_many(const std::vector<T> &xs, bool parallel) const
+{
+    std::vector<T> out(xs.size());
+    eval_many(xs.data(), out.data(), xs.size(), parallel);
+    return out;
+}
+
+template class CubicSpline<double>;
+template class CubicSpline<float>;
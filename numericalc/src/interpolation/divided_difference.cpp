@@ -0,0 +1,89 @@
+/**
+ *
+ *
+ * @file divided_difference.cpp
+ * Copyright (c) 2020 Peter Grajcar
+ */
+#include <cassert>
+#include "numericalc/interpolation/divided_difference.hpp"
+
+template <typename T>
+NewtonInterpolator<T>::NewtonInterpolator(const std::vector<T> &grid, const std::vector<T> &values, size_t window)
+    : window(window)
+{
+    assert(grid.size() == values.size());
+    const size_t first = window && grid.size() > window ? grid.size() - window : 0;
+    this->grid.reserve(grid.size() - first);
+    coefficient.reserve(grid.size() - first);
+    row.reserve(grid.size() - first);
+    for(size_t i = first; i < grid.size(); ++i)
+        add_point(grid[i], values[i]);
+}
+
+template <typename T>
+void NewtonInterpolator<T>::add_point(T x, T y)
+{
+    if(window && grid.size() == window)
+        remove_oldest();
+
+    // f[x_j .. x_n] = (f[x_{j+1} .. x_n] - f[x_j .. x_{n-1}]) / (x_n - x_j) from j = n - 1 down
+    T next = y;
+    for(size_t j = grid.size(); j-- > 0;)
+    {
+        assert(x != grid[j]);
+        next = (next - row[j]) / (x - grid[j]);
+        row[j] = next;
+    }
+    grid.push_back(x);
+    row.push_back(y);
+    coefficient.push_back(next);
+}
+
+template <typename T>
+void NewtonInterpolator<T>::remove_oldest()
+{
+    assert(!grid.empty());
+
+    // f[x_1 .. x_{k+1}] = f[x_0 .. x_k] + (x_{k+1} - x_0) f[x_0 .. x_{k+1}]
+    for(size_t k = 0; k + 1 < grid.size(); ++k)
+        coefficient[k] += (grid[k + 1] - grid[0]) * coefficient[k + 1];
+    coefficient.pop_back();
+    grid.erase(grid.begin());
+    row.erase(row.begin());
+}
+
+template <typename T>
+T NewtonInterpolator<T>::eval(T x) const
+{
+    const size_t n = grid.size();
+    if(n == 0)
+        return 0;
+
+    T p = coefficient[n - 1];
+    for(size_t k = n - 1; k-- > 0;)
+        p = p * (x - grid[k]) + coefficient[k];
+    return p;
+}
+
+template <typename T>
+Polynomial<T> NewtonInterpolator<T>::polynomial() const
+{
+    const size_t n = grid.size();
+    if(n == 0)
+        return Polynomial<T>(std::vector<T>(1, T(0)));
+
+    // nested multiplication on the coefficient vector, p = p (x - x_k) + c_k
+    std::vector<T> p(n, T(0));
+    p[0] = coefficient[n - 1];
+    for(size_t k = n - 1; k-- > 0;)
+    {
+        const size_t m = n - 1 - k;
+        for(size_t i = m; i > 0; --i)
+            p[i] = p[i - 1] - grid[k] * p[i];
+        p[0] = coefficient[k] - grid[k] * p[0];
+    }
+    return Polynomial<T>(p);
+}
+
+template class NewtonInterpolator<double>;
+template class NewtonInterpolator<float>;
@@ -4,7 +4,9 @@
  * @file lagrange.cpp
  * Copyright (c) 2020 Peter Grajcar
  */
+#include <algorithm>
 #include "numericalc/interpolation/lagrange.hpp"
+#include "numericalc/interpolation/basis_cache.hpp"
 
 /*
  * Divides polynomial such that p(x) = (x - x0)q(x) using long division algorithm.
@@ -13,7 +15,8 @@
 template <typename T>
 Polynomial<T> long_division(const Polynomial<T> &p, T x0)
 {
-    Polynomial<T> q = p.derivative();
+    // synthetic division, the leading coefficients of q are those of p shifted by one
+    Polynomial<T> q(std::vector<T>(p.coefficients().begin() + 1, p.coefficients().end()));
 
     for(size_t i = 1; i < q.degree(); ++i)
     {
@@ -24,7 +27,7 @@ Polynomial<T> long_division(const Polynomial<T> &p, T x0)
 }
 
 template <typename T>
-std::vector<Polynomial<T>> lagrange_polynomials(const std::vector<T> &grid)
+static std::vector<Polynomial<T>> build_lagrange_polynomials(const std::vector<T> &grid)
 {
     size_t n = grid.size();
     assert(n > 0);
@@ -54,7 +57,7 @@ std::vector<Polynomial<T>> lagrange_polynomials(const std::vector<T> &grid)
 }
 
 template <typename T>
-Matrix<T> lagrange_polynomial_matrix(const std::vector<T> &grid)
+static Matrix<T> build_lagrange_polynomial_matrix(const std::vector<T> &grid)
 {
     size_t n = grid.size();
     assert(n > 0);
@@ -78,12 +81,36 @@ Matrix<T> lagrange_polynomial_matrix(const std::vector<T> &grid)
     std::vector<T> &matrix = result.elements();
     for(size_t i = 0; i < n; ++i) {
         Polynomial<T> li = long_division(w, grid[i]) / wd(grid[i]);
-        matrix.insert(matrix.begin() + i*n, li.coefficients().begin(), li.coefficients().end());
+        std::copy(li.coefficients().begin(), li.coefficients().end(), matrix.begin() + i*n);
     }
 
     return result;
 }
 
+template <typename T>
+std::shared_ptr<const std::vector<Polynomial<T>>> cached_lagrange_polynomials(const std::vector<T> &grid)
+{
+    return basis_cache<T, std::vector<Polynomial<T>>>().get(grid, [&grid]() { return build_lagrange_polynomials(grid); });
+}
+
+template <typename T>
+std::shared_ptr<const Matrix<T>> cached_lagrange_polynomial_matrix(const std::vector<T> &grid)
+{
+    return basis_cache<T, Matrix<T>>().get(grid, [&grid]() { return build_lagrange_polynomial_matrix(grid); });
+}
+
+template <typename T>
+std::vector<Polynomial<T>> lagrange_polynomials(const std::vector<T> &grid)
+{
+    return *cached_lagrange_polynomials(grid);
+}
+
+template <typename T>
+Matrix<T> lagrange_polynomial_matrix(const std::vector<T> &grid)
+{
+    return *cached_lagrange_polynomial_matrix(grid);
+}
+
 
 template std::vector<Polynomial<double>> lagrange_polynomials(const std::vector<double> &grid);
 template std::vector<Polynomial<float>> lagrange_polynomials(const std::vector<float> &grid);
@@ -93,3 +120,10 @@ template Matrix<double> lagrange_polynomial_matrix(const std::vector<double> &gr
 template Matrix<float> lagrange_polynomial_matrix(const std::vector<float> &grid);
 template Matrix<int> lagrange_polynomial_matrix(const std::vector<int> &grid);
 
+template std::shared_ptr<const std::vector<Polynomial<double>>> cached_lagrange_polynomials(const std::vector<double> &grid);
+template std::shared_ptr<const std::vector<Polynomial<float>>> cached_lagrange_polynomials(const std::vector<float> &grid);
+template std::shared_ptr<const std::vector<Polynomial<int>>> cached_lagrange_polynomials(const std::vector<int> &grid);
+
+template std::shared_ptr<const Matrix<double>> cached_lagrange_polynomial_matrix(const std::vector<double> &grid);
+template std::shared_ptr<const Matrix<float>> cached_lagrange_polynomial_matrix(const std::vector<float> &grid);
+template std::shared_ptr<const Matrix<int>> cached_lagrange_polynomial_matrix(const std::vector<int> &grid);
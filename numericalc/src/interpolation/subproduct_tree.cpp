@@ -0,0 +1,173 @@
+/**
+ *
+ *
+ * @file subproduct_tree.cpp
+ * Copyright (c) 2020 Peter Grajcar
+ */
+#include <cassert>
+#include <algorithm>
+#include "numericalc/interpolation/subproduct_tree.hpp"
+#include "numericalc/Modular.hpp"
+#include "numericalc/parallel/thread_pool.hpp"
+
+template <typename T>
+static std::vector<T> mult(const std::vector<T> &a, const std::vector<T> &b)
+{
+    if(a.empty() || b.empty()) return std::vector<T>();
+    Polynomial<T> r = Polynomial<T>(a) * Polynomial<T>(b);
+    return std::vector<T>(r.coefficients().begin(), r.coefficients().begin() + a.size() + b.size() - 1);
+}
+
+template <typename T>
+static std::vector<T> reduce(const PolyDivisor<T> &d, const std::vector<T> &a)
+{
+    return d.remainder(Polynomial<T>(a)).coefficients();
+}
+
+template <typename T>
+SubproductTree<T>::SubproductTree(const std::vector<T> &grid) : points(grid)
+{
+    const size_t n = grid.size();
+    assert(n > 0);
+
+    std::vector<std::vector<T>> leaves(n);
+    for(size_t i = 0; i < n; ++i)
+        leaves[i] = {-points[i], T(1)};
+    levels.push_back(std::move(leaves));
+
+    for(size_t j = 0; levels.back().size() > 1; ++j)
+    {
+        const std::vector<std::vector<T>> &prev = levels.back();
+        std::vector<std::vector<T>> next((prev.size() + 1) / 2);
+        parallel_for(0, next.size(), std::max<size_t>(1, 64 >> std::min<size_t>(j, 6)), [&](size_t lo, size_t hi) {
+            for(size_t i = lo; i < hi; ++i)
+            {
+                if(2 * i + 1 == prev.size()) {
+                    next[i] = prev[2 * i];
+                    continue;
+                }
+                next[i] = mult(prev[2 * i], prev[2 * i + 1]);
+                next[i].back() = 1;
+            }
+        });
+        levels.push_back(std::move(next));
+    }
+
+    // nodes covering at most 2^5 points are evaluated directly
+    bottom = std::min<size_t>(levels.size() - 1, 5);
+
+    divisors.resize(levels.size());
+    for(size_t j = bottom; j + 1 < levels.size(); ++j)
+    {
+        const std::vector<std::vector<T>> &level = levels[j];
+        // dividends are remainders modulo the parent
+        for(size_t i = 0; i < level.size(); ++i)
+            divisors[j].push_back(PolyDivisor<T>(Polynomial<T>(level[i]), levels[j + 1][i / 2].size() - 1));
+    }
+}
+
+template <typename T>
+Polynomial<T> SubproductTree<T>::root() const
+{
+    return Polynomial<T>(levels.back()[0]);
+}
+
+template <typename T>
+std::vector<std::vector<T>> SubproductTree<T>::remainders(const std::vector<T> &p) const
+{
+    const size_t top = levels.size() - 1;
+    std::vector<std::vector<T>> current(1, p);
+    if(top == bottom) return current;
+
+    if(p.size() >= levels[top][0].size())
+        current[0] = reduce(PolyDivisor<T>(root(), p.size()), p);
+
+    for(size_t j = top; j-- > bottom;)
+    {
+        const std::vector<std::vector<T>> &level = levels[j];
+        std::vector<std::vector<T>> next(level.size());
+        parallel_for(0, level.size(), 1, [&, j](size_t lo, size_t hi) {
+            for(size_t i = lo; i < hi; ++i)
+                next[i] = reduce(divisors[j][i], current[i / 2]);
+        });
+        current = std::move(next);
+    }
+
+    return current;
+}
+
+template <typename T>
+std::vector<T> SubproductTree<T>::evaluate(const Polynomial<T> &p) const
+{
+    const size_t n = points.size();
+    std::vector<std::vector<T>> rem = remainders(p.coefficients());
+    std::vector<T> values(n);
+
+    const size_t width = (size_t) 1 << bottom;
+    parallel_for(0, rem.size(), 16, [&](size_t lo, size_t hi) {
+        for(size_t i = lo; i < hi; ++i)
+        {
+            const size_t first = i * width, count = std::min(width, n - first);
+            Polynomial<T>(rem[i]).eval_many(points.data() + first, values.data() + first, count);
+        }
+    });
+
+    return values;
+}
+
+template <typename T>
+Polynomial<T> SubproductTree<T>::interpolate(const std::vector<T> &values) const
+{
+    const size_t n = points.size();
+    assert(values.size() == n);
+
+    // p = sum_i y_i / w'(x_i) * w(x) / (x - x_i)
+    std::vector<T> wd = evaluate(root().derivative());
+    std::vector<std::vector<T>> current(n);
+    for(size_t i = 0; i < n; ++i)
+        current[i] = {values[i] / wd[i]};
+
+    for(size_t j = 0; j + 1 < levels.size(); ++j)
+    {
+        const std::vector<std::vector<T>> &level = levels[j];
+        std::vector<std::vector<T>> next(levels[j + 1].size());
+        parallel_for(0, next.size(), std::max<size_t>(1, 64 >> std::min<size_t>(j, 6)), [&](size_t lo, size_t hi) {
+            for(size_t i = lo; i < hi; ++i)
+            {
+                if(2 * i + 1 == level.size()) {
+                    next[i] = current[2 * i];
+                    continue;
+                }
+                // combination of the children scaled by the subproduct of the sibling
+                std::vector<T> l = mult(current[2 * i], level[2 * i + 1]);
+                std::vector<T> r = mult(current[2 * i + 1], level[2 * i]);
+                l.resize(std::max(l.size(), r.size()));
+                for(size_t k = 0; k < r.size(); ++k)
+                    l[k] += r[k];
+                next[i] = std::move(l);
+            }
+        });
+        current = std::move(next);
+    }
+
+    current[0].resize(n);
+    return Polynomial<T>(current[0]);
+}
+
+template <typename T>
+std::vector<T> multipoint_eval(const Polynomial<T> &p, const std::vector<T> &points)
+{
+    return SubproductTree<T>(points).evaluate(p);
+}
+
+template <typename T>
+Polynomial<T> multipoint_interpolate(const std::vector<T> &grid, const std::vector<T> &values)
+{
+    return SubproductTree<T>(grid).interpolate(values);
+}
+
+template class SubproductTree<Modular<998244353u>>;
+
+template std::vector<Modular<998244353u>> multipoint_eval(const Polynomial<Modular<998244353u>> &p, const std::vector<Modular<998244353u>> &points);
+
+template Polynomial<Modular<998244353u>> multipoint_interpolate(const std::vector<Modular<998244353u>> &grid, const std::vector<Modular<998244353u>> &values);
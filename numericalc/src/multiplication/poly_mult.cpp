@@ -0,0 +1,299 @@
+/**
+ *
+ *
+ * @file poly_mult.cpp
+ * Copyright (c) 2020 Peter Grajcar
+ */
+#include <cassert>
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+#include "numericalc/multiplication/poly_mult.hpp"
+#include "numericalc/dft/fft.hpp"
+#include "numericalc/dft/ntt.hpp"
+
+PolyMultThresholds &poly_mult_thresholds()
+{
+    static PolyMultThresholds thresholds = {48, 256, 4096, 8192, 256};
+    return thresholds;
+}
+
+/*
+ * Integral coefficients are multiplied in the corresponding unsigned type so that
+ * intermediate overflow wraps instead of being undefined.
+ */
+template <typename T, typename = void>
+struct mult_word
+{
+    using type = T;
+};
+
+template <typename T>
+struct mult_word<T, typename std::enable_if<std::is_integral<T>::value>::type>
+{
+    using type = typename std::make_unsigned<T>::type;
+};
+
+/*
+ * r += a * b, r has m + n - 1 elements.
+ */
+template <typename U>
+static void schoolbook(const U *a, size_t m, const U *b, size_t n, U *r)
+{
+    for(size_t i = 0; i < m; ++i)
+    {
+        const U ai = a[i];
+        U *ri = r + i;
+        for(size_t j = 0; j < n; ++j)
+            ri[j] += ai * b[j];
+    }
+}
+
+/*
+ * r = a * b for operands of length n, r has 2n - 1 elements. Scratch has to hold 4n + 256 elements.
+ */
+template <typename U>
+static void karatsuba(const U *a, const U *b, size_t n, U *r, U *scratch, size_t threshold)
+{
+    if(n < threshold)
+    {
+        std::fill(r, r + 2 * n - 1, U(0));
+        schoolbook(a, n, b, n, r);
+        return;
+    }
+
+    // a = a_lo + x^h a_hi, the high half has t >= h elements
+    const size_t h = n / 2, t = n - h;
+    karatsuba(a, b, h, r, scratch, threshold);
+    r[2 * h - 1] = 0;
+    karatsuba(a + h, b + h, t, r + 2 * h, scratch, threshold);
+
+    U *sa = scratch, *sb = scratch + t, *z1 = scratch + 2 * t;
+    for(size_t i = 0; i < t; ++i)
+    {
+        sa[i] = a[h + i] + (i < h ? a[i] : U(0));
+        sb[i] = b[h + i] + (i < h ? b[i] : U(0));
+    }
+    karatsuba(sa, sb, t, z1, z1 + 2 * t - 1, threshold);
+
+    // (a_lo + a_hi)(b_lo + b_hi) - a_lo b_lo - a_hi b_hi
+    for(size_t i = 0; i < 2 * h - 1; ++i)
+        z1[i] -= r[i];
+    for(size_t i = 0; i < 2 * t - 1; ++i)
+        z1[i] -= r[2 * h + i];
+    for(size_t i = 0; i < 2 * t - 1; ++i)
+        r[h + i] += z1[i];
+}
+
+template <typename U>
+static void balanced(const U *a, const U *b, size_t n, U *r, const PolyMultThresholds &th, bool toom);
+
+/*
+ * r = a * b for operands of length n using Toom-3, r has 2n - 1 elements.
+ */
+template <typename U>
+static void toom3(const U *a, const U *b, size_t n, U *r, const PolyMultThresholds &th)
+{
+    // a = a_0 + x^k a_1 + x^2k a_2, a_2 has l <= k elements
+    const size_t k = (n + 2) / 3, l = n - 2 * k;
+    const size_t len = 2 * k - 1, len_inf = 2 * l - 1;
+
+    std::vector<U> eval(6 * k), prod(4 * len + len_inf);
+    U *a1 = eval.data(), *am1 = a1 + k, *am2 = am1 + k;
+    U *b1 = am2 + k, *bm1 = b1 + k, *bm2 = bm1 + k;
+
+    auto evaluate = [k, l](const U *x, U *p1, U *pm1, U *pm2) {
+        for(size_t i = 0; i < k; ++i)
+        {
+            const U x0 = x[i], x1 = x[k + i], x2 = i < l ? x[2 * k + i] : U(0);
+            const U s = x0 + x2;
+            p1[i] = s + x1;
+            pm1[i] = s - x1;
+            pm2[i] = x0 - 2 * x1 + 4 * x2;
+        }
+    };
+    evaluate(a, a1, am1, am2);
+    evaluate(b, b1, bm1, bm2);
+
+    U *r0 = prod.data(), *r1 = r0 + len, *rm1 = r1 + len, *rm2 = rm1 + len, *rinf = rm2 + len;
+    balanced(a, b, k, r0, th, true);
+    balanced(a1, b1, k, r1, th, true);
+    balanced(am1, bm1, k, rm1, th, true);
+    balanced(am2, bm2, k, rm2, th, true);
+    balanced(a + 2 * k, b + 2 * k, l, rinf, th, true);
+
+    // Bodrato's interpolation sequence, coefficients past 2n - 1 are zero
+    const size_t size = 2 * n - 1;
+    std::fill(r, r + size, U(0));
+    for(size_t i = 0; i < len; ++i)
+    {
+        const U v0 = r0[i], v1 = r1[i], vm1 = rm1[i], vm2 = rm2[i];
+        const U vinf = i < len_inf ? rinf[i] : U(0);
+
+        U c3 = (vm2 - v1) / 3;
+        U c1 = (v1 - vm1) / 2;
+        U c2 = vm1 - v0;
+        c3 = (c2 - c3) / 2 + 2 * vinf;
+        c2 = c2 + c1 - vinf;
+        c1 = c1 - c3;
+
+        r[i] += v0;
+        if(k + i < size) r[k + i] += c1;
+        if(2 * k + i < size) r[2 * k + i] += c2;
+        if(3 * k + i < size) r[3 * k + i] += c3;
+        if(4 * k + i < size) r[4 * k + i] += vinf;
+    }
+}
+
+template <typename U>
+static void balanced(const U *a, const U *b, size_t n, U *r, const PolyMultThresholds &th, bool toom)
+{
+    if(toom && n >= std::max<size_t>(th.toom3, 5))
+    {
+        toom3(a, b, n, r, th);
+        return;
+    }
+    std::vector<U> scratch(4 * n + 256);
+    karatsuba(a, b, n, r, scratch.data(), std::max<size_t>(th.karatsuba, 2));
+}
+
+/*
+ * r += a * b, r has m + n - 1 elements. The longer operand is cut into pieces of the length of
+ * the shorter one, each piece is multiplied by a balanced algorithm.
+ */
+template <typename U>
+static void mult_general(const U *a, size_t m, const U *b, size_t n, U *r, const PolyMultThresholds &th,
+                         bool toom)
+{
+    if(m < n)
+    {
+        std::swap(a, b);
+        std::swap(m, n);
+    }
+    if(n < th.karatsuba)
+    {
+        schoolbook(a, m, b, n, r);
+        return;
+    }
+
+    std::vector<U> tmp(2 * n - 1);
+    for(size_t off = 0; off < m; off += n)
+    {
+        const size_t k = std::min(n, m - off);
+        if(k < n)
+        {
+            mult_general(b, n, a + off, k, r + off, th, toom);
+            continue;
+        }
+        balanced(a + off, b, n, tmp.data(), th, toom);
+        for(size_t i = 0; i < 2 * n - 1; ++i)
+            r[off + i] += tmp[i];
+    }
+}
+
+template <typename T>
+static Polynomial<T> mult_words(const Polynomial<T> &p, const Polynomial<T> &q, const PolyMultThresholds &th,
+                                bool toom)
+{
+    using U = typename mult_word<T>::type;
+
+    Polynomial<T> r(p.degree() + q.degree());
+    if(!p.degree() || !q.degree()) return r;
+
+    mult_general(reinterpret_cast<const U *>(p.coefficients().data()), p.degree(),
+                 reinterpret_cast<const U *>(q.coefficients().data()), q.degree(),
+                 reinterpret_cast<U *>(r.coefficients().data()), th, toom);
+    return r;
+}
+
+/*
+ * Transform based multiplication for large operands, returns false if there is none for the type.
+ */
+template <typename T>
+static typename std::enable_if<std::is_integral<T>::value, bool>::type
+transform_mult(const Polynomial<T> &p, const Polynomial<T> &q, Polynomial<T> &r)
+{
+    // products beyond the length or coefficient range of the NTT primes use Karatsuba
+    if(std::min(p.degree(), q.degree()) < poly_mult_thresholds().ntt || !ntt_supported(p, q))
+        return false;
+    r = ntt_mult(p, q);
+    return true;
+}
+
+template <uint32_t P>
+static bool transform_mult(const Polynomial<Modular<P>> &p, const Polynomial<Modular<P>> &q, Polynomial<Modular<P>> &r)
+{
+    if(std::min(p.degree(), q.degree()) < poly_mult_thresholds().ntt_modular || !ntt_supported(p, q))
+        return false;
+    r = ntt_mult(p, q);
+    return true;
+}
+
+static bool transform_mult(const Polynomial<double> &p, const Polynomial<double> &q, Polynomial<double> &r)
+{
+    if(std::min(p.degree(), q.degree()) < poly_mult_thresholds().fft)
+        return false;
+    Polynomial<double> f = fft_mult(p, q);
+    for(size_t i = 0; i < r.degree(); ++i)
+        r[i] = f[i];
+    return true;
+}
+
+static bool transform_mult(const Polynomial<float> &, const Polynomial<float> &, Polynomial<float> &)
+{
+    return false;
+}
+
+template <typename T>
+Polynomial<T> schoolbook_mult(const Polynomial<T> &p, const Polynomial<T> &q)
+{
+    PolyMultThresholds th = poly_mult_thresholds();
+    th.karatsuba = (size_t) -1;
+    return mult_words(p, q, th, false);
+}
+
+template <typename T>
+Polynomial<T> karatsuba_mult(const Polynomial<T> &p, const Polynomial<T> &q)
+{
+    return mult_words(p, q, poly_mult_thresholds(), false);
+}
+
+template <typename T>
+Polynomial<T> toom3_mult(const Polynomial<T> &p, const Polynomial<T> &q)
+{
+    static_assert(std::is_floating_point<T>::value, "Toom-3 requires floating point coefficients");
+    return mult_words(p, q, poly_mult_thresholds(), true);
+}
+
+template <typename T>
+Polynomial<T> poly_mult(const Polynomial<T> &p, const Polynomial<T> &q)
+{
+    Polynomial<T> r(p.degree() + q.degree());
+    if(!p.degree() || !q.degree()) return r;
+    if(transform_mult(p, q, r)) return r;
+    return mult_words(p, q, poly_mult_thresholds(), std::is_floating_point<T>::value);
+}
+
+template Polynomial<double> schoolbook_mult(const Polynomial<double> &p, const Polynomial<double> &q);
+template Polynomial<float> schoolbook_mult(const Polynomial<float> &p, const Polynomial<float> &q);
+template Polynomial<int> schoolbook_mult(const Polynomial<int> &p, const Polynomial<int> &q);
+template Polynomial<long> schoolbook_mult(const Polynomial<long> &p, const Polynomial<long> &q);
+template Polynomial<long long> schoolbook_mult(const Polynomial<long long> &p, const Polynomial<long long> &q);
+template Polynomial<Modular<998244353u>> schoolbook_mult(const Polynomial<Modular<998244353u>> &p, const Polynomial<Modular<998244353u>> &q);
+
+template Polynomial<double> karatsuba_mult(const Polynomial<double> &p, const Polynomial<double> &q);
+template Polynomial<float> karatsuba_mult(const Polynomial<float> &p, const Polynomial<float> &q);
+template Polynomial<int> karatsuba_mult(const Polynomial<int> &p, const Polynomial<int> &q);
+template Polynomial<long> karatsuba_mult(const Polynomial<long> &p, const Polynomial<long> &q);
+template Polynomial<long long> karatsuba_mult(const Polynomial<long long> &p, const Polynomial<long long> &q);
+template Polynomial<Modular<998244353u>> karatsuba_mult(const Polynomial<Modular<998244353u>> &p, const Polynomial<Modular<998244353u>> &q);
+
+template Polynomial<double> toom3_mult(const Polynomial<double> &p, const Polynomial<double> &q);
+template Polynomial<float> toom3_mult(const Polynomial<float> &p, const Polynomial<float> &q);
+
+template Polynomial<double> poly_mult(const Polynomial<double> &p, const Polynomial<double> &q);
+template Polynomial<float> poly_mult(const Polynomial<float> &p, const Polynomial<float> &q);
+template Polynomial<int> poly_mult(const Polynomial<int> &p, const Polynomial<int> &q);
+template Polynomial<long> poly_mult(const Polynomial<long> &p, const Polynomial<long> &q);
+template Polynomial<long long> poly_mult(const Polynomial<long long> &p, const Polynomial<long long> &q);
+template Polynomial<Modular<998244353u>> poly_mult(const Polynomial<Modular<998244353u>> &p, const Polynomial<Modular<998244353u>> &q);
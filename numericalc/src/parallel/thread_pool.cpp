@@ -0,0 +1,57 @@
+/**
+ *
+ *
+ * @file thread_pool.cpp
+ * Copyright (c) 2020 Peter Grajcar
+ */
+#include "numericalc/parallel/thread_pool.hpp"
+
+ThreadPool::ThreadPool(size_t threads) : stop(false)
+{
+    workers.reserve(threads);
+    for(size_t i = 0; i < threads; ++i)
+        workers.emplace_back(&ThreadPool::worker_loop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    cv.notify_all();
+    for(auto &w : workers)
+        w.join();
+}
+
+ThreadPool &ThreadPool::instance()
+{
+    static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+    return pool;
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push(std::move(task));
+    }
+    cv.notify_one();
+}
+
+void ThreadPool::worker_loop()
+{
+    for(;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            while(!stop && tasks.empty())
+                cv.wait(lock);
+            if(stop && tasks.empty())
+                return;
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+        task();
+    }
+}
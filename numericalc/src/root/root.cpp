@@ -4,3 +4,200 @@
  * @file root.cpp
  * Copyright (c) 2020 Peter Grajcar
  */
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include "numericalc/root/newton.hpp"
+#include "numericalc/parallel/thread_pool.hpp"
+
+/*
+ * Approximations evaluated together, the lanes of the vectorised Horner's schema.
+ */
+static const size_t root_lanes = 8;
+
+/*
+ * Initial approximations on circles given by the Newton polygon of coefficients a_0 .. a_m,
+ * a_0 and a_m are non-zero.
+ */
+template <typename T>
+static void initial_approximations(const std::vector<T> &a, T *re, T *im)
+{
+    const size_t m = a.size() - 1;
+    std::vector<size_t> hull;
+    for(size_t i = 0; i <= m; ++i)
+    {
+        if(a[i] == T(0)) continue;
+        const T y = std::log(std::abs(a[i]));
+        // pop vertices that lie below the segment from the previous vertex to (i, y)
+        while(hull.size() >= 2)
+        {
+            const size_t u = hull[hull.size() - 2], v = hull.back();
+            const T yu = std::log(std::abs(a[u])), yv = std::log(std::abs(a[v]));
+            if((yv - yu) * (T) (i - u) > (y - yu) * (T) (v - u)) break;
+            hull.pop_back();
+        }
+        hull.push_back(i);
+    }
+
+    const T two_pi = 2 * std::acos(T(-1)), sigma = T(0.7);
+    for(size_t h = 0; h + 1 < hull.size(); ++h)
+    {
+        const size_t k = hull[h], l = hull[h + 1], count = l - k;
+        const T radius = std::pow(std::abs(a[k] / a[l]), T(1) / (T) count);
+        for(size_t j = 0; j < count; ++j)
+        {
+            const T angle = two_pi * ((T) j / (T) count + (T) k / (T) m) + sigma;
+            re[k + j] = radius * std::cos(angle);
+            im[k + j] = radius * std::sin(angle);
+        }
+    }
+}
+
+/*
+ * Computes Newton corrections p(z) / p'(z) of approximations idx[0 .. count) which all lie inside
+ * or all outside the unit circle. Outside approximations are evaluated at w = 1 / z on the
+ * reversed coefficients q, then p(z) / p'(z) = z q(w) / (m q(w) - w q'(w)).
+ */
+template <typename T>
+static void corrections(const std::vector<T> &coef, bool reversed, const size_t *idx, size_t count,
+                        const T *re, const T *im, T *cre, T *cim, char *converged)
+{
+    const size_t m = coef.size() - 1;
+    const T eps = std::numeric_limits<T>::epsilon();
+    for(size_t j = 0; j < count; j += root_lanes)
+    {
+        const size_t w = std::min(root_lanes, count - j);
+        T xr[root_lanes] = {}, xi[root_lanes] = {}, xa[root_lanes] = {};
+        for(size_t l = 0; l < w; ++l)
+        {
+            const size_t k = idx[j + l];
+            xr[l] = re[k];
+            xi[l] = im[k];
+            if(reversed)
+            {
+                const T n = re[k] * re[k] + im[k] * im[k];
+                xr[l] /= n;
+                xi[l] = -xi[l] / n;
+            }
+            xa[l] = std::sqrt(xr[l] * xr[l] + xi[l] * xi[l]);
+        }
+
+        // b = b x + c, d = d x + b and the running error bound e = e |x| + |b|
+        T br[root_lanes] = {}, bi[root_lanes] = {}, dr[root_lanes] = {}, di[root_lanes] = {}, e[root_lanes] = {};
+        for(size_t i = 0; i <= m; ++i)
+        {
+            const T c = reversed ? coef[i] : coef[m - i];
+            for(size_t l = 0; l < root_lanes; ++l)
+            {
+                const T tr = dr[l] * xr[l] - di[l] * xi[l] + br[l];
+                const T ti = dr[l] * xi[l] + di[l] * xr[l] + bi[l];
+                dr[l] = tr;
+                di[l] = ti;
+                const T ur = br[l] * xr[l] - bi[l] * xi[l] + c;
+                const T ui = br[l] * xi[l] + bi[l] * xr[l];
+                br[l] = ur;
+                bi[l] = ui;
+                e[l] = e[l] * xa[l] + std::abs(ur) + std::abs(ui);
+            }
+        }
+
+        for(size_t l = 0; l < w; ++l)
+        {
+            const size_t k = idx[j + l];
+            const std::complex<T> b(br[l], bi[l]), d(dr[l], di[l]);
+            converged[k] = std::abs(b) <= 4 * eps * e[l];
+            std::complex<T> n;
+            if(reversed)
+                n = std::complex<T>(re[k], im[k]) * b / ((T) m * b - std::complex<T>(xr[l], xi[l]) * d);
+            else
+                n = b / d;
+            if(!std::isfinite(n.real()) || !std::isfinite(n.imag()))
+                n = 0;
+            cre[k] = n.real();
+            cim[k] = n.imag();
+        }
+    }
+}
+
+template <typename T>
+std::vector<std::complex<T>> aberth_roots(const Polynomial<T> &p, size_t max_iterations)
+{
+    const std::vector<T> &c = p.coefficients();
+    size_t last = c.size();
+    while(last && c[last - 1] == T(0))
+        --last;
+    size_t zeros = 0;
+    while(zeros < last && c[zeros] == T(0))
+        ++zeros;
+
+    std::vector<std::complex<T>> roots(zeros);
+    if(last <= zeros + 1) return roots;
+
+    const std::vector<T> a(c.begin() + zeros, c.begin() + last);
+    const size_t m = a.size() - 1;
+    std::vector<T> re(m), im(m), next_re(m), next_im(m), cre(m), cim(m);
+    std::vector<char> converged(m, 0);
+    initial_approximations(a, re.data(), im.data());
+
+    std::vector<size_t> active(m), inside, outside;
+    for(size_t k = 0; k < m; ++k)
+        active[k] = k;
+
+    for(size_t it = 0; it < max_iterations && !active.empty(); ++it)
+    {
+        inside.clear();
+        outside.clear();
+        for(size_t k : active)
+            (re[k] * re[k] + im[k] * im[k] <= 1 ? inside : outside).push_back(k);
+
+        parallel_for(0, inside.size(), 2 * root_lanes, [&](size_t lo, size_t hi) {
+            corrections(a, false, inside.data() + lo, hi - lo, re.data(), im.data(), cre.data(), cim.data(), converged.data());
+        });
+        parallel_for(0, outside.size(), 2 * root_lanes, [&](size_t lo, size_t hi) {
+            corrections(a, true, outside.data() + lo, hi - lo, re.data(), im.data(), cre.data(), cim.data(), converged.data());
+        });
+
+        // Aberth step, s = sum_j 1 / (z_k - z_j) over all approximations including converged ones
+        parallel_for(0, active.size(), 16, [&](size_t lo, size_t hi) {
+            for(size_t t = lo; t < hi; ++t)
+            {
+                const size_t k = active[t];
+                next_re[k] = re[k];
+                next_im[k] = im[k];
+                if(converged[k]) continue;
+
+                T sr = 0, si = 0;
+                const T zr = re[k], zi = im[k];
+                for(size_t j = 0; j < m; ++j)
+                {
+                    const T xr = zr - re[j], xi = zi - im[j];
+                    const T inv = j == k ? T(0) : T(1) / (xr * xr + xi * xi);
+                    sr += xr * inv;
+                    si -= xi * inv;
+                }
+
+                const std::complex<T> n(cre[k], cim[k]), s(sr, si);
+                const std::complex<T> w = n / (T(1) - n * s);
+                if(std::isfinite(w.real()) && std::isfinite(w.imag()))
+                {
+                    next_re[k] -= w.real();
+                    next_im[k] -= w.imag();
+                }
+            }
+        });
+
+        for(size_t k : active)
+        {
+            re[k] = next_re[k];
+            im[k] = next_im[k];
+        }
+        active.erase(std::remove_if(active.begin(), active.end(), [&converged](size_t k) { return converged[k]; }), active.end());
+    }
+
+    for(size_t k = 0; k < m; ++k)
+        roots.push_back(std::complex<T>(re[k], im[k]));
+    return roots;
+}
+
+template std::vector<std::complex<double>> aberth_roots(const Polynomial<double> &p, size_t max_iterations);
+template std::vector<std::complex<float>> aberth_roots(const Polynomial<float> &p, size_t max_iterations);